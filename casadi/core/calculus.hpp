@@ -207,10 +207,13 @@ namespace casadi {
 
     OP_LOGSUMEXP,
 
-    OP_REMAINDER
+    OP_REMAINDER,
+
+    // Fused elementwise operations
+    OP_FUSED
 
   };
-  #define NUM_BUILT_IN_OPS (OP_REMAINDER+1)
+  #define NUM_BUILT_IN_OPS (OP_FUSED+1)
 
   #define OP_
 
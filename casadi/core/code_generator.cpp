@@ -55,6 +55,7 @@ namespace casadi {
     bool prefix_set = false;
     this->prefix = "";
     avoid_stack_ = false;
+    this->split = 1;
     indent_ = 2;
 
     // Read options
@@ -100,6 +101,9 @@ namespace casadi {
         casadi_assert_dev(indent_>=0);
       } else if (e.first=="avoid_stack") {
         avoid_stack_ = e.second;
+      } else if (e.first=="split") {
+        this->split = e.second;
+        casadi_assert(this->split>=1, "Option 'split' must be positive");
       } else if (e.first=="prefix") {
         this->prefix = e.second.to_string();
         prefix_set = true;
@@ -225,7 +229,8 @@ namespace casadi {
     for (auto&& e : added_functions_) if (e.f==f) return e.codegen_name;
 
     // Give it a name
-    std::string fname = shorthand("f" + str(added_functions_.size()));
+    std::string fsym = "f" + str(added_functions_.size());
+    std::string fname = shorthand(fsym);
 
     // Add to list of functions
     added_functions_.push_back({f, fname});
@@ -298,6 +303,17 @@ namespace casadi {
     // Flush to body
     flush(this->body);
 
+    // Make callable from other translation units
+    if (this->split>1) {
+      unit_symbols_.insert(fsym);
+      unit_declarations_.push_back(f->signature(fname));
+      if (f->has_refcount_) {
+        unit_declarations_.push_back("void " + fname + "_incref(void)");
+        unit_declarations_.push_back("void " + fname + "_decref(void)");
+      }
+    }
+    body_marks_.push_back(this->body.tellp());
+
     return fname;
   }
 
@@ -445,22 +461,29 @@ namespace casadi {
        "The signature of CodeGenerator::generate has changed. "
        "Instead of providing the filename, only provide the prefix.");
 
-    // Create c file
     std::ofstream s;
     std::string fullname = prefix + this->name + this->suffix;
-    file_open(s, fullname, this->cpp);
+    units_.clear();
+    if (this->split>1 && can_split()) {
+      // Distribute over several files
+      generate_units(prefix);
+    } else {
+      // Create c file
+      file_open(s, fullname, this->cpp);
 
-    // Dump code to file
-    dump(s);
+      // Dump code to file
+      dump(s);
 
-    // Mex entry point
-    if (this->mex) generate_mex(s);
+      // Mex entry point
+      if (this->mex) generate_mex(s);
 
-    // Main entry point
-    if (this->main) generate_main(s);
+      // Main entry point
+      if (this->main) generate_main(s);
 
-    // Finalize file
-    file_close(s, this->cpp);
+      // Finalize file
+      file_close(s, this->cpp);
+      units_.push_back(fullname);
+    }
 
     // Generate s-function
     if (this->with_sfunction) {
@@ -494,6 +517,65 @@ namespace casadi {
     return fullname;
   }
 
+  bool CodeGenerator::can_split() const {
+    // Memory objects and file scope work are shared state
+    if (needs_mem_ || this->with_mem) return false;
+    if (!file_scope_double_.empty() || !file_scope_integer_.empty()) return false;
+    // Entry points refer to the exposed functions
+    if (this->mex || this->main || this->with_sfunction) return false;
+    return true;
+  }
+
+  void CodeGenerator::generate_units(const std::string& prefix) {
+    // Cut the body between complete definitions
+    std::string b = this->body.str();
+    std::vector<std::pair<size_t, size_t> > chunks;
+    size_t begin = 0;
+    for (std::streamoff m : body_marks_) {
+      size_t end = static_cast<size_t>(m);
+      if (end>begin) chunks.emplace_back(begin, end);
+      begin = std::max(begin, end);
+    }
+    if (b.size()>begin) chunks.emplace_back(begin, b.size());
+
+    // Assign the largest chunks first, each to the currently smallest unit
+    casadi_int n_units = std::max(std::min(this->split, casadi_int(chunks.size())),
+                                  casadi_int(1));
+    std::vector<casadi_int> order(chunks.size());
+    for (casadi_int i=0; i<order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](casadi_int i, casadi_int j) {
+      return chunks[i].second - chunks[i].first > chunks[j].second - chunks[j].first;});
+    std::vector<size_t> unit_size(n_units, 0);
+    std::vector<casadi_int> unit_of(chunks.size());
+    for (casadi_int i : order) {
+      casadi_int u = std::min_element(unit_size.begin(), unit_size.end()) - unit_size.begin();
+      unit_of[i] = u;
+      unit_size[u] += chunks[i].second - chunks[i].first;
+    }
+
+    // Shared header, included from the directory of the units
+    std::ofstream s;
+    std::string hname = this->name + "_shared.h";
+    file_open(s, prefix + hname, this->cpp);
+    dump_shared(s, true);
+    file_close(s, this->cpp);
+
+    // Translation units, the first one is the main file
+    for (casadi_int u=0; u<n_units; ++u) {
+      std::string fullname = prefix + this->name + (u==0 ? "" : "_" + str(u)) + this->suffix;
+      file_open(s, fullname, this->cpp);
+      s << "/* Internal symbols specific to this translation unit */\n"
+        << "#define CASADI_UNIT_PREFIX(ID) CASADI_PREFIX(u" << u << "_ ## ID)\n"
+        << "#include \"" << hname << "\"\n\n";
+      for (casadi_int i=0; i<chunks.size(); ++i) {
+        if (unit_of[i]==u) s << b.substr(chunks[i].first, chunks[i].second - chunks[i].first);
+      }
+      s << std::endl;
+      file_close(s, this->cpp);
+      units_.push_back(fullname);
+    }
+  }
+
   void CodeGenerator::generate_mex(std::ostream &s) const {
     // Begin conditional compilation
     s << "#ifdef MATLAB_MEX_FILE\n";
@@ -784,6 +866,17 @@ namespace casadi {
   }
 
   void CodeGenerator::dump(std::ostream& s) {
+    // Everything but the body
+    dump_shared(s, false);
+
+    // Codegen body
+    s << this->body.str();
+
+    // End with new line
+    s << std::endl;
+  }
+
+  void CodeGenerator::dump_shared(std::ostream& s, bool split) {
     // Consistency check
     casadi_assert_dev(current_indent_ == 0);
 
@@ -823,7 +916,10 @@ namespace casadi {
     if (!added_shorthands_.empty()) {
       s << "/* Add prefix to internal symbols */\n";
       for (auto&& i : added_shorthands_) {
-        s << "#define " << "casadi_" << i <<  " CASADI_PREFIX(" << i <<  ")\n";
+        // If split, only functions are shared between translation units
+        bool unit = split && unit_symbols_.count(i)==0;
+        s << "#define " << "casadi_" << i <<  (unit ? " CASADI_UNIT_PREFIX(" : " CASADI_PREFIX(")
+          << i <<  ")\n";
       }
       s << std::endl;
     }
@@ -900,11 +996,12 @@ namespace casadi {
       s << std::endl << std::endl;
     }
 
-    // Codegen body
-    s << this->body.str();
-
-    // End with new line
-    s << std::endl;
+    // Functions defined in any of the translation units
+    if (split && !unit_declarations_.empty()) {
+      s << "/* Functions shared between translation units */\n";
+      for (auto&& d : unit_declarations_) s << d << ";\n";
+      s << std::endl;
+    }
   }
 
   std::string CodeGenerator::work(casadi_int n, casadi_int sz) const {
@@ -1449,6 +1546,23 @@ namespace casadi {
 
       this->auxiliaries << sanitize_source(casadi_qrqp_str, inst);
       break;
+    case AUX_IPQP:
+      add_auxiliary(AUX_COPY);
+      add_auxiliary(AUX_FILL);
+      add_auxiliary(AUX_CLEAR);
+      add_auxiliary(AUX_AXPY);
+      add_auxiliary(AUX_FMIN);
+      add_auxiliary(AUX_FMAX);
+      add_auxiliary(AUX_INF);
+      add_auxiliary(AUX_REAL_MIN);
+      add_include("stdio.h");
+      add_include("math.h");
+      this->auxiliaries << sanitize_source(casadi_ipqp_str, inst);
+      break;
+    case AUX_RICCATI:
+      add_include("math.h");
+      this->auxiliaries << sanitize_source(casadi_riccati_str, inst);
+      break;
     case AUX_NLP:
       add_auxiliary(AUX_ORACLE);
       this->auxiliaries << sanitize_source(casadi_nlp_str, inst);
@@ -1473,6 +1587,7 @@ namespace casadi {
       add_auxiliary(AUX_AXPY);
       add_auxiliary(AUX_NORM_INF);
       add_auxiliary(AUX_QR);
+      add_auxiliary(AUX_INF);
       this->auxiliaries << sanitize_source(casadi_newton_str, inst);
       break;
     case AUX_MAX_VIOL:
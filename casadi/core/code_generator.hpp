@@ -65,6 +65,12 @@ namespace casadi {
         \identifier{rv} */
     std::string generate(const std::string& prefix="");
 
+    /** \brief Source files written by the last call to generate
+
+      More than one if the code was split into several translation units,
+      cf. the "split" option. The first entry is the file returned by generate. */
+    std::vector<std::string> units() const { return units_;}
+
     /// Add an include file optionally using a relative path "..." instead of an absolute path <...>
     void add_include(const std::string& new_include, bool relative_path=false,
                     const std::string& use_ifdef=std::string());
@@ -592,6 +598,8 @@ namespace casadi {
       AUX_QR,
       AUX_QP,
       AUX_QRQP,
+      AUX_IPQP,
+      AUX_RICCATI,
       AUX_NLP,
       AUX_SQPMETHOD,
       AUX_FEASIBLESQPMETHOD,
@@ -874,6 +882,9 @@ namespace casadi {
     // Do we want to be lean on stack usage?
     bool avoid_stack_;
 
+    // Number of translation units to distribute the generated functions over
+    casadi_int split;
+
     std::string infinity, nan, real_min;
 
     /** \brief Codegen scalar
@@ -948,6 +959,27 @@ namespace casadi {
     // Does any function need thread-local memory?
     bool needs_mem_;
 
+    // Positions in body between complete definitions
+    std::vector<std::streamoff> body_marks_;
+
+    // Shorthands of functions referred to across translation units
+    std::set<std::string> unit_symbols_;
+
+    // Declarations of functions referred to across translation units
+    std::vector<std::string> unit_declarations_;
+
+    // Files written by generate
+    std::vector<std::string> units_;
+
+    // Can the body be split over several translation units
+    bool can_split() const;
+
+    // Generate everything but the body, for the shared header if split
+    void dump_shared(std::ostream& s, bool split);
+
+    // Generate split code
+    void generate_units(const std::string& prefix);
+
     // Hash a vector
     static size_t hash(const std::vector<double>& v);
     static size_t hash(const std::vector<casadi_int>& v);
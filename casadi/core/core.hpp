@@ -33,6 +33,7 @@
 #include "polynomial.hpp"
 #include "casadi_misc.hpp"
 #include "global_options.hpp"
+#include "node_arena.hpp"
 #include "casadi_meta.hpp"
 
 // Matrices
@@ -30,6 +30,8 @@
 #include "switch.hpp"
 #include "bspline.hpp"
 #include "nlpsol.hpp"
+#include "map.hpp"
+#include "jit_cache.hpp"
 #include "mapsum.hpp"
 #include "conic.hpp"
 #include "jit_function.hpp"
@@ -680,6 +682,11 @@ namespace casadi {
     // No need for logic when we are not saturating the limit
     if (n<=max_num_threads) return map(n, parallelization);
 
+    // The thread pool bounds the number of threads natively
+    if (parallelization=="thread") {
+      return Map::create(parallelization, *this, n, {{"max_num_threads", max_num_threads}});
+    }
+
     // Floored division
     casadi_int d = n/max_num_threads;
     if (d*max_num_threads==n) {
@@ -1330,6 +1337,12 @@ namespace casadi {
     }
   }
 
+  Dict Function::jit_cache_stats(const std::string& directory) {
+    std::string dir = directory.empty() ? JitCache::default_directory() : directory;
+    casadi_assert(!dir.empty(), "No jit cache directory given and CASADI_JIT_CACHE not set");
+    return JitCache(dir, 0).stats();
+  }
+
   Function Function::deserialize(const std::string& s) {
     std::stringstream ss;
     ss << s;
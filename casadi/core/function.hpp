@@ -636,7 +636,7 @@ namespace casadi {
 
     /** \brief  Evaluate symbolically in parallel and sum (matrix graph)
 
-        \param parallelization Type of parallelization used: unroll|serial|openmp
+        \param parallelization Type of parallelization used: unroll|serial|openmp|thread|simd
 
         \identifier{1wh} */
     std::vector<MX> mapsum(const std::vector<MX > &x,
@@ -720,7 +720,7 @@ namespace casadi {
                 s_(N-1) <- f(a_(N-1), p_(N-1))
         \endverbatim
 
-        \param parallelization Type of parallelization used: unroll|serial|openmp
+        \param parallelization Type of parallelization used: unroll|serial|openmp|thread|simd
 
         \identifier{1wj} */
     Function map(casadi_int n, const std::string& parallelization="serial") const;
@@ -894,6 +894,10 @@ namespace casadi {
 
     /** \brief Save Function to a file
 
+        Set the option "binary" to write raw bytes instead of text, with numeric
+        vectors (sparsity patterns, constants, DM data) stored as aligned blocks.
+        Binary files are several times smaller and faster to load.
+
         \see load
 
         \identifier{240} */
@@ -1180,6 +1184,14 @@ namespace casadi {
         \identifier{1y1} */
     static Function load(const std::string& filename);
 
+    /** \brief Statistics of a persistent just-in-time compilation cache
+
+     * Number of entries and total size of the cache directory, together with the
+     * hits, misses, waits for other processes, stores and evictions of the current
+     * process. An empty directory refers to the environment variable CASADI_JIT_CACHE.
+     */
+    static Dict jit_cache_stats(const std::string& directory="");
+
     /** \brief Build function from serialization
 
         \identifier{1y2} */
@@ -42,6 +42,7 @@
 #include "integrator_impl.hpp"
 #include "external_impl.hpp"
 #include "fmu_function.hpp"
+#include "jit_cache.hpp"
 
 #include <cctype>
 #include <typeinfo>
@@ -79,6 +80,8 @@ namespace casadi {
     never_inline_ = false;
     jac_penalty_ = 2;
     max_num_dir_ = GlobalOptions::getMaxNumDir();
+    ad_num_threads_ = 1;
+    coloring_num_threads_ = 1;
     user_data_ = nullptr;
     inputs_check_ = true;
     jit_ = false;
@@ -86,6 +89,9 @@ namespace casadi {
     jit_serialize_ = "source";
     jit_base_name_ = "jit_tmp";
     jit_temp_suffix_ = true;
+    jit_split_ = 1;
+    jit_cache_ = JitCache::default_directory();
+    jit_cache_size_ = 1LL << 30;
     compiler_plugin_ = CASADI_STR(CASADI_DEFAULT_COMPILER_PLUGIN);
 
     eval_ = nullptr;
@@ -126,6 +132,9 @@ namespace casadi {
       std::string jit_directory = get_from_dict(jit_options_, "directory", std::string(""));
       std::string jit_name = jit_directory + jit_name_ + ".c";
       if (remove(jit_name.c_str())) casadi_warning("Failed to remove " + jit_name);
+      for (const std::string& f : jit_files_) {
+        if (remove(f.c_str())) casadi_warning("Failed to remove " + f);
+      }
     }
   }
 
@@ -246,6 +255,20 @@ namespace casadi {
         "This is desired for thread-safety. "
         "This behaviour may defeat caching compiler wrappers. "
         "Default: true"}},
+      {"jit_split",
+       {OT_INT,
+        "Distribute the generated code over this many translation units, which compiler "
+        "plugins supporting it (shell, clang) compile concurrently. Default: 1"}},
+      {"jit_cache",
+       {OT_STRING,
+        "Directory of a persistent cache of jit compiled libraries, which may be shared "
+        "between processes. Libraries are looked up by a hash of the generated source, "
+        "the compiler plugin and options, and the CasADi version. "
+        "Default: environment variable CASADI_JIT_CACHE, if set, otherwise no caching"}},
+      {"jit_cache_size",
+       {OT_INT,
+        "Bound on the size of the jit cache in bytes, least recently used libraries "
+        "are removed first. Nonpositive for no bound. Default: 1 GiB"}},
       {"compiler",
        {OT_STRING,
         "Just-in-time compiler plugin to be used."}},
@@ -261,6 +284,20 @@ namespace casadi {
        {OT_INT,
         "Specify the maximum number of directions for derivative functions."
         " Overrules the builtin optimized_num_dir."}},
+      {"ad_num_threads",
+       {OT_INT,
+        "Number of threads evaluating batches of directional derivatives "
+        "(of up to max_num_dir directions each) concurrently, e.g. the seed groups "
+        "of a Jacobian calculated with graph coloring. Default: 1 (sequential)"}},
+      {"coloring_ordering",
+       {OT_STRING,
+        "Vertex ordering for the graph coloring of Jacobian and Hessian sparsity "
+        "patterns: 'natural', 'largest_first', 'smallest_last' or 'incidence_degree'. "
+        "Default: largest first for Hessians, natural for Jacobians"}},
+      {"coloring_num_threads",
+       {OT_INT,
+        "Number of threads for speculative parallel graph coloring of Jacobian and "
+        "Hessian sparsity patterns. Default: 1 (sequential)"}},
       {"enable_forward",
        {OT_BOOL,
         "Enable derivative calculation using generated functions for"
@@ -386,11 +423,17 @@ namespace casadi {
     opts["jit_options"] = jit_options_;
     opts["jit_name"] = jit_base_name_;
     opts["jit_temp_suffix"] = jit_temp_suffix_;
+    opts["jit_split"] = jit_split_;
+    opts["jit_cache"] = jit_cache_;
+    opts["jit_cache_size"] = jit_cache_size_;
     opts["ad_weight"] = ad_weight_;
     opts["ad_weight_sp"] = ad_weight_sp_;
     opts["always_inline"] = always_inline_;
     opts["never_inline"] = never_inline_;
     opts["max_num_dir"] = max_num_dir_;
+    opts["ad_num_threads"] = ad_num_threads_;
+    opts["coloring_ordering"] = coloring_ordering_;
+    opts["coloring_num_threads"] = coloring_num_threads_;
     if (target=="clone" || target=="tmp") {
       opts["enable_forward"] = enable_forward_op_;
       opts["enable_reverse"] = enable_reverse_op_;
@@ -478,6 +521,12 @@ namespace casadi {
         jit_base_name_ = op.second.to_string();
       } else if (op.first=="jit_temp_suffix") {
         jit_temp_suffix_ = op.second;
+      } else if (op.first=="jit_split") {
+        jit_split_ = op.second;
+      } else if (op.first=="jit_cache") {
+        jit_cache_ = op.second.to_string();
+      } else if (op.first=="jit_cache_size") {
+        jit_cache_size_ = op.second;
       } else if (op.first=="derivative_of") {
         derivative_of_ = op.second;
       } else if (op.first=="ad_weight") {
@@ -486,6 +535,16 @@ namespace casadi {
         ad_weight_sp_ = op.second;
       } else if (op.first=="max_num_dir") {
         max_num_dir_ = op.second;
+      } else if (op.first=="ad_num_threads") {
+        ad_num_threads_ = op.second;
+        casadi_assert(ad_num_threads_>=1, "Option 'ad_num_threads' must be positive");
+      } else if (op.first=="coloring_ordering") {
+        coloring_ordering_ = op.second.to_string();
+        coloring_ordering(coloring_ordering_, 0);
+      } else if (op.first=="coloring_num_threads") {
+        coloring_num_threads_ = op.second;
+        casadi_assert(coloring_num_threads_>=1,
+          "Option 'coloring_num_threads' must be positive");
       } else if (op.first=="enable_forward") {
         enable_forward_op_ = op.second;
       } else if (op.first=="enable_reverse") {
@@ -692,11 +751,13 @@ namespace casadi {
           Dict opts;
           // Override the default to avoid random strings in the generated code
           opts["prefix"] = "jit";
+          if (jit_split_>1) opts["split"] = jit_split_;
           CodeGenerator gen(jit_name_, opts);
           gen.add(self());
           if (verbose_) casadi_message("Compiling function '" + name_ + "'..");
           std::string jit_directory = get_from_dict(jit_options_, "directory", std::string(""));
-          compiler_ = Importer(gen.generate(jit_directory), compiler_plugin_, jit_options_);
+          gen.generate(jit_directory);
+          compiler_ = jit_compile(gen.units());
           if (verbose_) casadi_message("Compiling function '" + name_ + "' done.");
         }
         // Try to load
@@ -717,6 +778,61 @@ namespace casadi {
     if (dump_) dump();
   }
 
+  Importer FunctionInternal::jit_compile(const std::vector<std::string>& units) {
+    casadi_assert_dev(!units.empty());
+    const std::string& src = units.front();
+
+    // Other translation units are compiled alongside the main file
+    Dict opts = jit_options_;
+    jit_files_.clear();
+    if (units.size()>1) {
+      std::vector<std::string> sources(units.begin()+1, units.end());
+      opts["sources"] = sources;
+      jit_files_ = sources;
+      jit_files_.push_back(src.substr(0, src.rfind('.')) + "_shared.h");
+    }
+    if (jit_cache_.empty()) return Importer(src, compiler_plugin_, opts);
+
+    // Options that do not affect the compiled library
+    Dict config = jit_options_;
+    for (const char* op : {"directory", "name", "temp_suffix", "cleanup", "verbose"}) {
+      config.erase(op);
+    }
+
+    // Hash the generated code, disregarding the (temporary) file names
+    std::stringstream source;
+    for (const std::string& f : units) {
+      std::ifstream file(f);
+      casadi_assert(file.good(), "Cannot open '" + f + "'");
+      source << file.rdbuf();
+    }
+    if (units.size()>1) {
+      std::ifstream file(jit_files_.back());
+      casadi_assert(file.good(), "Cannot open '" + jit_files_.back() + "'");
+      source << file.rdbuf();
+    }
+    std::string code = replace(source.str(), jit_name_, "jit");
+    std::string key = JitCache::key(code, compiler_plugin_ + ":" + str(config));
+
+    // Compile only if not already in the cache
+    JitCache cache(jit_cache_, jit_cache_size_);
+    Importer compiled;
+    std::string lib = cache.get(key, [&]() -> std::string {
+      if (verbose_) casadi_message("Cache miss for '" + name_ + "', compiling.");
+      compiled = Importer(src, compiler_plugin_, opts);
+      try {
+        return compiled.library();
+      } catch (std::exception&) {
+        casadi_warning("Compiler plugin '" + compiler_plugin_ + "' does not produce "
+          "a library, jit_cache ignored.");
+        return "";
+      }
+    });
+    if (lib.empty()) return compiled;
+    if (verbose_) casadi_message("Loading '" + lib + "' from the jit cache.");
+    return Importer(lib, "dll");
+  }
+
   void ProtoFunction::finalize() {
     // Create memory object
     int mem = checkout();
@@ -1036,6 +1152,8 @@ namespace casadi {
       my_opts["ad_weight_sp"] = sp_weight();
     if (my_opts.find("max_num_dir")==my_opts.end())
       my_opts["max_num_dir"] = max_num_dir_;
+    if (my_opts.find("ad_num_threads")==my_opts.end())
+      my_opts["ad_num_threads"] = ad_num_threads_;
     // Wrap the function
     std::vector<MX> arg = mx_in();
     std::vector<MX> res = self()(arg);
@@ -1052,6 +1170,7 @@ namespace casadi {
       opts["ad_weight"] = ad_weight();
       opts["ad_weight_sp"] = sp_weight();
       opts["max_num_dir"] = max_num_dir_;
+      opts["ad_num_threads"] = ad_num_threads_;
       opts["is_diff_in"] = is_diff_in_;
       opts["is_diff_out"] = is_diff_out_;
       // Wrap the function
@@ -1916,6 +2035,27 @@ namespace casadi {
     return jsp;
   }
 
+  casadi_int FunctionInternal::coloring_ordering(const std::string& ordering,
+      casadi_int def) {
+    if (ordering.empty()) return def;
+    if (ordering=="natural") return 0;
+    if (ordering=="largest_first") return 1;
+    if (ordering=="smallest_last") return 2;
+    if (ordering=="incidence_degree") return 3;
+    casadi_error("Unknown coloring ordering '" + ordering + "'. Valid options: "
+                 "'natural', 'largest_first', 'smallest_last', 'incidence_degree'");
+  }
+
+  Sparsity FunctionInternal::uni_coloring(const Sparsity& A, const Sparsity& AT,
+      casadi_int cutoff) const {
+    if (coloring_ordering_.empty() && coloring_num_threads_==1) {
+      return A.uni_coloring(AT, cutoff);
+    } else {
+      return A.uni_coloring(AT, cutoff, coloring_ordering(coloring_ordering_, 0),
+                            coloring_num_threads_);
+    }
+  }
+
   void FunctionInternal::get_partition(casadi_int iind, casadi_int oind, Sparsity& D1, Sparsity& D2,
                                        bool compact, bool symmetric,
                                        bool allow_forward, bool allow_reverse) const {
@@ -1933,7 +2073,12 @@ namespace casadi {
 
       // Star coloring if symmetric
       if (verbose_) casadi_message("FunctionInternal::getPartition star_coloring");
-      D1 = A.star_coloring();
+      if (coloring_ordering_.empty() && coloring_num_threads_==1) {
+        D1 = A.star_coloring();
+      } else {
+        D1 = A.star_coloring(coloring_ordering(coloring_ordering_, 1),
+                             std::numeric_limits<casadi_int>::max(), coloring_num_threads_);
+      }
       if (verbose_) {
         casadi_message("Star coloring completed: " + str(D1.size2())
           + " directional derivatives needed ("
@@ -1973,7 +2118,7 @@ namespace casadi {
           bool d = best_coloring>=w*static_cast<double>(A.size1());
           casadi_int max_colorings_to_test =
             d ? A.size1() : static_cast<casadi_int>(floor(best_coloring/w));
-          D1 = AT.uni_coloring(A, max_colorings_to_test);
+          D1 = uni_coloring(AT, A, max_colorings_to_test);
           if (D1.is_null()) {
             if (verbose_) {
               casadi_message("Forward mode coloring interrupted (more than "
@@ -1994,7 +2139,7 @@ namespace casadi {
           casadi_int max_colorings_to_test =
             d ? A.size2() : static_cast<casadi_int>(floor(best_coloring/(1-w)));
 
-          D2 = A.uni_coloring(AT, max_colorings_to_test);
+          D2 = uni_coloring(A, AT, max_colorings_to_test);
           if (D2.is_null()) {
             if (verbose_) {
               casadi_message("Adjoint mode coloring interrupted (more than "
@@ -2290,7 +2435,9 @@ namespace casadi {
   void FunctionInternal::codegen(CodeGenerator& g, const std::string& fname) const {
     // Define function
     g << "/* " << definition() << " */\n";
-    g << "static " << signature(fname) << " {\n";
+    // External linkage if the code may be split over several translation units
+    if (g.split<=1) g << "static ";
+    g << signature(fname) << " {\n";
 
     // Reset local variables, flush buffer
     g.flush(g.body);
@@ -2974,6 +3121,18 @@ namespace casadi {
         while (!has_forward(max_nfwd)) max_nfwd/=2;
       }
       casadi_int offset = 0;
+      // Full batches evaluated concurrently
+      casadi_int nbatch = nfwd/max_nfwd;
+      if (ad_num_threads_>1 && nbatch>1) {
+        offset = nbatch*max_nfwd;
+        std::vector<MX> x = call_batches(self().forward(max_nfwd), max_nfwd, nbatch, arg, res, fseed);
+        for (casadi_int d=0; d<offset; ++d) fsens[d].resize(n_out_);
+        for (casadi_int i=0; i<n_out_; ++i) {
+          std::vector<MX> v = horzsplit(x[i], size2_out(i));
+          casadi_assert_dev(v.size()==offset);
+          for (casadi_int d=0; d<offset; ++d) fsens[d][i] = v[d];
+        }
+      }
       while (offset<nfwd) {
         // Number of derivatives, in this batch
         casadi_int nfwd_batch = std::min(nfwd-offset, max_nfwd);
@@ -3084,6 +3243,24 @@ namespace casadi {
 
       while (!has_reverse(max_nadj)) max_nadj/=2;
       casadi_int offset = 0;
+      // Full batches evaluated concurrently
+      casadi_int nbatch = nadj/max_nadj;
+      if (ad_num_threads_>1 && nbatch>1) {
+        offset = nbatch*max_nadj;
+        std::vector<MX> x = call_batches(self().reverse(max_nadj), max_nadj, nbatch, arg, res, aseed);
+        for (casadi_int d=0; d<offset; ++d) asens[d].resize(n_in_);
+        for (casadi_int i=0; i<n_in_; ++i) {
+          std::vector<MX> v = horzsplit(x[i], size2_in(i));
+          casadi_assert_dev(v.size()==offset);
+          for (casadi_int d=0; d<offset; ++d) {
+            if (asens[d][i].is_empty(true)) {
+              asens[d][i] = v[d];
+            } else {
+              asens[d][i] += v[d];
+            }
+          }
+        }
+      }
       while (offset<nadj) {
         // Number of derivatives, in this batch
         casadi_int nadj_batch =  std::min(nadj-offset, max_nadj);
@@ -3127,6 +3304,26 @@ namespace casadi {
     }
   }
 
+  std::vector<MX> FunctionInternal::
+  call_batches(const Function& dfcn, casadi_int ndir_batch, casadi_int nbatch,
+               const std::vector<MX>& arg, const std::vector<MX>& res,
+               const std::vector<std::vector<MX> >& seed) const {
+    // Nondifferentiated inputs and outputs, repeated for each batch
+    std::vector<MX> darg;
+    darg.reserve(dfcn.n_in());
+    for (auto&& a : arg) darg.push_back(repmat(a, 1, nbatch));
+    for (auto&& r : res) darg.push_back(repmat(r, 1, nbatch));
+    // Seeds, the directions of all batches side by side
+    casadi_int nseed = dfcn.n_in() - darg.size(), ndir = nbatch*ndir_batch;
+    std::vector<MX> v(ndir);
+    for (casadi_int i=0; i<nseed; ++i) {
+      for (casadi_int d=0; d<ndir; ++d) v[d] = seed[d][i];
+      darg.push_back(horzcat(v));
+    }
+    // Evaluate the batches on the thread pool, with a memory object per thread
+    return dfcn.map(nbatch, "thread", ad_num_threads_)(darg);
+  }
+
   void FunctionInternal::
   call_forward(const std::vector<SX>& arg, const std::vector<SX>& res,
              const std::vector<std::vector<SX> >& fseed,
@@ -3851,7 +4048,7 @@ namespace casadi {
 
   void FunctionInternal::serialize_body(SerializingStream& s) const {
     ProtoFunction::serialize_body(s);
-    s.version("FunctionInternal", 6);
+    s.version("FunctionInternal", 10);
     s.pack("FunctionInternal::is_diff_in", is_diff_in_);
     s.pack("FunctionInternal::is_diff_out", is_diff_out_);
     s.pack("FunctionInternal::sp_in", sparsity_in_);
@@ -3873,6 +4070,9 @@ namespace casadi {
     s.pack("FunctionInternal::jit_temp_suffix", jit_temp_suffix_);
     s.pack("FunctionInternal::jit_base_name", jit_base_name_);
     s.pack("FunctionInternal::jit_options", jit_options_);
+    s.pack("FunctionInternal::jit_cache", jit_cache_);
+    s.pack("FunctionInternal::jit_cache_size", jit_cache_size_);
+    s.pack("FunctionInternal::jit_split", jit_split_);
     s.pack("FunctionInternal::compiler_plugin", compiler_plugin_);
     s.pack("FunctionInternal::has_refcount", has_refcount_);
 
@@ -3897,6 +4097,9 @@ namespace casadi {
     s.pack("FunctionInternal::never_inline", never_inline_);
 
     s.pack("FunctionInternal::max_num_dir", max_num_dir_);
+    s.pack("FunctionInternal::ad_num_threads", ad_num_threads_);
+    s.pack("FunctionInternal::coloring_ordering", coloring_ordering_);
+    s.pack("FunctionInternal::coloring_num_threads", coloring_num_threads_);
 
     s.pack("FunctionInternal::inputs_check", inputs_check_);
 
@@ -3927,7 +4130,7 @@ namespace casadi {
   }
 
   FunctionInternal::FunctionInternal(DeserializingStream& s) : ProtoFunction(s) {
-    int version = s.version("FunctionInternal", 1, 6);
+    int version = s.version("FunctionInternal", 1, 10);
     s.unpack("FunctionInternal::is_diff_in", is_diff_in_);
     s.unpack("FunctionInternal::is_diff_out", is_diff_out_);
     s.unpack("FunctionInternal::sp_in", sparsity_in_);
@@ -3962,6 +4165,18 @@ namespace casadi {
     s.unpack("FunctionInternal::jit_temp_suffix", jit_temp_suffix_);
     s.unpack("FunctionInternal::jit_base_name", jit_base_name_);
     s.unpack("FunctionInternal::jit_options", jit_options_);
+    if (version >= 7) {
+      s.unpack("FunctionInternal::jit_cache", jit_cache_);
+      s.unpack("FunctionInternal::jit_cache_size", jit_cache_size_);
+    } else {
+      jit_cache_ = JitCache::default_directory();
+      jit_cache_size_ = 1LL << 30;
+    }
+    if (version >= 8) {
+      s.unpack("FunctionInternal::jit_split", jit_split_);
+    } else {
+      jit_split_ = 1;
+    }
     s.unpack("FunctionInternal::compiler_plugin", compiler_plugin_);
     s.unpack("FunctionInternal::has_refcount", has_refcount_);
 
@@ -3988,6 +4203,17 @@ namespace casadi {
     s.unpack("FunctionInternal::never_inline", never_inline_);
 
     s.unpack("FunctionInternal::max_num_dir", max_num_dir_);
+    if (version >= 9) {
+      s.unpack("FunctionInternal::ad_num_threads", ad_num_threads_);
+    } else {
+      ad_num_threads_ = 1;
+    }
+    if (version >= 10) {
+      s.unpack("FunctionInternal::coloring_ordering", coloring_ordering_);
+      s.unpack("FunctionInternal::coloring_num_threads", coloring_num_threads_);
+    } else {
+      coloring_num_threads_ = 1;
+    }
 
     if (version < 3) s.unpack("FunctionInternal::regularity_check", regularity_check_);
 
@@ -567,6 +567,13 @@ namespace casadi {
                             const std::vector<std::vector<SX> >& aseed,
                             std::vector<std::vector<SX> >& asens,
                             bool always_inline, bool never_inline) const;
+
+    /** \brief Call a derivative function for several batches of directions concurrently
+
+        The first nbatch*ndir_batch seeds are used, ndir_batch at a time */
+    std::vector<MX> call_batches(const Function& dfcn, casadi_int ndir_batch, casadi_int nbatch,
+                                 const std::vector<MX>& arg, const std::vector<MX>& res,
+                                 const std::vector<std::vector<MX> >& seed) const;
     ///@}
 
     /** \brief Parallel evaluation
@@ -920,6 +927,12 @@ namespace casadi {
         \identifier{mc} */
     virtual std::vector<std::string> get_free() const;
 
+    /// Ordering code for graph coloring from its name
+    static casadi_int coloring_ordering(const std::string& ordering, casadi_int def);
+
+    /// Unidirectional coloring with the coloring options
+    Sparsity uni_coloring(const Sparsity& A, const Sparsity& AT, casadi_int cutoff) const;
+
     /** \brief Get the unidirectional or bidirectional partition
 
         \identifier{md} */
@@ -1252,6 +1265,18 @@ namespace casadi {
         \identifier{nj} */
     bool jit_temp_suffix_;
 
+    /// Number of translation units for the jit generated code
+    casadi_int jit_split_;
+
+    /// Generated files besides the main jit source file
+    std::vector<std::string> jit_files_;
+
+    /// Directory of the persistent jit cache, empty if disabled
+    std::string jit_cache_;
+
+    /// Bound on the size of the jit cache in bytes
+    casadi_int jit_cache_size_;
+
     /** \brief Numerical evaluation redirected to a C function
 
         \identifier{nk} */
@@ -1299,6 +1324,9 @@ namespace casadi {
     Importer compiler_;
     Dict jit_options_;
 
+    /// Compile generated source files, going through the jit cache if enabled
+    Importer jit_compile(const std::vector<std::string>& units);
+
     /// Penalty factor for using a complete Jacobian to calculate directional derivatives
     double jac_penalty_;
 
@@ -1312,6 +1340,15 @@ namespace casadi {
     /// Maximum number of sensitivity directions
     casadi_int max_num_dir_;
 
+    /// Number of threads evaluating batches of sensitivity directions
+    casadi_int ad_num_threads_;
+
+    /// Vertex ordering for graph coloring, empty for the default
+    std::string coloring_ordering_;
+
+    /// Number of threads for graph coloring
+    casadi_int coloring_num_threads_;
+
     /// Errors are thrown if numerical values of inputs look bad
     bool inputs_check_;
 
@@ -0,0 +1,324 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "fused_elementwise.hpp"
+#include "casadi_misc.hpp"
+#include "serializing_stream.hpp"
+
+namespace casadi {
+
+  FusedElementwise::FusedElementwise(const std::vector<MX>& x, const Sparsity& sp,
+      const std::vector<casadi_int>& op, const std::vector<casadi_int>& arg)
+      : op_(op), arg_(arg) {
+    casadi_assert_dev(!op_.empty() && arg_.size()==2*op_.size());
+    set_dep(x);
+    set_sparsity(sp);
+    init_slots();
+  }
+
+  void FusedElementwise::init_slots() {
+    casadi_int nd = n_dep(), nop = n_op();
+    scalar_dep_.resize(nd);
+    for (casadi_int i=0; i<nd; ++i) scalar_dep_[i] = dep(i).nnz()!=nnz();
+    // Last operation using each result
+    std::vector<casadi_int> last(nop, -1);
+    for (casadi_int k=0; k<nop; ++k) {
+      for (casadi_int c=0; c<2; ++c) {
+        if (arg_[2*k+c]>=nd) last[arg_[2*k+c]-nd] = k;
+      }
+    }
+    // Reuse the slots of results no longer needed, operations being elementwise
+    std::vector<casadi_int> unused;
+    slot_.resize(nop);
+    n_slot_ = 0;
+    for (casadi_int k=0; k<nop; ++k) {
+      for (casadi_int c=0; c<2; ++c) {
+        casadi_int a = arg_[2*k+c] - nd;
+        if (a>=0 && last[a]==k && (c==0 || arg_[2*k]!=arg_[2*k+1])) {
+          unused.push_back(slot_[a]);
+        }
+      }
+      if (k+1==nop) {
+        slot_[k] = -1;
+      } else if (unused.empty()) {
+        slot_[k] = n_slot_++;
+      } else {
+        slot_[k] = unused.back();
+        unused.pop_back();
+      }
+    }
+  }
+
+  std::string FusedElementwise::disp(const std::vector<std::string>& arg) const {
+    std::vector<std::string> v(arg);
+    for (casadi_int k=0; k<n_op(); ++k) {
+      casadi_int a = arg_[2*k], b = arg_[2*k+1];
+      if (b<0) {
+        v.push_back(casadi_math<double>::print(op_[k], v.at(a)));
+      } else {
+        v.push_back(casadi_math<double>::print(op_[k], v.at(a), v.at(b)));
+      }
+    }
+    return v.back();
+  }
+
+  size_t FusedElementwise::sz_w() const {
+    return n_slot_*std::min(block_size, nnz());
+  }
+
+  int FusedElementwise::eval(const double** arg, double** res, casadi_int* iw, double* w) const {
+    return eval_gen<double>(arg, res, iw, w);
+  }
+
+  int FusedElementwise::eval_sx(const SXElem** arg, SXElem** res,
+      casadi_int* iw, SXElem* w) const {
+    return eval_gen<SXElem>(arg, res, iw, w);
+  }
+
+  template<typename T>
+  int FusedElementwise::eval_gen(const T** arg, T** res, casadi_int* iw, T* w) const {
+    casadi_int n = nnz(), nd = n_dep(), nop = n_op(), bs = std::min(block_size, n);
+    T dummy = 0;
+    // Evaluate block by block, keeping the intermediate results in cache
+    for (casadi_int i0=0; i0<n; i0+=bs) {
+      casadi_int len = std::min(bs, n-i0);
+      for (casadi_int k=0; k<nop; ++k) {
+        T* r = k+1==nop ? res[0]+i0 : w+slot_[k]*bs;
+        // Operands, scalar or for the elements of the block
+        const T* x[2];
+        bool sc[2];
+        for (casadi_int c=0; c<2; ++c) {
+          casadi_int a = arg_[2*k+c];
+          if (a<0) {
+            x[c] = &dummy;
+            sc[c] = true;
+          } else if (a<nd) {
+            sc[c] = is_scalar_dep(a);
+            x[c] = sc[c] ? arg[a] : arg[a]+i0;
+          } else {
+            x[c] = w+slot_[a-nd]*bs;
+            sc[c] = false;
+          }
+        }
+        if (sc[0] && !sc[1]) {
+          casadi_math<T>::fun(op_[k], *x[0], x[1], r, len);
+        } else if (sc[1]) {
+          casadi_math<T>::fun(op_[k], x[0], *x[1], r, len);
+        } else {
+          casadi_math<T>::fun(op_[k], x[0], x[1], r, len);
+        }
+      }
+    }
+    return 0;
+  }
+
+  void FusedElementwise::eval_mx(const std::vector<MX>& arg, std::vector<MX>& res) const {
+    std::vector<MX> v(arg);
+    MX dummy;
+    for (casadi_int k=0; k<n_op(); ++k) {
+      casadi_int a = arg_[2*k], b = arg_[2*k+1];
+      MX r;
+      casadi_math<MX>::fun(op_[k], v.at(a), b<0 ? dummy : v.at(b), r);
+      v.push_back(r);
+    }
+    res[0] = v.back();
+  }
+
+  void FusedElementwise::ad_forward(const std::vector<std::vector<MX> >& fseed,
+                                    std::vector<std::vector<MX> >& fsens) const {
+    casadi_int nop = n_op();
+    // Nondifferentiated intermediate results and partial derivatives
+    std::vector<MX> v = dep_, pd(2*nop);
+    MX dummy;
+    for (casadi_int k=0; k<nop; ++k) {
+      casadi_int a = arg_[2*k], b = arg_[2*k+1];
+      const MX& y = b<0 ? dummy : v[b];
+      MX r;
+      if (k+1==nop) {
+        r = shared_from_this<MX>();
+      } else {
+        casadi_math<MX>::fun(op_[k], v[a], y, r);
+      }
+      casadi_math<MX>::der(op_[k], v[a], y, r, get_ptr(pd)+2*k);
+      v.push_back(r);
+    }
+
+    // Propagate forward seeds
+    for (casadi_int d=0; d<fsens.size(); ++d) {
+      std::vector<MX> t = fseed[d];
+      for (casadi_int k=0; k<nop; ++k) {
+        casadi_int a = arg_[2*k], b = arg_[2*k+1];
+        if (b<0) {
+          t.push_back(pd[2*k]*t[a]);
+        } else if (op_[k]==OP_IF_ELSE_ZERO) {
+          t.push_back(if_else_zero(pd[2*k+1], t[b]));
+        } else {
+          t.push_back(pd[2*k]*t[a] + pd[2*k+1]*t[b]);
+        }
+      }
+      fsens[d][0] = t.back();
+    }
+  }
+
+  void FusedElementwise::ad_reverse(const std::vector<std::vector<MX> >& aseed,
+                                    std::vector<std::vector<MX> >& asens) const {
+    casadi_int nd = n_dep(), nop = n_op();
+    // Nondifferentiated intermediate results and partial derivatives
+    std::vector<MX> v = dep_, pd(2*nop);
+    MX dummy;
+    for (casadi_int k=0; k<nop; ++k) {
+      casadi_int a = arg_[2*k], b = arg_[2*k+1];
+      const MX& y = b<0 ? dummy : v[b];
+      MX r;
+      if (k+1==nop) {
+        r = shared_from_this<MX>();
+      } else {
+        casadi_math<MX>::fun(op_[k], v[a], y, r);
+      }
+      casadi_math<MX>::der(op_[k], v[a], y, r, get_ptr(pd)+2*k);
+      v.push_back(r);
+    }
+
+    // Propagate adjoint seeds
+    for (casadi_int d=0; d<aseed.size(); ++d) {
+      // Adjoint seeds of the intermediate results
+      std::vector<MX> s(nop, MX(sparsity()));
+      s.back() = aseed[d][0];
+      auto add = [&](casadi_int i, const MX& t) {
+        if (i<nd) {
+          asens[d][i] += t;
+        } else {
+          s[i-nd] += t;
+        }
+      };
+      for (casadi_int k=nop-1; k>=0; --k) {
+        casadi_int a = arg_[2*k], b = arg_[2*k+1];
+        const MX& sk = s[k];
+        if (op_[k]==OP_IF_ELSE_ZERO) {
+          // Special case to avoid NaN propagation
+          if (!sk.is_scalar() && v[b].is_scalar()) {
+            add(b, dot(v[a], sk));
+          } else {
+            add(b, if_else_zero(v[a], sk));
+          }
+          continue;
+        }
+        for (casadi_int c=0; c<(b<0 ? 1 : 2); ++c) {
+          casadi_int i = c==0 ? a : b;
+          MX& p = pd[2*k+c];
+          MX t = p*sk;
+          // If dimension mismatch (i.e. one argument is scalar), then sum all the entries
+          if (!t.is_scalar() && t.size() != v[i].size()) {
+            if (p.size()!=sk.size()) p = MX(sk.sparsity(), p);
+            t = dot(p, sk);
+          }
+          add(i, t);
+        }
+      }
+    }
+  }
+
+  int FusedElementwise::sp_forward(const bvec_t** arg, bvec_t** res,
+      casadi_int* iw, bvec_t* w) const {
+    casadi_int nd = n_dep();
+    for (casadi_int i=0; i<nnz(); ++i) {
+      bvec_t r = 0;
+      for (casadi_int j=0; j<nd; ++j) r |= arg[j][is_scalar_dep(j) ? 0 : i];
+      res[0][i] = r;
+    }
+    return 0;
+  }
+
+  int FusedElementwise::sp_reverse(bvec_t** arg, bvec_t** res,
+      casadi_int* iw, bvec_t* w) const {
+    casadi_int nd = n_dep();
+    for (casadi_int i=0; i<nnz(); ++i) {
+      bvec_t s = res[0][i];
+      res[0][i] = 0;
+      for (casadi_int j=0; j<nd; ++j) arg[j][is_scalar_dep(j) ? 0 : i] |= s;
+    }
+    return 0;
+  }
+
+  void FusedElementwise::generate(CodeGenerator& g,
+                                  const std::vector<casadi_int>& arg,
+                                  const std::vector<casadi_int>& res) const {
+    // Quick return if nothing to do
+    if (nnz()==0) return;
+    casadi_int nd = n_dep(), nop = n_op();
+    bool loop = nnz()>1;
+
+    // Operands, elements of a single loop without intermediate vectors
+    std::vector<std::string> v(nd);
+    for (casadi_int i=0; i<nd; ++i) {
+      if (loop && !is_scalar_dep(i)) {
+        v[i] = g.work(arg[i], nnz()) + "[i]";
+      } else {
+        v[i] = "(" + g.workel(arg[i]) + ")";
+      }
+    }
+    if (loop) {
+      g.local("i", "casadi_int");
+      g << "for (i=0; i<" << nnz() << "; ++i) ";
+    }
+    g << "{\n";
+    if (nop>1) {
+      g << "casadi_real ";
+      for (casadi_int k=0; k+1<nop; ++k) g << (k==0 ? "" : ", ") << "v" << k;
+      g << ";\n";
+    }
+    for (casadi_int k=0; k<nop; ++k) {
+      casadi_int a = arg_[2*k], b = arg_[2*k+1];
+      if (k+1==nop) {
+        g << (loop ? g.work(res[0], nnz()) + "[i]" : g.workel(res[0]));
+      } else {
+        g << "v" << k;
+      }
+      g << " = ";
+      if (b<0) {
+        g << g.print_op(op_[k], v.at(a));
+      } else {
+        g << g.print_op(op_[k], v.at(a), v.at(b));
+      }
+      g << ";\n";
+      v.push_back("v" + str(k));
+    }
+    g << "}\n";
+  }
+
+  void FusedElementwise::serialize_body(SerializingStream& s) const {
+    MXNode::serialize_body(s);
+    s.pack("FusedElementwise::op", op_);
+    s.pack("FusedElementwise::arg", arg_);
+  }
+
+  FusedElementwise::FusedElementwise(DeserializingStream& s) : MXNode(s) {
+    s.unpack("FusedElementwise::op", op_);
+    s.unpack("FusedElementwise::arg", arg_);
+    init_slots();
+  }
+
+} // namespace casadi
@@ -0,0 +1,140 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_FUSED_ELEMENTWISE_HPP
+#define CASADI_FUSED_ELEMENTWISE_HPP
+
+#include "mx_node.hpp"
+
+/// \cond INTERNAL
+
+namespace casadi {
+  /** \brief A chain of elementwise operations evaluated in a single sweep
+
+      Replaces a group of unary and binary operations with the same sparsity
+      pattern, whose intermediate results are not used elsewhere.
+      The dependencies have the sparsity pattern of the result or are scalars.
+      Operation k has the arguments arg_[2*k] and arg_[2*k+1], referring to a
+      dependency if less than n_dep(), else to the result of operation
+      arg-n_dep(). The last operation is the result.
+  */
+  class CASADI_EXPORT FusedElementwise : public MXNode {
+  public:
+
+    /// Constructor
+    FusedElementwise(const std::vector<MX>& x, const Sparsity& sp,
+                     const std::vector<casadi_int>& op, const std::vector<casadi_int>& arg);
+
+    /// Destructor
+    ~FusedElementwise() override {}
+
+    /// Number of elements evaluated together
+    static const casadi_int block_size = 1024;
+
+    /// Evaluate the function (template)
+    template<typename T>
+    int eval_gen(const T** arg, T** res, casadi_int* iw, T* w) const;
+
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w) const override;
+
+    /// Evaluate the function symbolically (SX)
+    int eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w) const override;
+
+    /** \brief  Evaluate symbolically (MX), restoring the individual operations */
+    void eval_mx(const std::vector<MX>& arg, std::vector<MX>& res) const override;
+
+    /** \brief Calculate forward mode directional derivatives */
+    void ad_forward(const std::vector<std::vector<MX> >& fseed,
+                         std::vector<std::vector<MX> >& fsens) const override;
+
+    /** \brief Calculate reverse mode directional derivatives */
+    void ad_reverse(const std::vector<std::vector<MX> >& aseed,
+                         std::vector<std::vector<MX> >& asens) const override;
+
+    /** \brief  Propagate sparsity forward */
+    int sp_forward(const bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w) const override;
+
+    /** \brief  Propagate sparsity backwards */
+    int sp_reverse(bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w) const override;
+
+    /** \brief Generate code for the operation */
+    void generate(CodeGenerator& g,
+                  const std::vector<casadi_int>& arg,
+                  const std::vector<casadi_int>& res) const override;
+
+    /// Can the operation be performed inplace (i.e. overwrite the result)
+    casadi_int n_inplace() const override { return n_dep();}
+
+    /// Get required length of w field
+    size_t sz_w() const override;
+
+    /** \brief  Print expression */
+    std::string disp(const std::vector<std::string>& arg) const override;
+
+    /** \brief Get the operation */
+    casadi_int op() const override { return OP_FUSED;}
+
+    /// Number of operations
+    casadi_int n_op() const { return op_.size();}
+
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream& s) const override;
+
+    /** \brief Deserialize without type information */
+    static MXNode* deserialize(DeserializingStream& s) { return new FusedElementwise(s); }
+
+  protected:
+    /** \brief Deserializing constructor */
+    explicit FusedElementwise(DeserializingStream& s);
+
+    /// Is a dependency a scalar broadcast to all elements
+    bool is_scalar_dep(casadi_int i) const { return scalar_dep_[i];}
+
+    /// Assign intermediate results to slots in the work vector
+    void init_slots();
+
+    /// Operations
+    std::vector<casadi_int> op_;
+
+    /// Arguments of the operations, -1 if unused
+    std::vector<casadi_int> arg_;
+
+    /// Scalar dependencies
+    std::vector<bool> scalar_dep_;
+
+    /// Slot in the work vector for the result of each operation but the last
+    std::vector<casadi_int> slot_;
+
+    /// Number of slots
+    casadi_int n_slot_;
+  };
+
+} // namespace casadi
+
+/// \endcond
+
+#endif // CASADI_FUSED_ELEMENTWISE_HPP
@@ -1594,6 +1594,8 @@ FixedStepIntegrator::FixedStepIntegrator(const std::string& name, const Function
 
   // Default options
   nk_target_ = 20;
+  batch_fwd_ = batch_adj_ = false;
+  nj_max_ = 0;
 }
 
 FixedStepIntegrator::~FixedStepIntegrator() {
@@ -1611,7 +1613,13 @@ const Options FixedStepIntegrator::options_
       "Implement as MX Function (codegeneratable/serializable) default: false"}},
     {"simplify_options",
       {OT_DICT,
-      "Any options to pass to simplified form Function constructor"}}
+      "Any options to pass to simplified form Function constructor"}},
+    {"step_parallelization",
+      {OT_STRING,
+      "Evaluate the step Jacobians of the forward sensitivity or adjoint sweep "
+      "in one batched call per output interval, once the trajectory is known, "
+      "with the given parallelization [serial|openmp|thread|simd]. "
+      "Default: step-by-step evaluation of the directional derivatives"}}
     }
 };
 
@@ -1691,6 +1699,8 @@ void FixedStepIntegrator::init(const Dict& opts) {
   for (auto&& op : opts) {
     if (op.first=="number_of_finite_elements") {
       nk_target_ = op.second;
+    } else if (op.first=="step_parallelization") {
+      step_parallelization_ = op.second.to_string();
     }
   }
 
@@ -1739,6 +1749,67 @@ void FixedStepIntegrator::init(const Dict& opts) {
     alloc_w((disc_.back() + 1) * nx_, true); // x_tape
     alloc_w(disc_.back() * nv_, true); // v_tape
   }
+
+  // Batched step Jacobians, explicit steps
+  if (has_function("step")) setup_jac_step();
+}
+
+void FixedStepIntegrator::setup_jac_step() {
+  // Batching only pays off for sensitivities of first order
+  batch_fwd_ = !step_parallelization_.empty() && nfwd_ > 0 && nadj_ == 0;
+  batch_adj_ = !step_parallelization_.empty() && nadj_ > 0 && nfwd_ == 0;
+  if (!batch_fwd_ && !batch_adj_) return;
+
+  // Jacobian of (xf, vf, qf) w.r.t. (x0, p, u), as forward derivatives at the nominal solution
+  Function F = get_function("step");
+  casadi_int nrow = nx1_ + nv1_ + nq1_, ncol = nx1_ + np1_ + nu1_;
+  std::vector<MX> arg = F.mx_in();
+  std::vector<std::string> arg_names = F.name_in();
+  for (casadi_int i = 0; i < STEP_NUM_OUT; ++i) {
+    arg.push_back(MX::sym("out_" + F.name_out(i), F.sparsity_out(i)));
+    arg_names.push_back("out_" + F.name_out(i));
+  }
+  std::vector<MX> fwd_arg = arg;
+  for (casadi_int i = 0; i < STEP_NUM_IN; ++i) {
+    fwd_arg.push_back(MX(F.size1_in(i), F.size2_in(i) * ncol));
+  }
+  MX seed = MX::eye(ncol);
+  fwd_arg[STEP_NUM_IN + STEP_NUM_OUT + STEP_X0] = seed(Slice(0, nx1_), Slice());
+  fwd_arg[STEP_NUM_IN + STEP_NUM_OUT + STEP_P] = seed(Slice(nx1_, nx1_ + np1_), Slice());
+  fwd_arg[STEP_NUM_IN + STEP_NUM_OUT + STEP_U] = seed(Slice(nx1_ + np1_, ncol), Slice());
+  std::vector<MX> fwd_res = F.forward(ncol)(fwd_arg);
+  Function J("jac_step", arg, {densify(vertcat(fwd_res))}, arg_names, {"jac"});
+  casadi_assert_dev(J.nnz_out(0) == nrow * ncol);
+
+  // Lockstep evaluation requires scalar expressions
+  if (step_parallelization_ == "simd") {
+    try {
+      J = J.expand();
+    } catch (std::exception& e) {
+      casadi_warning("Cannot expand step Jacobian, simd evaluation falls back to serial: "
+        + std::string(e.what()));
+    }
+  }
+
+  // Map over the steps of each output interval, with common h, p, u
+  nj_max_ = 0;
+  for (casadi_int k = 0; k < nt(); ++k) {
+    casadi_int nj = disc_[k + 1] - disc_[k];
+    nj_max_ = std::max(nj_max_, nj);
+    std::string fname = "jac_step_" + str(nj);
+    if (nj == 0 || has_function(fname)) continue;
+    set_function(J.map(fname, step_parallelization_, nj,
+      std::vector<casadi_int>{STEP_H, STEP_P, STEP_U}, std::vector<casadi_int>{}), fname, true);
+  }
+
+  // Work vectors
+  alloc_w(nj_max_, true); // t_batch
+  alloc_w(nj_max_ * nrow * ncol, true); // jac_batch
+  alloc_w(std::max(nrow, ncol), true); // jac_v
+  if (batch_fwd_) {
+    alloc_w((nj_max_ + 1) * nx1_, true); // x_batch
+    alloc_w(nj_max_ * nv1_, true); // v_batch
+  }
 }
 
 void FixedStepIntegrator::set_work(void* mem, const double**& arg, double**& res,
@@ -1777,6 +1848,17 @@ void FixedStepIntegrator::set_work(void* mem, const double**& arg, double**& res
     m->x_tape = w; w += (disc_.back() + 1) * nx_;
     m->v_tape = w; w += disc_.back() * nv_;
   }
+
+  // Batched step Jacobians
+  if (batch_fwd_ || batch_adj_) {
+    m->t_batch = w; w += nj_max_;
+    m->jac_batch = w; w += nj_max_ * (nx1_ + nv1_ + nq1_) * (nx1_ + np1_ + nu1_);
+    m->jac_v = w; w += std::max(nx1_ + nv1_ + nq1_, nx1_ + np1_ + nu1_);
+  }
+  if (batch_fwd_) {
+    m->x_batch = w; w += (nj_max_ + 1) * nx1_;
+    m->v_batch = w; w += nj_max_ * nv1_;
+  }
 }
 
 int FixedStepIntegrator::init_mem(void* mem) const {
@@ -1797,25 +1879,45 @@ void FixedStepIntegrator::advance(IntegratorMemory* mem,
   casadi_int nj = disc_[m->k + 1] - disc_[m->k];
   double h = (m->t_next - m->t) / nj;
 
-  // Take steps
-  for (casadi_int j = 0; j < nj; ++j) {
-    // Current time
-    double t = m->t + j * h;
-
-    // Update the previous step
-    casadi_copy(m->x, nx_, m->x_prev);
-    casadi_copy(m->v, nv_, m->v_prev);
-    casadi_copy(m->q, nq_, m->q_prev);
-
-    // Take step
-    stepF(m, t, h, m->x_prev, m->v_prev, m->x, m->v, m->q);
-    casadi_axpy(nq_, 1., m->q_prev, m->q);
-
-    // Save state, if needed
-    if (nrx_ > 0) {
-      casadi_int tapeind = disc_[m->k] + j;
-      casadi_copy(m->x, nx_, m->x_tape + nx_ * (tapeind + 1));
-      casadi_copy(m->v, nv_, m->v_tape + nv_ * tapeind);
+  if (batch_fwd_) {
+    // Nondifferentiated steps, taping the trajectory
+    casadi_copy(m->x, nx1_, m->x_batch);
+    for (casadi_int j = 0; j < nj; ++j) {
+      m->t_batch[j] = m->t + j * h;
+      casadi_copy(m->v, nv1_, m->v_prev);
+      casadi_copy(m->q, nq1_, m->q_prev);
+      stepF(m, m->t_batch[j], h, m->x_batch + nx1_ * j, m->v_prev,
+        m->x_batch + nx1_ * (j + 1), m->v, m->q);
+      casadi_axpy(nq1_, 1., m->q_prev, m->q);
+      casadi_copy(m->v, nv1_, m->v_batch + nv1_ * j);
+    }
+    casadi_copy(m->x_batch + nx1_ * nj, nx1_, m->x);
+    // Forward sensitivities from the step Jacobians
+    if (nj > 0) {
+      eval_jac_step(m, nj, h, m->x_batch, m->x_batch + nx1_, m->v_batch);
+      fwd_jac_step(m, nj);
+    }
+  } else {
+    // Take steps
+    for (casadi_int j = 0; j < nj; ++j) {
+      // Current time
+      double t = m->t + j * h;
+
+      // Update the previous step
+      casadi_copy(m->x, nx_, m->x_prev);
+      casadi_copy(m->v, nv_, m->v_prev);
+      casadi_copy(m->q, nq_, m->q_prev);
+
+      // Take step
+      stepF(m, t, h, m->x_prev, m->v_prev, m->x, m->v, m->q);
+      casadi_axpy(nq_, 1., m->q_prev, m->q);
+
+      // Save state, if needed
+      if (nrx_ > 0) {
+        casadi_int tapeind = disc_[m->k] + j;
+        casadi_copy(m->x, nx_, m->x_tape + nx_ * (tapeind + 1));
+        casadi_copy(m->v, nv_, m->v_tape + nv_ * tapeind);
+      }
     }
   }
 
@@ -1836,25 +1938,36 @@ void FixedStepIntegrator::retreat(IntegratorMemory* mem, const double* u,
   casadi_int nj = disc_[m->k + 1] - disc_[m->k];
   double h = (m->t - m->t_next) / nj;
 
-  // Take steps
-  for (casadi_int j = nj; j-- > 0; ) {
-    // Current time
-    double t = m->t_next + j * h;
+  if (batch_adj_) {
+    // Adjoint sensitivities from the step Jacobians
+    if (nj > 0) {
+      for (casadi_int j = 0; j < nj; ++j) m->t_batch[j] = m->t_next + j * h;
+      casadi_int k0 = disc_[m->k];
+      eval_jac_step(m, nj, h, m->x_tape + nx_ * k0, m->x_tape + nx_ * (k0 + 1),
+        m->v_tape + nv_ * k0);
+      adj_jac_step(m, nj);
+    }
+  } else {
+    // Take steps
+    for (casadi_int j = nj; j-- > 0; ) {
+      // Current time
+      double t = m->t_next + j * h;
 
-    // Update the previous step
-    casadi_copy(m->rx, nrx_, m->rx_prev);
-    casadi_copy(m->rq, nrq_, m->rq_prev);
-    casadi_copy(m->uq, nuq_, m->uq_prev);
+      // Update the previous step
+      casadi_copy(m->rx, nrx_, m->rx_prev);
+      casadi_copy(m->rq, nrq_, m->rq_prev);
+      casadi_copy(m->uq, nuq_, m->uq_prev);
 
-    // Take step
-    casadi_int tapeind = disc_[m->k] + j;
-    stepB(m, t, h,
-      m->x_tape + nx_ * tapeind, m->x_tape + nx_ * (tapeind + 1),
-      m->v_tape + nv_ * tapeind,
-      m->rx_prev, m->rv, m->rx, m->rq, m->uq);
-    casadi_clear(m->rv, nrv_);
-    casadi_axpy(nrq_, 1., m->rq_prev, m->rq);
-    casadi_axpy(nuq_, 1., m->uq_prev, m->uq);
+      // Take step
+      casadi_int tapeind = disc_[m->k] + j;
+      stepB(m, t, h,
+        m->x_tape + nx_ * tapeind, m->x_tape + nx_ * (tapeind + 1),
+        m->v_tape + nv_ * tapeind,
+        m->rx_prev, m->rv, m->rx, m->rq, m->uq);
+      casadi_clear(m->rv, nrv_);
+      casadi_axpy(nrq_, 1., m->rq_prev, m->rq);
+      casadi_axpy(nuq_, 1., m->uq_prev, m->uq);
+    }
   }
 
   // Return to user
@@ -1879,7 +1992,7 @@ void FixedStepIntegrator::stepF(FixedStepMemory* m, double t, double h,
   m->res[STEP_QF] = qf;  // qf
   calc_function(m, "step");
   // Evaluate sensitivities
-  if (nfwd_ > 0) {
+  if (nfwd_ > 0 && !batch_fwd_) {
     m->arg[STEP_NUM_IN + STEP_XF] = xf;  // out:xf
     m->arg[STEP_NUM_IN + STEP_VF] = vf;  // out:vf
     m->arg[STEP_NUM_IN + STEP_QF] = qf;  // out:qf
@@ -1952,6 +2065,65 @@ void FixedStepIntegrator::stepB(FixedStepMemory* m, double t, double h,
   }
 }
 
+void FixedStepIntegrator::eval_jac_step(FixedStepMemory* m, casadi_int nj, double h,
+    const double* x0, const double* xf, const double* vf) const {
+  std::fill(m->arg, m->arg + STEP_NUM_IN + STEP_NUM_OUT, nullptr);
+  m->arg[STEP_T] = m->t_batch;  // t
+  m->arg[STEP_H] = &h;  // h
+  m->arg[STEP_X0] = x0;  // x0
+  m->arg[STEP_P] = m->p;  // p
+  m->arg[STEP_U] = m->u;  // u
+  m->arg[STEP_NUM_IN + STEP_XF] = xf;  // out:xf
+  m->arg[STEP_NUM_IN + STEP_VF] = vf;  // out:vf
+  m->res[0] = m->jac_batch;  // jac
+  calc_function(m, "jac_step_" + str(nj));
+}
+
+void FixedStepIntegrator::fwd_jac_step(FixedStepMemory* m, casadi_int nj) const {
+  casadi_int nrow = nx1_ + nv1_ + nq1_, ncol = nx1_ + np1_ + nu1_;
+  for (casadi_int d = 1; d <= nfwd_; ++d) {
+    double *x = m->x + nx1_ * d, *v = m->v + nv1_ * d, *q = m->q + nq1_ * d;
+    const double *p = m->p + np1_ * d, *u = m->u + nu1_ * d;
+    for (casadi_int j = 0; j < nj; ++j) {
+      // Columns of the step Jacobian corresponding to x0, p, u
+      const double* J = m->jac_batch + nrow * ncol * j;
+      casadi_clear(m->jac_v, nrow);
+      casadi_mv_dense(J, nrow, nx1_, x, m->jac_v, false);
+      casadi_mv_dense(J + nrow * nx1_, nrow, np1_, p, m->jac_v, false);
+      casadi_mv_dense(J + nrow * (nx1_ + np1_), nrow, nu1_, u, m->jac_v, false);
+      // Sensitivities of xf, vf, qf
+      casadi_copy(m->jac_v, nx1_, x);
+      casadi_copy(m->jac_v + nx1_, nv1_, v);
+      casadi_axpy(nq1_, 1., m->jac_v + nx1_ + nv1_, q);
+    }
+  }
+}
+
+void FixedStepIntegrator::adj_jac_step(FixedStepMemory* m, casadi_int nj) const {
+  casadi_int nrow = nx1_ + nv1_ + nq1_, ncol = nx1_ + np1_ + nu1_;
+  for (casadi_int d = 0; d < nadj_; ++d) {
+    double *rx = m->rx + nrx1_ * d, *rq = m->rq + nrq1_ * d, *uq = m->uq + nuq1_ * d;
+    const double *rv = m->rv + nv1_ * d, *rp = m->rp + nrp1_ * d;
+    for (casadi_int j = nj; j-- > 0; ) {
+      // Adjoint seeds for xf, vf, qf, with impulses in vf entering the last step only
+      const double* J = m->jac_batch + nrow * ncol * j;
+      casadi_copy(rx, nx1_, m->jac_v);
+      if (j == nj - 1) {
+        casadi_copy(rv, nv1_, m->jac_v + nx1_);
+      } else {
+        casadi_clear(m->jac_v + nx1_, nv1_);
+      }
+      casadi_copy(rp, nq1_, m->jac_v + nx1_ + nv1_);
+      // Sensitivities w.r.t. x0, p, u
+      casadi_clear(rx, nx1_);
+      casadi_mv_dense(J, nrow, nx1_, m->jac_v, rx, true);
+      casadi_mv_dense(J + nrow * nx1_, nrow, np1_, m->jac_v, rq, true);
+      casadi_mv_dense(J + nrow * (nx1_ + np1_), nrow, nu1_, m->jac_v, uq, true);
+    }
+  }
+  casadi_clear(m->rv, nrv_);
+}
+
 void FixedStepIntegrator::reset(IntegratorMemory* mem, const double* u, const double* x,
     const double* z, const double* p) const {
   auto m = static_cast<FixedStepMemory*>(mem);
@@ -2052,6 +2224,9 @@ void ImplicitFixedStepIntegrator::init(const Dict& opts) {
   set_function(rf);
   if (nfwd_ > 0) set_function(rf.forward(nfwd_));
 
+  // Batched step Jacobians
+  setup_jac_step();
+
   // Backward integration
   if (nadj_ > 0) {
     Function adj_F = rf.reverse(nadj_);
@@ -2217,23 +2392,36 @@ Integrator::Integrator(DeserializingStream & s) : OracleFunction(s) {
 void FixedStepIntegrator::serialize_body(SerializingStream &s) const {
   Integrator::serialize_body(s);
 
-  s.version("FixedStepIntegrator", 3);
+  s.version("FixedStepIntegrator", 4);
   s.pack("FixedStepIntegrator::nk_target", nk_target_);
   s.pack("FixedStepIntegrator::disc", disc_);
   s.pack("FixedStepIntegrator::nv", nv_);
   s.pack("FixedStepIntegrator::nv1", nv1_);
   s.pack("FixedStepIntegrator::nrv", nrv_);
   s.pack("FixedStepIntegrator::nrv1", nrv1_);
+  s.pack("FixedStepIntegrator::step_parallelization", step_parallelization_);
+  s.pack("FixedStepIntegrator::batch_fwd", batch_fwd_);
+  s.pack("FixedStepIntegrator::batch_adj", batch_adj_);
+  s.pack("FixedStepIntegrator::nj_max", nj_max_);
 }
 
 FixedStepIntegrator::FixedStepIntegrator(DeserializingStream & s) : Integrator(s) {
-  s.version("FixedStepIntegrator", 3);
+  int version = s.version("FixedStepIntegrator", 3, 4);
   s.unpack("FixedStepIntegrator::nk_target", nk_target_);
   s.unpack("FixedStepIntegrator::disc", disc_);
   s.unpack("FixedStepIntegrator::nv", nv_);
   s.unpack("FixedStepIntegrator::nv1", nv1_);
   s.unpack("FixedStepIntegrator::nrv", nrv_);
   s.unpack("FixedStepIntegrator::nrv1", nrv1_);
+  if (version >= 4) {
+    s.unpack("FixedStepIntegrator::step_parallelization", step_parallelization_);
+    s.unpack("FixedStepIntegrator::batch_fwd", batch_fwd_);
+    s.unpack("FixedStepIntegrator::batch_adj", batch_adj_);
+    s.unpack("FixedStepIntegrator::nj_max", nj_max_);
+  } else {
+    batch_fwd_ = batch_adj_ = false;
+    nj_max_ = 0;
+  }
 }
 
 void ImplicitFixedStepIntegrator::serialize_body(SerializingStream &s) const {
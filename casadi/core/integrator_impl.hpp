@@ -469,6 +469,9 @@ struct CASADI_EXPORT FixedStepMemory : public IntegratorMemory {
 
   /// State and dependent variables at all times
   double *x_tape, *v_tape;
+
+  /// Batched evaluation of the step Jacobians
+  double *t_batch, *x_batch, *v_batch, *jac_batch, *jac_v;
 };
 
 class CASADI_EXPORT FixedStepIntegrator : public Integrator {
@@ -554,9 +557,31 @@ class CASADI_EXPORT FixedStepIntegrator : public Integrator {
     const double* rx0, const double* rv0,
     double* rxf, double* rqf, double* uqf) const;
 
+  /// Setup batched evaluation of the step Jacobians
+  void setup_jac_step();
+
+  /// Evaluate the step Jacobians of an output interval in one batched call
+  void eval_jac_step(FixedStepMemory* m, casadi_int nj, double h,
+    const double* x0, const double* xf, const double* vf) const;
+
+  /// Propagate forward sensitivities over an output interval using the step Jacobians
+  void fwd_jac_step(FixedStepMemory* m, casadi_int nj) const;
+
+  /// Propagate adjoint sensitivities over an output interval using the step Jacobians
+  void adj_jac_step(FixedStepMemory* m, casadi_int nj) const;
+
   // Target number of finite elements
   casadi_int nk_target_;
 
+  // Parallelization of the batched step Jacobians, empty if disabled
+  std::string step_parallelization_;
+
+  // Batched step Jacobians in the forward and adjoint sweeps
+  bool batch_fwd_, batch_adj_;
+
+  // Largest number of steps in an output interval
+  casadi_int nj_max_;
+
   // Number of steps per control interval
   std::vector<casadi_int> disc_;
 
@@ -0,0 +1,375 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "jit_cache.hpp"
+#include "casadi_misc.hpp"
+#include <casadi/config.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <direct.h>
+#include <io.h>
+#include <sys/utime.h>
+#else // _WIN32
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#endif // _WIN32
+
+namespace casadi {
+
+  namespace {
+
+    // Counters for the current process
+    std::atomic<casadi_int> n_hit(0), n_miss(0), n_wait(0), n_store(0), n_evict(0);
+
+    // SHA-256, FIPS 180-4
+    class Sha256 {
+    public:
+      Sha256() : len_(0), n_buf_(0) {
+        static const uint32_t h0[8] = {
+          0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+          0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        std::copy(h0, h0+8, h_);
+      }
+
+      void update(const std::string& s) {
+        for (char c : s) {
+          buf_[n_buf_++] = static_cast<unsigned char>(c);
+          if (n_buf_==64) {
+            block();
+            n_buf_ = 0;
+          }
+        }
+        len_ += s.size();
+      }
+
+      std::string hexdigest() {
+        uint64_t bits = 8*len_;
+        std::string pad(1, '\x80');
+        pad.append((n_buf_ < 56 ? 55 - n_buf_ : 119 - n_buf_), '\0');
+        for (int k=7; k>=0; --k) pad.push_back(static_cast<char>((bits >> (8*k)) & 0xff));
+        update(pad);
+        std::stringstream ss;
+        for (int k=0; k<8; ++k) ss << std::hex << std::setw(8) << std::setfill('0') << h_[k];
+        return ss.str();
+      }
+
+    private:
+      static uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32-n));}
+
+      void block() {
+        static const uint32_t k[64] = {
+          0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+          0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+          0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+          0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+          0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+          0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+          0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+          0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+          0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+          0xc67178f2};
+        uint32_t w[64];
+        for (int i=0; i<16; ++i) {
+          w[i] = (uint32_t(buf_[4*i]) << 24) | (uint32_t(buf_[4*i+1]) << 16)
+            | (uint32_t(buf_[4*i+2]) << 8) | uint32_t(buf_[4*i+3]);
+        }
+        for (int i=16; i<64; ++i) {
+          uint32_t s0 = rotr(w[i-15], 7) ^ rotr(w[i-15], 18) ^ (w[i-15] >> 3);
+          uint32_t s1 = rotr(w[i-2], 17) ^ rotr(w[i-2], 19) ^ (w[i-2] >> 10);
+          w[i] = w[i-16] + s0 + w[i-7] + s1;
+        }
+        uint32_t a[8];
+        std::copy(h_, h_+8, a);
+        for (int i=0; i<64; ++i) {
+          uint32_t s1 = rotr(a[4], 6) ^ rotr(a[4], 11) ^ rotr(a[4], 25);
+          uint32_t ch = (a[4] & a[5]) ^ (~a[4] & a[6]);
+          uint32_t t1 = a[7] + s1 + ch + k[i] + w[i];
+          uint32_t s0 = rotr(a[0], 2) ^ rotr(a[0], 13) ^ rotr(a[0], 22);
+          uint32_t maj = (a[0] & a[1]) ^ (a[0] & a[2]) ^ (a[1] & a[2]);
+          uint32_t t2 = s0 + maj;
+          std::copy_backward(a, a+7, a+8);
+          a[4] += t1;
+          a[0] = t1 + t2;
+        }
+        for (int i=0; i<8; ++i) h_[i] += a[i];
+      }
+
+      uint32_t h_[8];
+      uint64_t len_;
+      unsigned char buf_[64];
+      size_t n_buf_;
+    };
+
+    // Size and modification time of a file, false if it does not exist
+    bool file_info(const std::string& name, casadi_int& size, double& mtime) {
+      struct stat st;
+      if (stat(name.c_str(), &st)) return false;
+      size = st.st_size;
+      mtime = static_cast<double>(st.st_mtime);
+      return true;
+    }
+
+    bool file_exists(const std::string& name) {
+      casadi_int size;
+      double mtime;
+      return file_info(name, size, mtime);
+    }
+
+    // Mark a file as recently used
+    void touch(const std::string& name) {
+#ifdef _WIN32
+      _utime(name.c_str(), nullptr);
+#else // _WIN32
+      utime(name.c_str(), nullptr);
+#endif // _WIN32
+    }
+
+    // Create a directory, false if it already exists or cannot be created
+    bool make_dir(const std::string& name) {
+#ifdef _WIN32
+      return _mkdir(name.c_str())==0;
+#else // _WIN32
+      return mkdir(name.c_str(), 0777)==0;
+#endif // _WIN32
+    }
+
+    void remove_dir(const std::string& name) {
+#ifdef _WIN32
+      _rmdir(name.c_str());
+#else // _WIN32
+      rmdir(name.c_str());
+#endif // _WIN32
+    }
+
+    // File names in a directory
+    std::vector<std::string> list_dir(const std::string& directory) {
+      std::vector<std::string> ret;
+#ifdef _WIN32
+      struct _finddata_t fd;
+      intptr_t h = _findfirst((directory + "*").c_str(), &fd);
+      if (h==-1) return ret;
+      do {
+        ret.push_back(fd.name);
+      } while (_findnext(h, &fd)==0);
+      _findclose(h);
+#else // _WIN32
+      DIR* d = opendir(directory.c_str());
+      if (d==nullptr) return ret;
+      while (struct dirent* e = readdir(d)) ret.push_back(e->d_name);
+      closedir(d);
+#endif // _WIN32
+      return ret;
+    }
+
+    // Is a file name that of a cached library
+    bool is_entry(const std::string& name) {
+      const std::string suffix = CASADI_SHARED_LIBRARY_SUFFIX;
+      if (name.size()!=64+suffix.size()) return false;
+      if (name.compare(64, suffix.size(), suffix)!=0) return false;
+      return std::all_of(name.begin(), name.begin()+64,
+        [](char c) { return (c>='0' && c<='9') || (c>='a' && c<='f');});
+    }
+
+    double now() {
+      return static_cast<double>(std::time(nullptr));
+    }
+
+    void sleep_ms(int ms) {
+#ifdef _WIN32
+      Sleep(ms);
+#else // _WIN32
+      usleep(1000*ms);
+#endif // _WIN32
+    }
+
+  } // namespace
+
+  const double JitCache::lock_timeout = 600;
+
+  JitCache::JitCache(const std::string& directory, casadi_int max_size)
+      : directory_(directory), max_size_(max_size) {
+    casadi_assert(!directory_.empty(), "Cache directory must be specified");
+    if (directory_.back()!='/' && directory_.back()!='\\') directory_ += "/";
+    make_dir(directory_);
+  }
+
+  std::string JitCache::default_directory() {
+    const char* dir = std::getenv("CASADI_JIT_CACHE");
+    return dir ? dir : "";
+  }
+
+  std::string JitCache::key(const std::string& source, const std::string& config) {
+    Sha256 h;
+    // Length-prefix the fields to keep the encoding unambiguous
+    for (const std::string& s : {std::string(CASADI_VERSION_STRING), config, source}) {
+      h.update(str(s.size()) + ":");
+      h.update(s);
+    }
+    return h.hexdigest();
+  }
+
+  std::string JitCache::library(const std::string& key) const {
+    return directory_ + key + CASADI_SHARED_LIBRARY_SUFFIX;
+  }
+
+  std::string JitCache::get(const std::string& key, const Build& build) {
+    std::string lib = library(key), lock = directory_ + key + ".lock";
+    bool waited = false;
+    for (;;) {
+      // Hit
+      if (file_exists(lib)) {
+        touch(lib);
+        n_hit++;
+        if (waited) n_wait++;
+        return lib;
+      }
+      // Become the builder
+      if (make_dir(lock)) break;
+      // Another process is building, unless it died while doing so
+      casadi_int size;
+      double mtime;
+      if (file_info(lock, size, mtime) && now() - mtime > lock_timeout) {
+        remove_dir(lock);
+      } else {
+        waited = true;
+        sleep_ms(50);
+      }
+    }
+
+    // The builder may have finished between the lookup and taking the lock
+    if (file_exists(lib)) {
+      remove_dir(lock);
+      touch(lib);
+      n_hit++;
+      return lib;
+    }
+
+    // Build and store
+    n_miss++;
+    try {
+      std::string built = build();
+      if (built.empty()) {
+        remove_dir(lock);
+        return "";
+      }
+      store(key, built);
+    } catch (...) {
+      remove_dir(lock);
+      throw;
+    }
+    remove_dir(lock);
+    evict(key);
+    return lib;
+  }
+
+  void JitCache::store(const std::string& key, const std::string& lib) const {
+    // Write to a private file first
+    std::string tmp = temporary_file(directory_ + key + ".", ".tmp");
+    {
+      std::ifstream src(lib, std::ios_base::binary);
+      casadi_assert(src.good(), "Cannot open '" + lib + "' for caching");
+      std::ofstream dst(tmp, std::ios_base::binary | std::ios_base::trunc);
+      casadi_assert(dst.good(), "Cannot write to jit cache '" + directory_ + "'");
+      dst << src.rdbuf();
+      casadi_assert(dst.good(), "Failed to write '" + tmp + "'");
+    }
+#ifndef _WIN32
+    // Temporary files are private, cached libraries are not
+    chmod(tmp.c_str(), 0644);
+#endif // _WIN32
+    // Make visible atomically
+    if (std::rename(tmp.c_str(), library(key).c_str())) {
+      std::remove(tmp.c_str());
+      casadi_assert(file_exists(library(key)), "Failed to store '" + lib + "' in jit cache");
+    }
+    n_store++;
+  }
+
+  void JitCache::evict(const std::string& key) const {
+    if (max_size_<=0) return;
+    // Collect entries, least recently used first
+    std::vector<std::pair<double, std::string> > entries;
+    casadi_int total = 0;
+    for (const std::string& name : list_dir(directory_)) {
+      if (!is_entry(name)) continue;
+      casadi_int size;
+      double mtime;
+      if (!file_info(directory_ + name, size, mtime)) continue;
+      total += size;
+      if (name.compare(0, 64, key)!=0) entries.emplace_back(mtime, name);
+    }
+    std::sort(entries.begin(), entries.end());
+    // Remove until the bound holds
+    for (auto&& e : entries) {
+      if (total<=max_size_) break;
+      casadi_int size;
+      double mtime;
+      if (!file_info(directory_ + e.second, size, mtime)) continue;
+      if (std::remove((directory_ + e.second).c_str())==0) {
+        total -= size;
+        n_evict++;
+      }
+    }
+  }
+
+  Dict JitCache::stats() const {
+    Dict ret;
+    casadi_int n_entries = 0, size = 0;
+    for (const std::string& name : list_dir(directory_)) {
+      if (!is_entry(name)) continue;
+      casadi_int sz;
+      double mtime;
+      if (!file_info(directory_ + name, sz, mtime)) continue;
+      n_entries++;
+      size += sz;
+    }
+    ret["directory"] = directory_;
+    ret["n_entries"] = n_entries;
+    ret["size"] = size;
+    ret["n_hit"] = static_cast<casadi_int>(n_hit);
+    ret["n_miss"] = static_cast<casadi_int>(n_miss);
+    ret["n_wait"] = static_cast<casadi_int>(n_wait);
+    ret["n_store"] = static_cast<casadi_int>(n_store);
+    ret["n_evict"] = static_cast<casadi_int>(n_evict);
+    return ret;
+  }
+
+} // namespace casadi
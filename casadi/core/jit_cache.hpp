@@ -0,0 +1,98 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_JIT_CACHE_HPP
+#define CASADI_JIT_CACHE_HPP
+
+#include "generic_type.hpp"
+
+#include <functional>
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Persistent, content-addressed cache of just-in-time compiled libraries
+
+      Compiled shared libraries are stored in a directory under a name derived
+      from a SHA-256 hash of the generated source and the compiler configuration.
+      The directory may be shared between processes: a library is built by
+      at most one process at a time (guarded by a lock directory, which is
+      considered abandoned after lock_timeout seconds) and becomes visible through
+      an atomic rename only when complete.
+      When the total size of the cached libraries exceeds the bound, the least
+      recently used entries are removed.
+  */
+  class CASADI_EXPORT JitCache {
+  public:
+    /** \brief Compile a library, returning its file name
+
+        An empty return value means that the result cannot be cached. */
+    typedef std::function<std::string()> Build;
+
+    /** \brief Constructor
+
+        \param directory Cache directory, created if needed
+        \param max_size Bound on the total size in bytes, nonpositive for no bound */
+    JitCache(const std::string& directory, casadi_int max_size);
+
+    /// Cache directory from the environment variable CASADI_JIT_CACHE, if set
+    static std::string default_directory();
+
+    /// Key of a library from its source and compiler configuration
+    static std::string key(const std::string& source, const std::string& config);
+
+    /// File name of a cached library
+    std::string library(const std::string& key) const;
+
+    /** \brief Get the file name of the library with a given key, building it if missing
+
+        Returns an empty string if the build result could not be cached. */
+    std::string get(const std::string& key, const Build& build);
+
+    /// Statistics of the cache directory and counters for this process
+    Dict stats() const;
+
+    /// Seconds after which a lock is considered abandoned
+    static const double lock_timeout;
+
+  private:
+    /// Copy a library into the cache, atomically
+    void store(const std::string& key, const std::string& lib) const;
+
+    /// Remove least recently used entries, except key, until the size bound holds
+    void evict(const std::string& key) const;
+
+    /// Cache directory, ending with a file separator
+    std::string directory_;
+
+    /// Bound on the total size in bytes
+    casadi_int max_size_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_JIT_CACHE_HPP
@@ -133,6 +133,7 @@ namespace casadi {
     /// Low-level API
     int sfact(const double* A, int mem=0) const;
     int nfact(const double* A, int mem=0) const;
+    // Solve in-place for a dense block of nrhs right-hand sides stored column by column
     int solve(const double* A, double* x, casadi_int nrhs=1, bool tr=false, int mem=0) const;
     casadi_int neig(const double* A, int mem=0) const;
     casadi_int rank(const double* A, int mem=0) const;
@@ -24,9 +24,168 @@
 
 
 #include "linsol_internal.hpp"
+#include "thread_pool.hpp"
+
+#include <queue>
 
 namespace casadi {
 
+  void EtreeSchedule::init(const Sparsity& sp_r, casadi_int n_threads) {
+    n = sp_r.size2();
+    task_ptr.assign(1, 0);
+    task_col.clear();
+    top.clear();
+    const casadi_int *colind = sp_r.colind(), *row = sp_r.row();
+    // Elimination tree: parent of r is the first column below it with an entry in row r
+    std::vector<casadi_int> parent(n, -1);
+    for (casadi_int c=0; c<n; ++c) {
+      for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+        casadi_int r = row[k];
+        if (r<c && (parent[r]<0 || c<parent[r])) parent[r] = c;
+      }
+    }
+    // Estimated work per column and per subtree
+    std::vector<double> weight(n), subtree(n, 0);
+    for (casadi_int c=0; c<n; ++c) {
+      weight[c] = 1 + colind[c+1] - colind[c];
+      for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+        casadi_int r = row[k];
+        if (r<c) weight[c] += colind[r+1] - colind[r];
+      }
+      subtree[c] += weight[c];
+      if (parent[c]>=0) subtree[parent[c]] += subtree[c];
+    }
+    // Children of each column
+    std::vector<casadi_int> child_ptr(n+1, 0), child(n);
+    for (casadi_int c=0; c<n; ++c) if (parent[c]>=0) child_ptr[parent[c]+1]++;
+    for (casadi_int c=0; c<n; ++c) child_ptr[c+1] += child_ptr[c];
+    std::vector<casadi_int> next(child_ptr.begin(), child_ptr.end()-1);
+    for (casadi_int c=0; c<n; ++c) if (parent[c]>=0) child[next[parent[c]]++] = c;
+    // Subtrees that are factorized concurrently, starting with the whole tree
+    auto lighter = [&](casadi_int i, casadi_int j) { return subtree[i]<subtree[j];};
+    std::priority_queue<casadi_int, std::vector<casadi_int>, decltype(lighter)> front(lighter);
+    double front_work = 0;
+    for (casadi_int c=0; c<n; ++c) {
+      if (parent[c]<0) {
+        front.push(c);
+        front_work += subtree[c];
+      }
+    }
+    // Threading does not pay off for small factorizations
+    bool serial = n_threads<=1 || front_work<1e4;
+    // Split the heaviest subtree until it no longer dominates
+    std::vector<bool> is_top(n, serial);
+    while (!serial && !front.empty()) {
+      casadi_int c = front.top();
+      if (subtree[c]*n_threads <= front_work) break;
+      front.pop();
+      is_top[c] = true;
+      front_work -= weight[c];
+      for (casadi_int k=child_ptr[c]; k<child_ptr[c+1]; ++k) front.push(child[k]);
+    }
+    // Assign columns to subtrees, heaviest first
+    std::vector<casadi_int> owner(n, -1);
+    casadi_int n_task = 0;
+    while (!serial && !front.empty()) {
+      owner[front.top()] = n_task++;
+      front.pop();
+    }
+    for (casadi_int c=n-1; c>=0; --c) {
+      if (owner[c]<0 && !is_top[c]) owner[c] = owner[parent[c]];
+    }
+    task_ptr.resize(n_task+1, 0);
+    for (casadi_int c=0; c<n; ++c) {
+      if (owner[c]>=0) {
+        task_ptr[owner[c]+1]++;
+      } else {
+        top.push_back(c);
+      }
+    }
+    for (casadi_int t=0; t<n_task; ++t) task_ptr[t+1] += task_ptr[t];
+    task_col.resize(task_ptr.back());
+    next.assign(task_ptr.begin(), task_ptr.end()-1);
+    for (casadi_int c=0; c<n; ++c) if (owner[c]>=0) task_col[next[owner[c]]++] = c;
+  }
+
+  void EtreeSchedule::run(casadi_int n_threads,
+      const std::function<void(casadi_int, casadi_int)>& fcn) const {
+    casadi_int n_task = task_ptr.size()-1;
+    if (n_task>1 && n_threads>1) {
+      ThreadPool::instance().run(n_task, std::min(n_threads, n_task), 1,
+        [&](casadi_int slot, casadi_int begin, casadi_int end) {
+          for (casadi_int t=begin; t<end; ++t) {
+            for (casadi_int k=task_ptr[t]; k<task_ptr[t+1]; ++k) fcn(slot, task_col[k]);
+          }
+        });
+    } else {
+      for (casadi_int c : task_col) fcn(0, c);
+    }
+    for (casadi_int c : top) fcn(0, c);
+  }
+
+  std::vector<casadi_int> EtreeSchedule::nested_dissection(const Sparsity& sp,
+      casadi_int n_part) {
+    casadi_int n = sp.size2();
+    const casadi_int *colind = sp.colind(), *row = sp.row();
+    std::vector<casadi_int> ret, level(n), stamp(n, -1), queue(n), tmp;
+    ret.reserve(n);
+    casadi_int next_stamp = 0;
+    // Breadth-first search within the set marked st, returns the number of vertices reached
+    auto bfs = [&](casadi_int start, casadi_int st) {
+      casadi_int n_queue = 0;
+      queue[n_queue++] = start;
+      stamp[start] = st + 1;
+      level[start] = 0;
+      for (casadi_int i=0; i<n_queue; ++i) {
+        casadi_int c = queue[i];
+        for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+          casadi_int r = row[k];
+          if (stamp[r]!=st) continue;
+          stamp[r] = st + 1;
+          level[r] = level[c] + 1;
+          queue[n_queue++] = r;
+        }
+      }
+      return n_queue;
+    };
+    std::function<void(const std::vector<casadi_int>&, casadi_int)> dissect;
+    dissect = [&](const std::vector<casadi_int>& S, casadi_int np) {
+      casadi_int ns = S.size();
+      if (np>1 && ns>=64) {
+        // Pseudo-peripheral vertex
+        casadi_int st = next_stamp;
+        next_stamp += 3;
+        for (casadi_int c : S) stamp[c] = st;
+        casadi_int n_reached = bfs(S[0], st);
+        casadi_int far = queue[n_reached-1];
+        for (casadi_int c : S) stamp[c] = st + 1;
+        n_reached = bfs(far, st + 1);
+        std::vector<casadi_int> A, B, sep;
+        if (n_reached<ns) {
+          // Disconnected: the component of far versus the rest, no separator
+          for (casadi_int c : S) (stamp[c]==st + 2 ? A : B).push_back(c);
+        } else {
+          // Separate at the level where half of the vertices have been reached
+          casadi_int mid = level[queue[ns/2]];
+          for (casadi_int c : S) {
+            (level[c]<mid ? A : level[c]==mid ? sep : B).push_back(c);
+          }
+        }
+        if (!A.empty() && !B.empty()) {
+          dissect(A, np/2);
+          dissect(B, np - np/2);
+          ret.insert(ret.end(), sep.begin(), sep.end());
+          return;
+        }
+      }
+      // AMD within the part
+      std::vector<casadi_int> p = sp.sub(S, S, tmp).amd();
+      for (casadi_int i : p) ret.push_back(S[i]);
+    };
+    dissect(range(n), n_part);
+    return ret;
+  }
+
   LinsolInternal::LinsolInternal(const std::string& name, const Sparsity& sp)
    : ProtoFunction(name), sp_(sp) {
   }
@@ -30,6 +30,8 @@
 #include "function_internal.hpp"
 #include "plugin_interface.hpp"
 
+#include <functional>
+
 /// \cond INTERNAL
 
 namespace casadi {
@@ -42,6 +44,38 @@ namespace casadi {
     LinsolMemory() : is_sfact(false), is_nfact(false) {}
   };
 
+  /** \brief Parallel schedule for a column-by-column numeric factorization
+
+      Column c of the factor depends on the columns r<c of the pattern of its
+      c-th column, which are descendants of c in the elimination tree. The tree
+      is split into independent subtrees of similar work, that are factorized
+      concurrently, followed by the remaining columns near the root.
+  */
+  struct CASADI_EXPORT EtreeSchedule {
+    // Number of columns
+    casadi_int n;
+    // Columns of each subtree, in increasing order, heaviest subtree first
+    std::vector<casadi_int> task_ptr, task_col;
+    // Remaining columns, in increasing order
+    std::vector<casadi_int> top;
+
+    /** \brief Split for a given number of threads
+
+        sp_r is the pattern of the (transposed) factor, entries below the diagonal are ignored */
+    void init(const Sparsity& sp_r, casadi_int n_threads);
+
+    /// Factorize by calling fcn(slot, c) for every column, slot in [0, n_threads)
+    void run(casadi_int n_threads, const std::function<void(casadi_int, casadi_int)>& fcn) const;
+
+    /** \brief Fill-reducing ordering with independent subtrees
+
+        Nested dissection of a symmetric pattern into about n_part parts, using
+        BFS level sets as separators and AMD within the parts. Unlike plain AMD,
+        this avoids elimination trees dominated by a single path, as is typical
+        for the KKT systems of optimal control problems. */
+    static std::vector<casadi_int> nested_dissection(const Sparsity& sp, casadi_int n_part);
+  };
+
   /** Internal class
       @copydoc Linsol_doc
   */
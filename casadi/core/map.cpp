@@ -25,26 +25,23 @@
 
 #include "map.hpp"
 #include "serializing_stream.hpp"
-
-#ifdef CASADI_WITH_THREAD
-#ifdef CASADI_WITH_THREAD_MINGW
-#include <mingw.thread.h>
-#else // CASADI_WITH_THREAD_MINGW
-#include <thread>
-#endif // CASADI_WITH_THREAD_MINGW
-#endif // CASADI_WITH_THREAD
+#include "thread_pool.hpp"
+#include "sx_function.hpp"
 
 namespace casadi {
 
-  Function Map::create(const std::string& parallelization, const Function& f, casadi_int n) {
+  Function Map::create(const std::string& parallelization, const Function& f, casadi_int n,
+      const Dict& opts) {
     // Create instance of the right class
     std::string suffix = str(n) + "_" + f.name();
     if (parallelization == "serial") {
-      return Function::create(new Map("map" + suffix, f, n), Dict());
+      return Function::create(new Map("map" + suffix, f, n), opts);
     } else if (parallelization== "openmp") {
-      return Function::create(new OmpMap("ompmap" + suffix, f, n), Dict());
+      return Function::create(new OmpMap("ompmap" + suffix, f, n), opts);
     } else if (parallelization== "thread") {
-      return Function::create(new ThreadMap("threadmap" + suffix, f, n), Dict());
+      return Function::create(new ThreadMap("threadmap" + suffix, f, n), opts);
+    } else if (parallelization== "simd") {
+      return Function::create(new SimdMap("simdmap" + suffix, f, n), opts);
     } else {
       casadi_error("Unknown parallelization: " + parallelization);
     }
@@ -69,6 +66,11 @@ namespace casadi {
       || (recursive && Map::is_a(type, recursive));
   }
 
+  bool SimdMap::is_a(const std::string& type, bool recursive) const {
+    return type=="SimdMap"
+      || (recursive && Map::is_a(type, recursive));
+  }
+
  std::vector<std::string> Map::get_function() const {
     return {"f"};
   }
@@ -109,6 +111,8 @@ namespace casadi {
       return new OmpMap(s);
     } else if (class_name=="ThreadMap") {
       return new ThreadMap(s);
+    } else if (class_name=="SimdMap") {
+      return new SimdMap(s);
     } else {
       casadi_error("class name '" + class_name + "' unknown.");
     }
@@ -213,7 +217,7 @@ namespace casadi {
                 const Dict& opts) const {
     // Generate map of derivative
     Function df = f_.forward(nfwd);
-    Function dm = df.map(n_, parallelization());
+    Function dm = map_derivative(df);
 
     // Input expressions
     std::vector<MX> arg = dm.mx_in();
@@ -267,7 +271,7 @@ namespace casadi {
                 const Dict& opts) const {
     // Generate map of derivative
     Function df = f_.reverse(nadj);
-    Function dm = df.map(n_, parallelization());
+    Function dm = map_derivative(df);
 
     // Input expressions
     std::vector<MX> arg = dm.mx_in();
@@ -417,11 +421,31 @@ namespace casadi {
   }
 
 
+  ThreadMap::ThreadMap(const std::string& name, const Function& f, casadi_int n)
+      : Map(name, f, n) {
+    max_num_threads_ = ThreadPool::hardware_concurrency();
+    chunk_size_ = 0;
+    n_slots_ = 1;
+  }
+
   ThreadMap::~ThreadMap() {
     clear_mem();
   }
 
-  void ThreadsWork(const Function& f, casadi_int i,
+  const Options ThreadMap::options_
+  = {{&FunctionInternal::options_},
+     {{"max_num_threads",
+       {OT_INT,
+        "Maximum number of threads used for an evaluation, including the calling thread "
+        "[default: hardware concurrency]"}},
+      {"chunk_size",
+       {OT_INT,
+        "Number of consecutive instances handed to a thread at once "
+        "[default: automatic]"}}
+     }
+  };
+
+  void ThreadsWork(const Function& f, casadi_int i, casadi_int slot,
       const double** arg, double** res,
       casadi_int* iw, double* w,
       casadi_int ind, int& ret) {
@@ -435,19 +459,19 @@ namespace casadi {
     f.sz_work(sz_arg, sz_res, sz_iw, sz_w);
 
     // Input buffers
-    const double** arg1 = arg + n_in + i*sz_arg;
+    const double** arg1 = arg + n_in + slot*sz_arg;
     for (casadi_int j=0; j<n_in; ++j) {
       arg1[j] = arg[j] ? arg[j] + i*f.nnz_in(j) : nullptr;
     }
 
     // Output buffers
-    double** res1 = res + n_out + i*sz_res;
+    double** res1 = res + n_out + slot*sz_res;
     for (casadi_int j=0; j<n_out; ++j) {
       res1[j] = res[j] ? res[j] + i*f.nnz_out(j) : nullptr;
     }
 
     try {
-      ret = f(arg1, res1, iw + i*sz_iw, w + i*sz_w, ind);
+      ret = f(arg1, res1, iw + slot*sz_iw, w + slot*sz_w, ind);
     } catch (std::exception& e) {
       ret = 1;
       casadi_warning("Exception raised: " + std::string(e.what()));
@@ -463,29 +487,20 @@ namespace casadi {
 #ifndef CASADI_WITH_THREAD
     return Map::eval(arg, res, iw, w, mem);
 #else // CASADI_WITH_THREAD
-    // Checkout memory objects
-    std::vector< scoped_checkout<Function> > ind; ind.reserve(n_);
-    for (casadi_int i=0; i<n_; ++i) ind.emplace_back(f_);
+    // Checkout one memory object per slot
+    std::vector< scoped_checkout<Function> > ind; ind.reserve(n_slots_);
+    for (casadi_int s=0; s<n_slots_; ++s) ind.emplace_back(f_);
 
     // Allocate space for return values
     std::vector<int> ret_values(n_);
 
-    // Spawn threads
-    std::vector<std::thread> threads;
-    for (casadi_int i=0; i<n_; ++i) {
-      // Why the lambda function?
-      // Because it was the first iteration to pass tests on MingGW
-      // using mingw-std-threads.
-      threads.emplace_back(
-        [i](const Function& f, const double** arg, double** res,
-            casadi_int* iw, double* w, casadi_int ind, int& ret) {
-              ThreadsWork(f, i, arg, res, iw, w, ind, ret);
-            },
-        std::ref(f_), arg, res, iw, w, casadi_int(ind[i]), std::ref(ret_values[i]));
-    }
-
-    // Join threads
-    for (auto && th : threads) th.join();
+    // Evaluate in chunks on the thread pool
+    ThreadPool::instance().run(n_, n_slots_, chunk_size_,
+      [&](casadi_int slot, casadi_int begin, casadi_int end) {
+        for (casadi_int i=begin; i<end; ++i) {
+          ThreadsWork(f_, i, slot, arg, res, iw, w, ind[slot], ret_values[i]);
+        }
+      });
 
     // Anticipate success
     int ret = 0;
@@ -497,6 +512,11 @@ namespace casadi {
 #endif // CASADI_WITH_THREAD
   }
 
+  Function ThreadMap::map_derivative(const Function& df) const {
+    return Map::create(parallelization(), df, n_,
+      {{"max_num_threads", max_num_threads_}, {"chunk_size", chunk_size_}});
+  }
+
   void ThreadMap::codegen_body(CodeGenerator& g) const {
     Map::codegen_body(g);
   }
@@ -509,14 +529,151 @@ namespace casadi {
     // Call the initialization method of the base class
     Map::init(opts);
 
-    // Allocate memory for holding memory object references
-    alloc_iw(n_, true);
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="max_num_threads") {
+        max_num_threads_ = op.second;
+      } else if (op.first=="chunk_size") {
+        chunk_size_ = op.second;
+      }
+    }
+    casadi_assert(max_num_threads_>=1, "max_num_threads invalid.");
+
+    // No more threads than instances
+    n_slots_ = std::min(n_, max_num_threads_);
 
     // Allocate sufficient memory for parallel evaluation
-    alloc_arg(f_.sz_arg() * n_);
-    alloc_res(f_.sz_res() * n_);
-    alloc_w(f_.sz_w() * n_);
-    alloc_iw(f_.sz_iw() * n_);
+    alloc_arg(f_.sz_arg() * n_slots_);
+    alloc_res(f_.sz_res() * n_slots_);
+    alloc_w(f_.sz_w() * n_slots_);
+    alloc_iw(f_.sz_iw() * n_slots_);
+  }
+
+  void ThreadMap::serialize_body(SerializingStream &s) const {
+    Map::serialize_body(s);
+    s.version("ThreadMap", 1);
+    s.pack("ThreadMap::max_num_threads", max_num_threads_);
+    s.pack("ThreadMap::chunk_size", chunk_size_);
+    s.pack("ThreadMap::n_slots", n_slots_);
+  }
+
+  ThreadMap::ThreadMap(DeserializingStream& s) : Map(s) {
+    s.version("ThreadMap", 1);
+    s.unpack("ThreadMap::max_num_threads", max_num_threads_);
+    s.unpack("ThreadMap::chunk_size", chunk_size_);
+    s.unpack("ThreadMap::n_slots", n_slots_);
+  }
+
+  SimdMap::SimdMap(const std::string& name, const Function& f, casadi_int n)
+      : Map(name, f, n) {
+    batch_size_ = 8;
+    lockstep_ = false;
+  }
+
+  SimdMap::~SimdMap() {
+    clear_mem();
+  }
+
+  const Options SimdMap::options_
+  = {{&FunctionInternal::options_},
+     {{"batch_size",
+       {OT_INT,
+        "Number of instances evaluated in lockstep [default: 8]"}}
+     }
+  };
+
+  void SimdMap::init(const Dict& opts) {
+    // Call the initialization method of the base class
+    Map::init(opts);
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="batch_size") {
+        batch_size_ = op.second;
+      }
+    }
+    casadi_assert(batch_size_>=1, "batch_size invalid.");
+
+    // Lockstep evaluation requires a flat instruction list
+    lockstep_ = f_.is_a("SXFunction", false) && !f_.has_free();
+    if (!lockstep_ && verbose_) {
+      casadi_message(name_ + ": " + f_.class_name() + " cannot be evaluated in lockstep. "
+        "Falling back to serial evaluation.");
+    }
+
+    // Work vector, structure-of-arrays
+    if (lockstep_) alloc_w(f_.sz_w() * batch_size_);
+  }
+
+  int SimdMap::eval(const double** arg, double** res, casadi_int* iw, double* w,
+      void* mem) const {
+    if (!lockstep_) return Map::eval(arg, res, iw, w, mem);
+    const SXFunction* f = static_cast<const SXFunction*>(f_.get());
+    // Buffers pointing to the first instance of the batch
+    const double** arg1 = arg + n_in_;
+    double** res1 = res + n_out_;
+    for (casadi_int i=0; i<n_; i+=batch_size_) {
+      for (casadi_int j=0; j<n_in_; ++j) {
+        arg1[j] = arg[j] ? arg[j] + i*f_.nnz_in(j) : nullptr;
+      }
+      for (casadi_int j=0; j<n_out_; ++j) {
+        res1[j] = res[j] ? res[j] + i*f_.nnz_out(j) : nullptr;
+      }
+      if (f->eval_batch(arg1, res1, w, std::min(batch_size_, n_-i), batch_size_)) return 1;
+    }
+    return 0;
+  }
+
+  Function SimdMap::map_derivative(const Function& df) const {
+    return Map::create(parallelization(), df, n_, {{"batch_size", batch_size_}});
+  }
+
+  void SimdMap::codegen_declarations(CodeGenerator& g) const {
+    // Instructions are inlined in lockstep mode, no dependency on f_
+    if (!lockstep_) Map::codegen_declarations(g);
+  }
+
+  void SimdMap::codegen_body(CodeGenerator& g) const {
+    if (!lockstep_) {
+      Map::codegen_body(g);
+      return;
+    }
+    const SXFunction* f = static_cast<const SXFunction*>(f_.get());
+    g.local("i", "casadi_int");
+    g.local("k", "casadi_int");
+    g.local("nb", "casadi_int");
+    g.local("arg1", "const casadi_real*", "*");
+    g.local("res1", "casadi_real*", "*");
+    g << "arg1 = arg+" << n_in_ << ";\n"
+      << "res1 = res+" << n_out_ << ";\n"
+      << "for (i=0; i<" << n_ << "; i+=" << batch_size_ << ") {\n"
+      << "nb = " << n_ << "-i;\n"
+      << "if (nb>" << batch_size_ << ") nb = " << batch_size_ << ";\n";
+    // Buffers pointing to the first instance of the batch
+    for (casadi_int j=0; j<n_in_; ++j) {
+      g << "arg1[" << j << "] = arg[" << j << "] ? "
+        << g.arg(j) << "+i*" << f_.nnz_in(j) << " : 0;\n";
+    }
+    for (casadi_int j=0; j<n_out_; ++j) {
+      g << "res1[" << j << "] = res[" << j << "] ? "
+        << g.res(j) << "+i*" << f_.nnz_out(j) << " : 0;\n";
+    }
+    // Instructions, each applied to the whole batch
+    f->codegen_batch(g, batch_size_);
+    g << "}\n";
+  }
+
+  void SimdMap::serialize_body(SerializingStream &s) const {
+    Map::serialize_body(s);
+    s.version("SimdMap", 1);
+    s.pack("SimdMap::batch_size", batch_size_);
+    s.pack("SimdMap::lockstep", lockstep_);
+  }
+
+  SimdMap::SimdMap(DeserializingStream& s) : Map(s) {
+    s.version("SimdMap", 1);
+    s.unpack("SimdMap::batch_size", batch_size_);
+    s.unpack("SimdMap::lockstep", lockstep_);
   }
 
 } // namespace casadi
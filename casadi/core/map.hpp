@@ -40,7 +40,7 @@ namespace casadi {
   public:
     // Create function (use instead of constructor)
     static Function create(const std::string& parallelization,
-                           const Function& f, casadi_int n);
+                           const Function& f, casadi_int n, const Dict& opts=Dict());
 
     /** \brief Destructor
 
@@ -111,6 +111,11 @@ namespace casadi {
     /// Type of parallellization
     virtual std::string parallelization() const { return "serial"; }
 
+    /// Map a derivative function using the same parallelization
+    virtual Function map_derivative(const Function& df) const {
+      return df.map(n_, parallelization());
+    }
+
     /** \brief  evaluate symbolically while also propagating directional derivatives
 
         \identifier{ha} */
@@ -266,8 +271,8 @@ namespace casadi {
   };
 
   /** A map Evaluate in parallel using std::thread
-      Note: Do not use this class with much more than the intended number of
-      threads for the parallel evaluation as it will cause excessive memory use.
+      The instances are distributed in chunks over a persistent pool of worker threads,
+      work vectors and memory objects are allocated per thread rather than per instance.
 
       \author Joris Gillis
       \date 2018
@@ -276,7 +281,7 @@ namespace casadi {
     friend class Map;
   public:
     // Constructor (protected, use create function in Map)
-    ThreadMap(const std::string& name, const Function& f, casadi_int n) : Map(name, f, n) {}
+    ThreadMap(const std::string& name, const Function& f, casadi_int n);
 
     /** \brief  Destructor
 
@@ -304,16 +309,96 @@ namespace casadi {
     /// Type of parallellization
     std::string parallelization() const override { return "thread"; }
 
+    /// Map a derivative function using the same parallelization
+    Function map_derivative(const Function& df) const override;
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
     /** \brief Generate code for the body of the C function
 
         \identifier{hy} */
     void codegen_body(CodeGenerator& g) const override;
 
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream &s) const override;
+
   protected:
     /** \brief Deserializing constructor
 
         \identifier{hz} */
-    explicit ThreadMap(DeserializingStream& s) : Map(s) {}
+    explicit ThreadMap(DeserializingStream& s);
+
+    // Maximum number of threads used for an evaluation, including the calling thread
+    casadi_int max_num_threads_;
+
+    // Number of instances per scheduled chunk, nonpositive for automatic
+    casadi_int chunk_size_;
+
+    // Number of work vector and memory object slots, min(n_, max_num_threads_)
+    casadi_int n_slots_;
+  };
+
+  /** A map Evaluate in lockstep batches
+      For an SXFunction, the algorithm is traversed once per batch of instances,
+      with the work vector stored structure-of-arrays. This amortizes the
+      instruction dispatch over the batch and allows the compiler to vectorize
+      the inner loops. Other functions are evaluated serially.
+  */
+  class CASADI_EXPORT SimdMap : public Map {
+    friend class Map;
+  public:
+    // Constructor (protected, use create function in Map)
+    SimdMap(const std::string& name, const Function& f, casadi_int n);
+
+    /** \brief  Destructor */
+    ~SimdMap() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override {return "SimdMap";}
+
+    /** \brief Check if the function is of a particular type */
+    bool is_a(const std::string& type, bool recursive) const override;
+
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    /// Type of parallellization
+    std::string parallelization() const override { return "simd"; }
+
+    /// Map a derivative function using the same parallelization
+    Function map_derivative(const Function& df) const override;
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /** \brief Generate code for the declarations of the C function */
+    void codegen_declarations(CodeGenerator& g) const override;
+
+    /** \brief Generate code for the body of the C function */
+    void codegen_body(CodeGenerator& g) const override;
+
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream &s) const override;
+
+  protected:
+    /** \brief Deserializing constructor */
+    explicit SimdMap(DeserializingStream& s);
+
+    // Number of instances evaluated in lockstep
+    casadi_int batch_size_;
+
+    // Is the lockstep evaluation applicable, i.e. is f_ an SXFunction
+    bool lockstep_;
   };
 
 } // namespace casadi
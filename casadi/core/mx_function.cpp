@@ -28,6 +28,7 @@
 #include "global_options.hpp"
 #include "casadi_interrupt.hpp"
 #include "io_instruction.hpp"
+#include "fused_elementwise.hpp"
 #include "serializing_stream.hpp"
 
 #include <stack>
@@ -66,6 +67,10 @@ namespace casadi {
       {"cse",
        {OT_BOOL,
         "Perform common subexpression elimination (complexity is N*log(N) in graph size)"}},
+      {"fuse_elementwise",
+       {OT_BOOL,
+        "Replace chains of unary and binary operations with the same sparsity pattern "
+        "by single operations, evaluated without intermediate vectors (Default: false)"}},
       {"allow_free",
        {OT_BOOL,
         "Allow construction with free variables (Default: false)"}},
@@ -107,6 +112,96 @@ namespace casadi {
     }
   }
 
+  void MXFunction::fuse_elementwise(std::vector<MXNode*>& nodes,
+      std::vector<std::pair<MXNode*, MXNode*> >& fused) {
+    // Place of each node in the sorted graph
+    for (casadi_int i=0; i<nodes.size(); ++i) nodes[i]->temp = i;
+
+    // Group of each elementwise operation, -1 if none
+    std::vector<casadi_int> group(nodes.size(), -1);
+    std::vector<Sparsity> group_sp;
+    std::vector<casadi_int> group_size;
+
+    // Group of all users of a node: -2 if no users (yet), -1 if not a single group
+    std::vector<casadi_int> users(nodes.size(), -2);
+
+    // An operation joins the group of its users, if any, so that its result
+    // is not needed elsewhere. Users are visited before their dependencies.
+    for (casadi_int i=nodes.size()-1; i>=0; --i) {
+      MXNode* n = nodes[i];
+      if ((n->is_unary() || n->is_binary()) && n->nnz()>0) {
+        casadi_int g = users[i];
+        if (g>=0 && n->sparsity()==group_sp[g]) {
+          group[i] = g;
+          group_size[g]++;
+        } else {
+          group[i] = group_sp.size();
+          group_sp.push_back(n->sparsity());
+          group_size.push_back(1);
+        }
+      }
+      for (casadi_int d=0; d<n->n_dep(); ++d) {
+        casadi_int& u = users[n->dep(d)->temp];
+        if (u==-2) {
+          u = group[i];
+        } else if (u!=group[i]) {
+          u = -1;
+        }
+      }
+    }
+
+    // Operations of each group, the last one being the result
+    std::vector<std::vector<casadi_int> > members(group_sp.size());
+    for (casadi_int i=0; i<nodes.size(); ++i) {
+      if (group[i]>=0 && group_size[group[i]]>1) members[group[i]].push_back(i);
+    }
+
+    // Replace each group with a single operation
+    std::vector<casadi_int>& loc = users; // reuse memory
+    std::fill(loc.begin(), loc.end(), -1);
+    std::vector<MXNode*> ret;
+    for (casadi_int i=0; i<nodes.size(); ++i) {
+      casadi_int g = group[i];
+      if (g<0 || group_size[g]==1) {
+        ret.push_back(nodes[i]);
+        continue;
+      }
+      if (i!=members[g].back()) continue;
+
+      // Dependencies from outside the group
+      std::vector<MX> x;
+      for (casadi_int m : members[g]) {
+        for (casadi_int d=0; d<nodes[m]->n_dep(); ++d) {
+          casadi_int j = nodes[m]->dep(d)->temp;
+          if (group[j]!=g && loc[j]<0) {
+            loc[j] = x.size();
+            x.push_back(nodes[m]->dep(d));
+          }
+        }
+      }
+      for (casadi_int k=0; k<members[g].size(); ++k) loc[members[g][k]] = x.size() + k;
+
+      // Operations and their arguments
+      std::vector<casadi_int> op, arg;
+      for (casadi_int m : members[g]) {
+        op.push_back(nodes[m]->op());
+        for (casadi_int d=0; d<2; ++d) {
+          arg.push_back(d<nodes[m]->n_dep() ? loc[nodes[m]->dep(d)->temp] : -1);
+        }
+      }
+      for (const MX& e : x) loc[e->temp] = -1;
+      for (casadi_int m : members[g]) loc[m] = -1;
+
+      MXNode* f = new FusedElementwise(x, group_sp[g], op, arg);
+      fused.push_back(std::make_pair(nodes[i], f));
+      ret.push_back(f);
+    }
+
+    // Reset the temporary variables
+    for (MXNode* n : nodes) n->temp = 0;
+    nodes = ret;
+  }
+
   void MXFunction::init(const Dict& opts) {
     // Call the init function of the base class
     XFunction<MXFunction, MX, MXNode>::init(opts);
@@ -116,6 +211,7 @@ namespace casadi {
     live_variables_ = true;
     print_instructions_ = false;
     bool cse_opt = false;
+    bool fuse_opt = false;
     bool allow_free = false;
 
     // Read options
@@ -128,6 +224,8 @@ namespace casadi {
         print_instructions_ = op.second;
       } else if (op.first=="cse") {
         cse_opt = op.second;
+      } else if (op.first=="fuse_elementwise") {
+        fuse_opt = op.second;
       } else if (op.first=="allow_free") {
         allow_free = op.second;
       }
@@ -165,10 +263,22 @@ namespace casadi {
       }
     }
 
+    // Fuse chains of elementwise operations, keeping track of the replaced operations
+    std::vector<std::pair<MXNode*, MXNode*> > fused;
+    if (fuse_opt) {
+      casadi_int n_nodes = nodes.size();
+      fuse_elementwise(nodes, fused);
+      if (verbose_) {
+        casadi_message("Fused " + str(n_nodes - nodes.size() + fused.size())
+                       + " elementwise operations into " + str(fused.size()));
+      }
+    }
+
     // Set the temporary variables to be the corresponding place in the sorted graph
     for (casadi_int i=0; i<nodes.size(); ++i) {
       nodes[i]->temp = i;
     }
+    for (auto&& f : fused) f.first->temp = f.second->temp;
 
     // Place in the algorithm for each node
     std::vector<casadi_int> place_in_alg;
@@ -364,6 +474,7 @@ namespace casadi {
         nodes[i]->temp = 0;
       }
     }
+    for (auto&& f : fused) f.first->temp = 0;
 
     // Now mark each input's place in the algorithm
     for (auto it=symb_loc.begin(); it!=symb_loc.end(); ++it) {
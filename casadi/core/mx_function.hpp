@@ -106,6 +106,13 @@ namespace casadi {
         \identifier{23} */
     ~MXFunction() override;
 
+    /** \brief Replace chains of elementwise operations with single operations
+
+        The nodes are given in the order of evaluation. Pairs of replaced and
+        new nodes are returned, the absorbed nodes are dropped. */
+    static void fuse_elementwise(std::vector<MXNode*>& nodes,
+                                 std::vector<std::pair<MXNode*, MXNode*> >& fused);
+
     /** \brief  Evaluate numerically, work vectors given
 
         \identifier{24} */
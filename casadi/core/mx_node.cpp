@@ -24,6 +24,7 @@
 
 
 #include "mx_node.hpp"
+#include "node_arena.hpp"
 #include "casadi_misc.hpp"
 #include "transpose.hpp"
 #include "reshape.hpp"
@@ -61,6 +62,7 @@
 #include "bspline.hpp"
 #include "convexify.hpp"
 #include "logsumexp.hpp"
+#include "fused_elementwise.hpp"
 
 // Template implementations
 #include "setnonzeros_impl.hpp"
@@ -79,6 +81,14 @@ namespace casadi {
   }
 
 
+  void* MXNode::operator new(std::size_t sz) {
+    return NodeArena::allocate(sz);
+  }
+
+  void MXNode::operator delete(void* p, std::size_t sz) {
+    NodeArena::deallocate(p, sz);
+  }
+
   MXNode::~MXNode() {
 
     // Start destruction method if any of the dependencies has dependencies
@@ -1244,6 +1254,7 @@ namespace casadi {
     {OP_BSPLINE, BSplineCommon::deserialize},
     {OP_CONVEXIFY, Convexify::deserialize},
     {OP_LOGSUMEXP, LogSumExp::deserialize},
+    {OP_FUSED, FusedElementwise::deserialize},
     {-1, OutputNode::deserialize}
   };
 
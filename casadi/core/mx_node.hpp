@@ -59,6 +59,12 @@ namespace casadi {
         \identifier{1qc} */
     ~MXNode() override=0;
 
+    ///@{
+    /** \brief Allocation, from the active NodeArena if any */
+    static void* operator new(std::size_t sz);
+    static void operator delete(void* p, std::size_t sz);
+    ///@}
+
     /** \brief Check the truth value of this node
 
         \identifier{1qd} */
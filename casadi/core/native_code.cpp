@@ -0,0 +1,508 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "native_code.hpp"
+#include "casadi_misc.hpp"
+
+#include <cstring>
+#include <map>
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#define CASADI_NATIVE_X86_64
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace casadi {
+
+#ifdef CASADI_NATIVE_X86_64
+
+  namespace {
+
+    // Registers holding the arguments of the generated function
+    enum Gpr {RAX=0, RCX=1, RDX=2, RBX=3, RBP=5, RSI=6, RDI=7, R13=13, R14=14};
+
+    // Number of SSE registers
+    const int N_XMM = 16;
+
+    // Fallback for operations without an inline translation
+    void native_generic(int op, const double* x, const double* y, double* f) {
+      casadi_math<double>::fun(static_cast<casadi_int>(op), *x, *y, *f);
+    }
+
+    /* Translation of an algorithm into x86-64 machine code
+
+       Register use: rbx = arg, rbp = res, r13 = w, r14 = constants,
+       rax is scratch. All 16 SSE registers cache elements of w. */
+    class X86Emitter {
+    public:
+      X86Emitter(casadi_int worksize, std::vector<double>& constants)
+        : constants_(constants), slot_reg_(worksize, -1), clock_(0) {
+        for (int r=0; r<N_XMM; ++r) {
+          reg_slot_[r] = -1;
+          reg_dirty_[r] = false;
+          reg_used_[r] = 0;
+          pinned_[r] = false;
+        }
+      }
+
+      std::vector<unsigned char> code;
+
+      void byte(int b) { code.push_back(static_cast<unsigned char>(b));}
+
+      void dword(int32_t v) {
+        for (int k=0; k<4; ++k) byte((v >> (8*k)) & 0xff);
+      }
+
+      void qword(uint64_t v) {
+        for (int k=0; k<8; ++k) byte((v >> (8*k)) & 0xff);
+      }
+
+      // Byte offset of element i, as a 32-bit displacement
+      static int32_t disp(casadi_int i) {
+        casadi_assert(i>=0 && i < (1LL<<28), "Offset out of range");
+        return static_cast<int32_t>(8*i);
+      }
+
+      // Optional REX prefix
+      void rex(bool w, int reg, int rm) {
+        int r = 0x40 | (w ? 8 : 0) | ((reg & 8) ? 4 : 0) | ((rm & 8) ? 1 : 0);
+        if (r!=0x40) byte(r);
+      }
+
+      // ModRM with a register operand
+      void modrm_reg(int reg, int rm) {
+        byte(0xC0 | ((reg & 7) << 3) | (rm & 7));
+      }
+
+      // ModRM with a [base + disp32] memory operand
+      void modrm_mem(int reg, int base, int32_t d) {
+        byte(0x80 | ((reg & 7) << 3) | (base & 7));
+        if ((base & 7)==4) byte(0x24); // SIB needed for rsp/r12
+        dword(d);
+      }
+
+      // SSE instruction, register-register
+      void sse_rr(int prefix, int opcode, int dst, int src) {
+        if (prefix) byte(prefix);
+        rex(false, dst, src);
+        byte(0x0F);
+        byte(opcode);
+        modrm_reg(dst, src);
+      }
+
+      // SSE instruction, register-memory
+      void sse_rm(int prefix, int opcode, int reg, int base, int32_t d) {
+        if (prefix) byte(prefix);
+        rex(false, reg, base);
+        byte(0x0F);
+        byte(opcode);
+        modrm_mem(reg, base, d);
+      }
+
+      // mov r64, [base + disp32]
+      void mov_load(int dst, int base, int32_t d) {
+        rex(true, dst, base);
+        byte(0x8B);
+        modrm_mem(dst, base, d);
+      }
+
+      // mov r64, r64
+      void mov_rr(int dst, int src) {
+        rex(true, src, dst);
+        byte(0x89);
+        modrm_reg(src, dst);
+      }
+
+      // lea r64, [base + disp32]
+      void lea(int dst, int base, int32_t d) {
+        rex(true, dst, base);
+        byte(0x8D);
+        modrm_mem(dst, base, d);
+      }
+
+      // Conditional forward jump on rax==0 over the next n_skip bytes
+      void jump_if_rax_null(int n_skip) {
+        byte(0x48); byte(0x85); byte(0xC0); // test rax, rax
+        byte(0x74); byte(n_skip); // jz rel8
+      }
+
+      // Size of an SSE register-memory instruction with base rax
+      static int sse_rax_size(int reg) { return (reg & 8) ? 9 : 8;}
+
+      void prologue() {
+        byte(0x53); // push rbx
+        byte(0x55); // push rbp
+        byte(0x41); byte(0x55); // push r13
+        byte(0x41); byte(0x56); // push r14
+        byte(0x41); byte(0x57); // push r15, realigns the stack
+        mov_rr(RBX, RDI);
+        mov_rr(RBP, RSI);
+        mov_rr(R13, RDX);
+        mov_rr(R14, RCX);
+      }
+
+      void epilogue() {
+        flush();
+        byte(0x41); byte(0x5F); // pop r15
+        byte(0x41); byte(0x5E); // pop r14
+        byte(0x41); byte(0x5D); // pop r13
+        byte(0x5D); // pop rbp
+        byte(0x5B); // pop rbx
+        byte(0x31); byte(0xC0); // xor eax, eax
+        byte(0xC3); // ret
+      }
+
+      // Index of a constant, reusing identical bit patterns
+      int32_t constant(double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        auto it = const_index_.find(bits);
+        if (it!=const_index_.end()) return it->second;
+        int32_t ind = disp(constants_.size());
+        constants_.push_back(v);
+        const_index_[bits] = ind;
+        return ind;
+      }
+
+      // Constant from a bit pattern
+      int32_t constant_bits(uint64_t bits) {
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return constant(v);
+      }
+
+      // Detach a register from its work vector element, storing if needed
+      void evict(int r) {
+        casadi_int s = reg_slot_[r];
+        if (s>=0) {
+          if (reg_dirty_[r]) sse_rm(0xF2, 0x11, r, R13, disp(s)); // movsd [w+s], r
+          slot_reg_[s] = -1;
+        }
+        reg_slot_[r] = -1;
+        reg_dirty_[r] = false;
+      }
+
+      // Detach a register from its work vector element, value is dead
+      void drop(int r) {
+        casadi_int s = reg_slot_[r];
+        if (s>=0) slot_reg_[s] = -1;
+        reg_slot_[r] = -1;
+        reg_dirty_[r] = false;
+      }
+
+      // Get an unpinned register, evicting the least recently used if needed
+      int alloc() {
+        int best = -1;
+        for (int r=0; r<N_XMM; ++r) {
+          if (pinned_[r]) continue;
+          if (reg_slot_[r]<0) {
+            best = r;
+            break;
+          }
+          if (best<0 || reg_used_[r] < reg_used_[best]) best = r;
+        }
+        casadi_assert_dev(best>=0);
+        evict(best);
+        pin(best);
+        return best;
+      }
+
+      void pin(int r) {
+        pinned_[r] = true;
+        reg_used_[r] = ++clock_;
+      }
+
+      void unpin_all() {
+        for (int r=0; r<N_XMM; ++r) pinned_[r] = false;
+      }
+
+      // Register holding work vector element s, loading it if needed
+      int load(casadi_int s) {
+        int r = slot_reg_[s];
+        if (r<0) {
+          r = alloc();
+          sse_rm(0xF2, 0x10, r, R13, disp(s)); // movsd r, [w+s]
+          reg_slot_[r] = s;
+          slot_reg_[s] = r;
+        }
+        pin(r);
+        return r;
+      }
+
+      // Register r now holds the new value of work vector element s
+      void bind(int r, casadi_int s) {
+        if (slot_reg_[s]>=0 && slot_reg_[s]!=r) drop(slot_reg_[s]);
+        if (reg_slot_[r]>=0 && reg_slot_[r]!=s) drop(r);
+        reg_slot_[r] = s;
+        slot_reg_[s] = r;
+        reg_dirty_[r] = true;
+      }
+
+      // Value in work vector element s is no longer needed
+      void kill(casadi_int s) {
+        if (slot_reg_[s]>=0) drop(slot_reg_[s]);
+      }
+
+      // Write back all registers and forget their contents
+      void flush() {
+        for (int r=0; r<N_XMM; ++r) evict(r);
+      }
+
+      // Load a constant into a fresh register
+      int load_constant(double v) {
+        int r = alloc();
+        if (v==0 && !std::signbit(v)) {
+          sse_rr(0x66, 0x57, r, r); // xorpd r, r
+        } else {
+          sse_rm(0xF2, 0x10, r, R14, constant(v)); // movsd r, [c+k]
+        }
+        return r;
+      }
+
+      // Load a bit mask into a fresh register
+      int load_mask(uint64_t bits) {
+        int r = alloc();
+        sse_rm(0xF2, 0x10, r, R14, constant_bits(bits));
+        return r;
+      }
+
+      // Copy of an operand in a fresh register, or the operand itself if it dies
+      int target(int r, bool dies) {
+        if (dies) {
+          drop(r);
+          return r;
+        }
+        int t = alloc();
+        sse_rr(0x66, 0x28, t, r); // movapd t, r
+        return t;
+      }
+
+      /* Translate an instruction
+         dies1, dies2: operand value is read for the last time */
+      bool emit(const ScalarAtomic& e, bool dies1, bool dies2) {
+        int r1, r2, t, m;
+        switch (e.op) {
+        case OP_CONST:
+          t = load_constant(e.d);
+          bind(t, e.i0);
+          break;
+        case OP_INPUT:
+          t = load_constant(0);
+          mov_load(RAX, RBX, disp(e.i1)); // rax = arg[i1]
+          jump_if_rax_null(sse_rax_size(t));
+          sse_rm(0xF2, 0x10, t, RAX, disp(e.i2)); // movsd t, [rax+i2]
+          bind(t, e.i0);
+          break;
+        case OP_OUTPUT:
+          r1 = load(e.i1);
+          mov_load(RAX, RBP, disp(e.i0)); // rax = res[i0]
+          jump_if_rax_null(sse_rax_size(r1));
+          sse_rm(0xF2, 0x11, r1, RAX, disp(e.i2)); // movsd [rax+i2], r1
+          if (dies1) kill(e.i1);
+          break;
+        case OP_ADD:
+        case OP_SUB:
+        case OP_MUL:
+        case OP_DIV:
+          {
+            int opcode = e.op==OP_ADD ? 0x58 : e.op==OP_SUB ? 0x5C : e.op==OP_MUL ? 0x59 : 0x5E;
+            r1 = load(e.i1);
+            r2 = load(e.i2);
+            t = target(r1, dies1 && e.i1!=e.i2);
+            sse_rr(0xF2, opcode, t, r2);
+            bind(t, e.i0);
+            if (dies2 && e.i2!=e.i0) kill(e.i2);
+          }
+          break;
+        case OP_LT:
+        case OP_LE:
+        case OP_EQ:
+        case OP_NE:
+          {
+            int pred = e.op==OP_EQ ? 0 : e.op==OP_LT ? 1 : e.op==OP_LE ? 2 : 4;
+            r1 = load(e.i1);
+            r2 = load(e.i2);
+            t = target(r1, dies1 && e.i1!=e.i2);
+            sse_rr(0xF2, 0xC2, t, r2); // cmpsd t, r2, pred
+            byte(pred);
+            m = load_constant(1);
+            sse_rr(0x66, 0x54, t, m); // andpd t, 1.0
+            bind(t, e.i0);
+            if (dies2 && e.i2!=e.i0) kill(e.i2);
+          }
+          break;
+        case OP_IF_ELSE_ZERO:
+          r1 = load(e.i1);
+          r2 = load(e.i2);
+          t = target(r1, dies1 && e.i1!=e.i2);
+          m = load_constant(0);
+          sse_rr(0xF2, 0xC2, t, m); // cmpneqsd t, 0
+          byte(4);
+          sse_rr(0x66, 0x54, t, r2); // andpd t, r2
+          bind(t, e.i0);
+          if (dies2 && e.i2!=e.i0) kill(e.i2);
+          break;
+        case OP_ASSIGN:
+        case OP_NEG:
+        case OP_FABS:
+        case OP_SQ:
+        case OP_TWICE:
+          r1 = load(e.i1);
+          t = target(r1, dies1);
+          if (e.op==OP_NEG) {
+            m = load_mask(0x8000000000000000ULL);
+            sse_rr(0x66, 0x57, t, m); // xorpd t, sign
+          } else if (e.op==OP_FABS) {
+            m = load_mask(0x7fffffffffffffffULL);
+            sse_rr(0x66, 0x54, t, m); // andpd t, ~sign
+          } else if (e.op==OP_SQ) {
+            sse_rr(0xF2, 0x59, t, t); // mulsd t, t
+          } else if (e.op==OP_TWICE) {
+            sse_rr(0xF2, 0x58, t, t); // addsd t, t
+          }
+          bind(t, e.i0);
+          break;
+        case OP_SQRT:
+          r1 = load(e.i1);
+          if (dies1) drop(r1);
+          t = alloc();
+          sse_rr(0xF2, 0x51, t, r1); // sqrtsd t, r1
+          bind(t, e.i0);
+          break;
+        case OP_INV:
+          r1 = load(e.i1);
+          if (dies1) drop(r1);
+          t = load_constant(1);
+          sse_rr(0xF2, 0x5E, t, r1); // divsd t, r1
+          bind(t, e.i0);
+          break;
+        default:
+          // Call back into casadi_math with all operands in memory
+          flush();
+          byte(0xBF); dword(static_cast<int32_t>(e.op)); // mov edi, op
+          lea(RSI, R13, disp(e.i1));
+          lea(RDX, R13, disp(e.i2));
+          lea(RCX, R13, disp(e.i0));
+          byte(0x48); byte(0xB8); // mov rax, imm64
+          qword(reinterpret_cast<uint64_t>(&native_generic));
+          byte(0xFF); byte(0xD0); // call rax
+          unpin_all();
+          return false;
+        }
+        unpin_all();
+        return true;
+      }
+
+    private:
+      std::vector<double>& constants_;
+      std::map<uint64_t, int32_t> const_index_;
+      std::vector<int> slot_reg_;
+      casadi_int reg_slot_[N_XMM];
+      bool reg_dirty_[N_XMM];
+      casadi_int reg_used_[N_XMM];
+      bool pinned_[N_XMM];
+      casadi_int clock_;
+    };
+
+  } // namespace
+
+  bool NativeCode::is_supported() {
+    return true;
+  }
+
+  NativeCode::NativeCode(const std::vector<ScalarAtomic>& algorithm, casadi_int worksize)
+      : fcn_(nullptr), mem_(nullptr), size_(0), n_generic_(0) {
+    // Determine, for each instruction, which operands are read for the last time
+    std::vector<bool> live(worksize, false), dies1(algorithm.size()), dies2(algorithm.size());
+    for (casadi_int k=algorithm.size()-1; k>=0; --k) {
+      const ScalarAtomic& e = algorithm[k];
+      switch (e.op) {
+      case OP_CONST:
+      case OP_INPUT:
+        live[e.i0] = false;
+        break;
+      case OP_OUTPUT:
+        dies1[k] = !live[e.i1];
+        live[e.i1] = true;
+        break;
+      default:
+        live[e.i0] = false;
+        if (casadi_math<double>::ndeps(e.op)==2) {
+          dies2[k] = !live[e.i2];
+          live[e.i2] = true;
+        }
+        dies1[k] = !live[e.i1];
+        live[e.i1] = true;
+      }
+    }
+
+    // Translate
+    X86Emitter x(worksize, constants_);
+    x.prologue();
+    for (casadi_int k=0; k<algorithm.size(); ++k) {
+      if (!x.emit(algorithm[k], dies1[k], dies2[k])) n_generic_++;
+    }
+    x.epilogue();
+
+    // Copy to executable memory
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_ = x.code.size();
+    size_t len = ((size_ + page - 1) / page) * page;
+    mem_ = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    casadi_assert(mem_!=MAP_FAILED, "Failed to allocate memory for native code");
+    std::memcpy(mem_, x.code.data(), size_);
+    if (mprotect(mem_, len, PROT_READ | PROT_EXEC)) {
+      munmap(mem_, len);
+      mem_ = nullptr;
+      casadi_error("Failed to make native code executable");
+    }
+    fcn_ = reinterpret_cast<Fcn>(mem_);
+  }
+
+  NativeCode::~NativeCode() {
+    if (mem_) {
+      size_t page = sysconf(_SC_PAGESIZE);
+      munmap(mem_, ((size_ + page - 1) / page) * page);
+    }
+  }
+
+#else // CASADI_NATIVE_X86_64
+
+  bool NativeCode::is_supported() {
+    return false;
+  }
+
+  NativeCode::NativeCode(const std::vector<ScalarAtomic>& algorithm, casadi_int worksize)
+      : fcn_(nullptr), mem_(nullptr), size_(0), n_generic_(0) {
+    casadi_error("Native code generation is not supported on this platform");
+  }
+
+  NativeCode::~NativeCode() {
+  }
+
+#endif // CASADI_NATIVE_X86_64
+
+} // namespace casadi
@@ -0,0 +1,97 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_NATIVE_CODE_HPP
+#define CASADI_NATIVE_CODE_HPP
+
+#include "sx_function.hpp"
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Machine code translation of an SXFunction algorithm
+
+      The algorithm is translated in-process, without any external compiler,
+      into machine code placed in executable memory. Work vector elements are
+      cached in floating point registers with least-recently-used eviction;
+      values are only written back to the work vector when evicted while still
+      live. Arithmetic, comparisons, square roots and absolute values are
+      emitted inline, all other operations call back into casadi_math.
+
+      Currently implemented for x86-64 with the System V calling convention
+      (Linux, macOS, BSD). On other targets, is_supported() returns false.
+  */
+  class CASADI_EXPORT NativeCode {
+  public:
+    /// Signature of the generated code
+    typedef int (*Fcn)(const double** arg, double** res, double* w, const double* c);
+
+    /** \brief Translate an algorithm
+
+        \param algorithm Instructions, as in SXFunction::algorithm_
+        \param worksize Length of the work vector */
+    NativeCode(const std::vector<ScalarAtomic>& algorithm, casadi_int worksize);
+
+    /// Destructor, releases the executable memory
+    ~NativeCode();
+
+    /// Is native code generation available on this platform
+    static bool is_supported();
+
+    /// Evaluate
+    int operator()(const double** arg, double** res, double* w) const {
+      return fcn_(arg, res, w, get_ptr(constants_));
+    }
+
+    /// Size of the generated machine code, in bytes
+    size_t size() const { return size_;}
+
+    /// Number of instructions evaluated by a call back into casadi_math
+    casadi_int n_generic() const { return n_generic_;}
+
+  private:
+    // Not copyable
+    NativeCode(const NativeCode&) = delete;
+    NativeCode& operator=(const NativeCode&) = delete;
+
+    /// Entry point
+    Fcn fcn_;
+
+    /// Executable memory, including size
+    void* mem_;
+    size_t size_;
+
+    /// Constants referred to by the code
+    std::vector<double> constants_;
+
+    /// Number of instructions evaluated by a call back into casadi_math
+    casadi_int n_generic_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_NATIVE_CODE_HPP
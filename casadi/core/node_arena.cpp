@@ -0,0 +1,229 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "node_arena.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <unordered_map>
+
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif //CASADI_WITH_THREAD
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif // _WIN32
+
+namespace casadi {
+
+  /// \cond INTERNAL
+  /** \brief Slab allocator behind a NodeArena
+
+      Memory is handed out from blocks aligned to their size, so that the block
+      of a node follows from its address. Freed nodes are kept in one free list
+      per size class.
+  */
+  class NodePool {
+  public:
+    // Granularity of the size classes, enough for any node member
+    static const size_t align = 16;
+
+    // Largest node allocated from the pool
+    static const size_t max_size = 512;
+
+    // Block size, a power of two
+    static const size_t block_size = 1<<20;
+
+    NodePool();
+    ~NodePool();
+
+    // Allocate a node, nullptr if too large
+    void* allocate(size_t sz);
+
+    // Return a node to its free list
+    void deallocate(void* p, size_t sz);
+
+    // Pool owning an address, if any
+    static NodePool* find(void* p);
+
+    // Blocks allocated
+    std::vector<void*> blocks_;
+
+    // Unused part of the current block
+    char *next_, *end_;
+
+    // Free lists per size class
+    std::vector<void*> free_;
+
+    // The scope has ended, delete when the last node is freed
+    bool closed_;
+
+    // Statistics
+    casadi_int n_node_, n_alloc_, bytes_, n_heap_;
+  };
+
+  // Blocks of all pools, by address
+  static std::unordered_map<uintptr_t, NodePool*> node_blocks;
+  static std::atomic<casadi_int> n_node_blocks(0);
+#ifdef CASADI_WITH_THREAD
+  static std::mutex node_blocks_mtx;
+#endif //CASADI_WITH_THREAD
+
+  // Active pool in this thread
+  static thread_local NodePool* node_pool = nullptr;
+
+  NodePool::NodePool() : next_(nullptr), end_(nullptr), free_(max_size/align + 1, nullptr),
+      closed_(false), n_node_(0), n_alloc_(0), bytes_(0), n_heap_(0) {
+  }
+
+  NodePool::~NodePool() {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(node_blocks_mtx);
+#endif //CASADI_WITH_THREAD
+    for (void* b : blocks_) {
+      node_blocks.erase(reinterpret_cast<uintptr_t>(b));
+#ifdef _WIN32
+      _aligned_free(b);
+#else // _WIN32
+      free(b);
+#endif // _WIN32
+    }
+    n_node_blocks -= blocks_.size();
+  }
+
+  void* NodePool::allocate(size_t sz) {
+    // Size class
+    size_t c = (sz + align - 1) / align;
+    if (c*align > max_size) return nullptr;
+    n_node_++;
+    n_alloc_++;
+    bytes_ += c*align;
+    // Recycle a freed node
+    void* p = free_[c];
+    if (p) {
+      free_[c] = *static_cast<void**>(p);
+      return p;
+    }
+    // New block
+    if (next_ + c*align > end_) {
+      void* b = nullptr;
+#ifdef _WIN32
+      b = _aligned_malloc(block_size, block_size);
+#else // _WIN32
+      if (posix_memalign(&b, block_size, block_size)) b = nullptr;
+#endif // _WIN32
+      if (b==nullptr) throw std::bad_alloc();
+      {
+#ifdef CASADI_WITH_THREAD
+        std::lock_guard<std::mutex> lock(node_blocks_mtx);
+#endif //CASADI_WITH_THREAD
+        node_blocks[reinterpret_cast<uintptr_t>(b)] = this;
+      }
+      n_node_blocks++;
+      blocks_.push_back(b);
+      next_ = static_cast<char*>(b);
+      end_ = next_ + block_size;
+    }
+    p = next_;
+    next_ += c*align;
+    return p;
+  }
+
+  void NodePool::deallocate(void* p, size_t sz) {
+    size_t c = (sz + align - 1) / align;
+    *static_cast<void**>(p) = free_[c];
+    free_[c] = p;
+    n_node_--;
+    bytes_ -= c*align;
+  }
+
+  NodePool* NodePool::find(void* p) {
+    // Quick return if no arena is in use
+    if (n_node_blocks==0) return nullptr;
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(node_blocks_mtx);
+#endif //CASADI_WITH_THREAD
+    auto it = node_blocks.find(reinterpret_cast<uintptr_t>(p) & ~uintptr_t(block_size - 1));
+    return it==node_blocks.end() ? nullptr : it->second;
+  }
+  /// \endcond
+
+  NodeArena::NodeArena() {
+    pool_ = new NodePool();
+    previous_ = node_pool;
+    node_pool = pool_;
+  }
+
+  NodeArena::~NodeArena() {
+    node_pool = previous_;
+    if (pool_->n_node_==0) {
+      delete pool_;
+    } else {
+      pool_->closed_ = true;
+    }
+  }
+
+  Dict NodeArena::stats() const {
+    Dict ret;
+    ret["n_node"] = pool_->n_node_;
+    ret["n_alloc"] = pool_->n_alloc_;
+    ret["bytes"] = pool_->bytes_;
+    ret["bytes_reserved"] = static_cast<casadi_int>(pool_->blocks_.size()*NodePool::block_size);
+    ret["n_block"] = static_cast<casadi_int>(pool_->blocks_.size());
+    ret["n_heap"] = pool_->n_heap_;
+    return ret;
+  }
+
+  bool NodeArena::is_active() {
+    return node_pool!=nullptr;
+  }
+
+  void* NodeArena::allocate(size_t sz) {
+    if (node_pool) {
+      void* p = node_pool->allocate(sz);
+      if (p) return p;
+      node_pool->n_heap_++;
+    }
+    return ::operator new(sz);
+  }
+
+  void NodeArena::deallocate(void* p, size_t sz) {
+    NodePool* pool = NodePool::find(p);
+    if (pool) {
+      pool->deallocate(p, sz);
+      // Bulk release
+      if (pool->closed_ && pool->n_node_==0) delete pool;
+    } else {
+      ::operator delete(p);
+    }
+  }
+
+} // namespace casadi
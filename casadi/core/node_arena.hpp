@@ -0,0 +1,99 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_NODE_ARENA_HPP
+#define CASADI_NODE_ARENA_HPP
+
+#include "generic_type.hpp"
+
+namespace casadi {
+
+  /// \cond INTERNAL
+  class NodePool;
+  /// \endcond
+
+  /** \brief Scoped slab allocation of expression graph nodes
+
+      While an instance is alive, the nodes of SX and MX expressions created
+      (in the same thread) are carved out of large blocks owned by the arena
+      instead of being allocated one by one from the heap. Nodes freed during the
+      scope are recycled. The blocks are released all at once when the last node
+      allocated from the arena dies, which may be after the end of the scope.
+
+      Arenas can be nested, the innermost one is used. Like the expressions
+      themselves, an arena must not be shared between threads.
+
+      \code
+      {
+        NodeArena arena;
+        SX x = SX::sym("x", 1000);
+        ...
+        Function f("f", {x}, {...});
+      } // graph nodes released in bulk with the last reference
+      \endcode
+  */
+  class CASADI_EXPORT NodeArena {
+  public:
+    /// Start allocating nodes from a new arena
+    NodeArena();
+
+    /// Stop allocating from the arena
+    ~NodeArena();
+
+    /** \brief Allocation statistics
+
+        n_node: live nodes, n_alloc: nodes allocated in total,
+        bytes: bytes in live nodes, bytes_reserved: bytes in blocks,
+        n_block: number of blocks, n_heap: nodes too large for the arena */
+    Dict stats() const;
+
+    /// Is an arena active in this thread?
+    static bool is_active();
+
+#ifndef SWIG
+    /// \cond INTERNAL
+    /// Allocate a node, from the active arena if any
+    static void* allocate(size_t sz);
+
+    /// Free a node, returning it to its arena if any
+    static void deallocate(void* p, size_t sz);
+    /// \endcond
+#endif // SWIG
+
+  private:
+    // Not copyable
+    NodeArena(const NodeArena&);
+    NodeArena& operator=(const NodeArena&);
+
+    // Pool, may outlive the scope
+    NodePool* pool_;
+
+    // Enclosing pool
+    NodePool* previous_;
+  };
+
+} // namespace casadi
+
+#endif // CASADI_NODE_ARENA_HPP
@@ -424,8 +424,7 @@ void OracleFunction::jit_dependencies(const std::string& fname) {
   if (compiler_.is_null()) {
     if (verbose_) casadi_message("compiling to "+ fname+"'.");
     // JIT dependent functions
-    compiler_ = Importer(generate_dependencies(fname, Dict()),
-                        compiler_plugin_, jit_options_);
+    compiler_ = jit_compile({generate_dependencies(fname, Dict())});
   }
   // Replace the Oracle functions with generated functions
   for (auto&& e : all_functions_) {
@@ -20,6 +20,7 @@
 
 // C-REPLACE "fmin" "casadi_fmin"
 // C-REPLACE "fmax" "casadi_fmax"
+// C-REPLACE "std::sqrt" "sqrt"
 // C-REPLACE "std::numeric_limits<T1>::min()" "casadi_real_min"
 // C-REPLACE "std::numeric_limits<T1>::infinity()" "casadi_inf"
 // C-REPLACE "static_cast<int>" "(int) "
@@ -72,7 +73,7 @@ typedef enum {
   IPQP_FACTOR,
   IPQP_SOLVE} casadi_ipqp_task_t;
 
-// SYMBOL "ipqp_task_t"
+// SYMBOL "ipqp_next_t"
 typedef enum {
   IPQP_RESET,
   IPQP_RESIDUAL,
@@ -132,6 +133,8 @@ struct casadi_ipqp_data {
   T1* S;
   // Inverse of margin to bounds (0 if no bound)
   T1 *dinv_lbz, *dinv_ubz;
+  // Warm start from z, lam, lam_lbz and lam_ubz, e.g. the solution of a previous solve
+  int warm;
 };
 // C-REPLACE "casadi_ipqp_data<T1>" "struct casadi_ipqp_data"
 
@@ -187,6 +190,7 @@ void casadi_ipqp_init(casadi_ipqp_data<T1>* d, casadi_int** iw, T1** w) {
   d->dinv_ubz = *w; *w += p->nz;
   // New QP
   d->next = IPQP_RESET;
+  d->warm = 0;
 }
 
 // SYMBOL "ipqp_bounds"
@@ -226,12 +230,14 @@ void casadi_ipqp_reset(casadi_ipqp_data<T1>* d) {
   casadi_int k;
   T1 margin, mid;
   const casadi_ipqp_prob<T1>* p = d->prob;
-  // Required margin to constraints
-  margin = .1;
+  // Required margin to constraints, smaller when warm starting
+  margin = d->warm ? .01 : .1;
   // Reset constraint count
   d->n_con = 0;
-  // Initialize constraints to zero
-  for (k = p->nx; k < p->nz; ++k) d->z[k] = 0;
+  // Initialize constraints to zero, unless warm starting
+  if (!d->warm) {
+    for (k = p->nx; k < p->nz; ++k) d->z[k] = 0;
+  }
   // Find interior point
   for (k = 0; k < p->nz; ++k) {
     if (d->lbz[k] > -p->inf) {
@@ -245,21 +251,21 @@ void casadi_ipqp_reset(casadi_ipqp_data<T1>* d) {
           d->z[k] = fmax(fmin(d->z[k], d->ubz[k] - margin), mid);
         }
         if (d->ubz[k] > d->lbz[k] + p->dmin) {
-          d->lam_lbz[k] = 1;
-          d->lam_ubz[k] = 1;
+          d->lam_lbz[k] = d->warm ? fmax(d->lam_lbz[k], margin) : 1;
+          d->lam_ubz[k] = d->warm ? fmax(d->lam_ubz[k], margin) : 1;
           d->n_con += 2;
         }
       } else {
         // Only lower bound
         d->z[k] = fmax(d->z[k], d->lbz[k] + margin);
-        d->lam_lbz[k] = 1;
+        d->lam_lbz[k] = d->warm ? fmax(d->lam_lbz[k], margin) : 1;
         d->n_con++;
       }
     } else {
       if (d->ubz[k] < p->inf) {
         // Only upper bound
         d->z[k] = fmin(d->z[k], d->ubz[k] - margin);
-        d->lam_ubz[k] = 1;
+        d->lam_ubz[k] = d->warm ? fmax(d->lam_ubz[k], margin) : 1;
         d->n_con++;
       }
     }
@@ -532,47 +538,6 @@ int casadi_ipqp_maxstep(casadi_ipqp_data<T1>* d, T1* alpha, casadi_int* ind) {
   return flag;
 }
 
-// SYMBOL "ipqp_predictor"
-template<typename T1>
-void casadi_ipqp_predictor(casadi_ipqp_data<T1>* d) {
-  // Local variables
-  casadi_int k;
-  T1 t, alpha, sigma;
-  const casadi_ipqp_prob<T1>* p = d->prob;
-  // Scale results
-  for (k=0; k<p->nz; ++k) d->dz[k] *= d->S[k];
-  // Calculate step in z(g), lam(g)
-  for (k=p->nx; k<p->nz; ++k) {
-    if (d->S[k] == 0.) {
-      // Eliminate
-      d->dlam[k] = d->dz[k] = 0;
-    } else {
-      t = d->D[k] / (d->S[k] * d->S[k]) * (d->dz[k] - d->dlam[k]);
-      d->dlam[k] = d->dz[k];
-      d->dz[k] = t;
-    }
-  }
-  // Finish calculation in dlam_lbz, dlam_ubz
-  for (k=0; k<p->nz; ++k) {
-    d->dlam_lbz[k] -= d->lam_lbz[k] * d->dz[k];
-    d->dlam_lbz[k] *= d->dinv_lbz[k];
-  }
-  for (k=0; k<p->nz; ++k) {
-    d->dlam_ubz[k] += d->lam_ubz[k] * d->dz[k];
-    d->dlam_ubz[k] *= d->dinv_ubz[k];
-  }
-  // Finish calculation of dlam(x)
-  for (k=0; k<p->nx; ++k) d->dlam[k] += d->dlam_ubz[k] - d->dlam_lbz[k];
-  // Maximum primal and dual step
-  (void)casadi_ipqp_maxstep(d, &alpha, 0);
-  // Calculate sigma
-  sigma = casadi_ipqp_sigma(d, alpha);
-  // Prepare corrector step
-  casadi_ipqp_corrector_prepare(d, -sigma * d->mu);
-  // Solve to get step
-  d->linsys = d->rz;
-}
-
 // SYMBOL "ipqp_step"
 template<typename T1>
 void casadi_ipqp_step(casadi_ipqp_data<T1>* d, T1 alpha_pr, T1 alpha_du) {
@@ -657,6 +622,47 @@ void casadi_ipqp_corrector_prepare(casadi_ipqp_data<T1>* d, T1 shift) {
   for (k=0; k<p->nz; ++k) d->rz[k] *= -d->S[k];
 }
 
+// SYMBOL "ipqp_predictor"
+template<typename T1>
+void casadi_ipqp_predictor(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int k;
+  T1 t, alpha, sigma;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Scale results
+  for (k=0; k<p->nz; ++k) d->dz[k] *= d->S[k];
+  // Calculate step in z(g), lam(g)
+  for (k=p->nx; k<p->nz; ++k) {
+    if (d->S[k] == 0.) {
+      // Eliminate
+      d->dlam[k] = d->dz[k] = 0;
+    } else {
+      t = d->D[k] / (d->S[k] * d->S[k]) * (d->dz[k] - d->dlam[k]);
+      d->dlam[k] = d->dz[k];
+      d->dz[k] = t;
+    }
+  }
+  // Finish calculation in dlam_lbz, dlam_ubz
+  for (k=0; k<p->nz; ++k) {
+    d->dlam_lbz[k] -= d->lam_lbz[k] * d->dz[k];
+    d->dlam_lbz[k] *= d->dinv_lbz[k];
+  }
+  for (k=0; k<p->nz; ++k) {
+    d->dlam_ubz[k] += d->lam_ubz[k] * d->dz[k];
+    d->dlam_ubz[k] *= d->dinv_ubz[k];
+  }
+  // Finish calculation of dlam(x)
+  for (k=0; k<p->nx; ++k) d->dlam[k] += d->dlam_ubz[k] - d->dlam_lbz[k];
+  // Maximum primal and dual step
+  (void)casadi_ipqp_maxstep(d, &alpha, 0);
+  // Calculate sigma
+  sigma = casadi_ipqp_sigma(d, alpha);
+  // Prepare corrector step
+  casadi_ipqp_corrector_prepare(d, -sigma * d->mu);
+  // Solve to get step
+  d->linsys = d->rz;
+}
+
 // SYMBOL "ipqp_corrector"
 template<typename T1>
 void casadi_ipqp_corrector(casadi_ipqp_data<T1>* d) {
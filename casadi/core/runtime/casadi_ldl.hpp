@@ -17,6 +17,41 @@
 //    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //
 
+// SYMBOL "ldl_col"
+// Calculate column c of the transposed L factor and D in casadi_ldl
+// The columns it depends on, its descendants in the elimination tree, must have been calculated
+// len[w] >= n, zero on entry and exit
+template<typename T1>
+void casadi_ldl_col(const casadi_int* sp_a, const T1* a,
+                    const casadi_int* sp_lt, T1* lt, T1* d, const casadi_int* p, casadi_int c,
+                    T1* w) {
+  const casadi_int *lt_colind, *lt_row, *a_colind, *a_row;
+  casadi_int n, r, c1, k, k2;
+  // Extract sparsities
+  n=sp_lt[1];
+  lt_colind=sp_lt+2; lt_row=sp_lt+2+n+1;
+  a_colind=sp_a+2; a_row=sp_a+2+n+1;
+  // Sparse copy of A to L and D
+  c1 = p[c];
+  for (k=a_colind[c1]; k<a_colind[c1+1]; ++k) w[a_row[k]] = a[k];
+  for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) lt[k] = w[p[lt_row[k]]];
+  d[c] = w[p[c]];
+  for (k=a_colind[c1]; k<a_colind[c1+1]; ++k) w[a_row[k]] = 0;
+  // Calculate l(r,c) with r<c
+  for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) {
+    r = lt_row[k];
+    for (k2=lt_colind[r]; k2<lt_colind[r+1]; ++k2) {
+      lt[k] -= lt[k2] * w[lt_row[k2]];
+    }
+    w[r] = lt[k];
+    lt[k] /= d[r];
+    // Update d(c)
+    d[c] -= w[r]*lt[k];
+  }
+  // Clear w
+  for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) w[lt_row[k]] = 0;
+}
+
 // SYMBOL "ldl"
 // Calculate the nonzeros of the transposed L factor (strictly lower entries only)
 // as well as D for an LDL^T factorization
@@ -24,38 +59,142 @@
 template<typename T1>
 void casadi_ldl(const casadi_int* sp_a, const T1* a,
                 const casadi_int* sp_lt, T1* lt, T1* d, const casadi_int* p, T1* w) {
-  const casadi_int *lt_colind, *lt_row, *a_colind, *a_row;
-  casadi_int n, r, c, c1, k, k2;
-  // Extract sparsities
+  casadi_int n, c;
   n=sp_lt[1];
-  lt_colind=sp_lt+2; lt_row=sp_lt+2+n+1;
-  a_colind=sp_a+2; a_row=sp_a+2+n+1;
   // Clear w
-  for (r=0; r<n; ++r) w[r] = 0;
-  // Sparse copy of A to L and D
-  for (c=0; c<n; ++c) {
-    c1 = p[c];
-    for (k=a_colind[c1]; k<a_colind[c1+1]; ++k) w[a_row[k]] = a[k];
-    for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) lt[k] = w[p[lt_row[k]]];
-    d[c] = w[p[c]];
-    for (k=a_colind[c1]; k<a_colind[c1+1]; ++k) w[a_row[k]] = 0;
-  }
+  for (c=0; c<n; ++c) w[c] = 0;
   // Loop over columns of L
-  for (c=0; c<n; ++c) {
-    for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) {
-      r = lt_row[k];
-      // Calculate l(r,c) with r<c
-      for (k2=lt_colind[r]; k2<lt_colind[r+1]; ++k2) {
-        lt[k] -= lt[k2] * w[lt_row[k2]];
+  for (c=0; c<n; ++c) casadi_ldl_col(sp_a, a, sp_lt, lt, d, p, c, w);
+}
+
+// SYMBOL "ldl_sn"
+// Supernodal variant of casadi_ldl, with the same output
+// Supernodes are factorized as dense column-major blocks in ls, len[ls] >= sn[4+3*sn[1]]
+// sn: n, number of supernodes ns, first column (ns+1), row offsets (ns+1), block offsets (ns+1),
+//     rows of each supernode, supernode of each column (n), block offset of each nonzero
+//     of A (-1 if unused), block offset of each nonzero of L^T
+// Dense kernels work on four columns at a time
+// len[iw] >= n + 3*ns, len[w] >= 4*n
+template<typename T1>
+void casadi_ldl_sn(const casadi_int* sp_a, const T1* a, const casadi_int* sp_lt, T1* lt, T1* d,
+                   const casadi_int* sn, T1* ls, casadi_int* iw, T1* w) {
+  const casadi_int *super, *rowptr, *lsptr, *rows, *snode, *amap, *ltmap, *krows;
+  casadi_int n, ns, j, s, s_next, f, nc, h, kh, kw, p0, p1, nr, nt, nb, q, t, k, c, i;
+  casadi_int *relmap, *head, *next, *pos;
+  T1 *lj, *ks, *kc, *col, *dst, sc, s0, s1, s2, s3, v;
+  // Extract symbolic factorization
+  n = sn[0]; ns = sn[1];
+  super = sn+2; rowptr = super+ns+1; lsptr = rowptr+ns+1; rows = lsptr+ns+1;
+  snode = rows+rowptr[ns]; amap = snode+n; ltmap = amap+sp_a[2+sp_a[1]];
+  // Partition work vector
+  relmap = iw; head = iw+n; next = head+ns; pos = next+ns;
+  // Sparse copy of A to the supernodes
+  for (k=0; k<lsptr[ns]; ++k) ls[k] = 0;
+  for (k=0; k<sp_a[2+sp_a[1]]; ++k) if (amap[k]>=0) ls[amap[k]] = a[k];
+  // No pending updates
+  for (s=0; s<ns; ++s) head[s] = -1;
+  // Loop over supernodes
+  for (j=0; j<ns; ++j) {
+    f = super[j]; nc = super[j+1]-f; h = rowptr[j+1]-rowptr[j];
+    lj = ls+lsptr[j];
+    // Local index of each row of the supernode
+    for (i=0; i<h; ++i) relmap[rows[rowptr[j]+i]] = i;
+    // Updates from earlier supernodes with nonzeros in the columns of j
+    for (s=head[j]; s>=0; s=s_next) {
+      s_next = next[s];
+      ks = ls+lsptr[s]; krows = rows+rowptr[s];
+      kh = rowptr[s+1]-rowptr[s]; kw = super[s+1]-super[s];
+      // Rows of s in the columns of j (nr) and below (nt)
+      p0 = pos[s];
+      for (p1=p0; p1<kh && krows[p1]<f+nc; ++p1) {}
+      nr = p1-p0; nt = kh-p0;
+      // Subtract L_s D_s L_s^T, nb columns at a time
+      for (q=0; q<nr; q+=nb) {
+        nb = nr-q<4 ? nr-q : 4;
+        for (i=0; i<nb*nt; ++i) w[i] = 0;
+        for (k=0; k<kw; ++k) {
+          kc = ks+p0+k*kh;
+          if (nb==4) {
+            s0 = kc[q]*d[super[s]+k];
+            s1 = kc[q+1]*d[super[s]+k];
+            s2 = kc[q+2]*d[super[s]+k];
+            s3 = kc[q+3]*d[super[s]+k];
+            for (t=q; t<nt; ++t) {
+              v = kc[t];
+              w[t] += s0*v;
+              w[t+nt] += s1*v;
+              w[t+2*nt] += s2*v;
+              w[t+3*nt] += s3*v;
+            }
+          } else {
+            for (i=0; i<nb; ++i) {
+              sc = kc[q+i]*d[super[s]+k];
+              for (t=q+i; t<nt; ++t) w[t+i*nt] += sc*kc[t];
+            }
+          }
+        }
+        for (i=0; i<nb; ++i) {
+          dst = lj+(krows[p0+q+i]-f)*h;
+          for (t=q+i; t<nt; ++t) dst[relmap[krows[p0+t]]] -= w[t+i*nt];
+        }
+      }
+      // Queue for the next supernode it updates
+      pos[s] = p1;
+      if (p1<kh) {
+        k = snode[krows[p1]];
+        next[s] = head[k];
+        head[k] = s;
       }
-      w[r] = lt[k];
-      lt[k] /= d[r];
-      // Update d(c)
-      d[c] -= w[r]*lt[k];
     }
-    // Clear w
-    for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) w[lt_row[k]] = 0;
+    // Dense factorization of the supernode, nb columns at a time
+    for (c=0; c<nc; c+=nb) {
+      nb = nc-c<4 ? nc-c : 4;
+      // Update with the columns to the left
+      for (k=0; k<c; ++k) {
+        kc = lj+k*h;
+        if (nb==4) {
+          s0 = kc[c]*d[f+k];
+          s1 = kc[c+1]*d[f+k];
+          s2 = kc[c+2]*d[f+k];
+          s3 = kc[c+3]*d[f+k];
+          col = lj+c*h;
+          for (i=c; i<h; ++i) {
+            v = kc[i];
+            col[i] -= s0*v;
+            col[i+h] -= s1*v;
+            col[i+2*h] -= s2*v;
+            col[i+3*h] -= s3*v;
+          }
+        } else {
+          for (q=0; q<nb; ++q) {
+            sc = kc[c+q]*d[f+k];
+            col = lj+(c+q)*h;
+            for (i=c+q; i<h; ++i) col[i] -= sc*kc[i];
+          }
+        }
+      }
+      // Factorize the columns
+      for (q=c; q<c+nb; ++q) {
+        col = lj+q*h;
+        for (k=c; k<q; ++k) {
+          sc = lj[q+k*h]*d[f+k];
+          kc = lj+k*h;
+          for (i=q; i<h; ++i) col[i] -= sc*kc[i];
+        }
+        d[f+q] = col[q];
+        for (i=q+1; i<h; ++i) col[i] /= d[f+q];
+      }
+    }
+    // Queue for the first supernode it updates
+    if (nc<h) {
+      pos[j] = nc;
+      k = snode[rows[rowptr[j]+nc]];
+      next[j] = head[k];
+      head[k] = j;
+    }
   }
+  // Strictly lower entries in the layout of casadi_ldl
+  for (k=0; k<sp_lt[2+sp_lt[1]]; ++k) lt[k] = ls[ltmap[k]];
 }
 
 // SYMBOL "ldl_trs"
@@ -107,3 +246,91 @@ void casadi_ldl_solve(T1* x, casadi_int nrhs, const casadi_int* sp_lt, const T1*
     x += n;
   }
 }
+
+// SYMBOL "ldl_trs_blk"
+// Solve for (I+R) with R an optionally transposed strictly upper triangular matrix,
+// nb right-hand sides stored interleaved: x[i*nb+j] is entry i of right-hand side j
+template<typename T1>
+void casadi_ldl_trs_blk(const casadi_int* sp_r, const T1* nz_r, T1* x, casadi_int nb,
+                        casadi_int tr) {
+  casadi_int ncol, c, k, j;
+  const casadi_int *colind, *row;
+  T1 r, s0, s1, s2, s3;
+  T1 *xc, *xr;
+  // Extract sparsity
+  ncol=sp_r[1];
+  colind=sp_r+2; row=sp_r+2+ncol+1;
+  if (tr) {
+    // Forward substitution
+    for (c=0; c<ncol; ++c) {
+      xc = x + c*nb;
+      // Four right-hand sides at a time, accumulating in registers
+      for (j=0; j+4<=nb; j+=4) {
+        s0 = xc[j]; s1 = xc[j+1]; s2 = xc[j+2]; s3 = xc[j+3];
+        for (k=colind[c]; k<colind[c+1]; ++k) {
+          r = nz_r[k];
+          xr = x + row[k]*nb + j;
+          s0 -= r*xr[0]; s1 -= r*xr[1]; s2 -= r*xr[2]; s3 -= r*xr[3];
+        }
+        xc[j] = s0; xc[j+1] = s1; xc[j+2] = s2; xc[j+3] = s3;
+      }
+      // Remainder
+      for (; j<nb; ++j) {
+        s0 = xc[j];
+        for (k=colind[c]; k<colind[c+1]; ++k) s0 -= nz_r[k]*x[row[k]*nb + j];
+        xc[j] = s0;
+      }
+    }
+  } else {
+    // Backward substitution
+    for (c=ncol-1; c>=0; --c) {
+      xc = x + c*nb;
+      for (j=0; j+4<=nb; j+=4) {
+        s0 = xc[j]; s1 = xc[j+1]; s2 = xc[j+2]; s3 = xc[j+3];
+        for (k=colind[c+1]-1; k>=colind[c]; --k) {
+          r = nz_r[k];
+          xr = x + row[k]*nb + j;
+          xr[0] -= r*s0; xr[1] -= r*s1; xr[2] -= r*s2; xr[3] -= r*s3;
+        }
+      }
+      for (; j<nb; ++j) {
+        s0 = xc[j];
+        for (k=colind[c+1]-1; k>=colind[c]; --k) x[row[k]*nb + j] -= nz_r[k]*s0;
+      }
+    }
+  }
+}
+
+// SYMBOL "ldl_solve_blk"
+// Linear solve using an LDL^T factorized linear system,
+// processing up to nb right-hand sides per pass over the factor
+// len[w] >= nb*n
+template<typename T1>
+void casadi_ldl_solve_blk(T1* x, casadi_int nrhs, const casadi_int* sp_lt, const T1* lt,
+                          const T1* d, const casadi_int* p, T1* w, casadi_int nb) {
+  casadi_int i, j, b;
+  casadi_int n = sp_lt[1];
+  while (nrhs>0) {
+    // Size of the panel
+    b = nrhs<nb ? nrhs : nb;
+    // Multiply by P, interleaving the right-hand sides
+    for (j=0; j<b; ++j) {
+      for (i=0; i<n; ++i) w[i*b+j] = x[j*n+p[i]];
+    }
+    //  Solve for L
+    casadi_ldl_trs_blk(sp_lt, lt, w, b, 1);
+    // Divide by D
+    for (i=0; i<n; ++i) {
+      for (j=0; j<b; ++j) w[i*b+j] /= d[i];
+    }
+    // Solve for L'
+    casadi_ldl_trs_blk(sp_lt, lt, w, b, 0);
+    // Multiply by P'
+    for (j=0; j<b; ++j) {
+      for (i=0; i<n; ++i) x[j*n+p[i]] = w[i*b+j];
+    }
+    // Next panel
+    x += b*n;
+    nrhs -= b;
+  }
+}
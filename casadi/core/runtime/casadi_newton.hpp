@@ -38,22 +38,52 @@ struct casadi_newton_mem {
   T1* lin_v;
   T1* lin_r;
   T1* lin_beta;
+
+  // Maximum number of additional steps with the same factorization
+  casadi_int max_reuse;
+  // Required decrease of the residual in steps with a reused factorization
+  T1 contraction_tol;
+  // Steps taken with the current factorization, -1 if none
+  casadi_int jac_age;
+  // Residual norm before the last step
+  T1 g_norm;
 };
 
 // C-REPLACE "casadi_newton_mem<T1>" "struct casadi_newton_mem"
+// SYMBOL "newton_reuse"
+template<typename T1>
+int casadi_newton_reuse(const casadi_newton_mem<T1>* m) {
+    // Can the next step use the factorization of an earlier step, so that only g is needed?
+    return m->jac_age > 0 && m->jac_age <= m->max_reuse;
+}
+
 // SYMBOL "newton"
 template<typename T1>
-int casadi_newton(const casadi_newton_mem<T1>* m) {
+int casadi_newton(casadi_newton_mem<T1>* m) {
+    T1 g_norm;
+    g_norm = casadi_norm_inf(m->n, m->g);
+
     // Check tolerance on residual
-    if (m->abstol>0 && casadi_norm_inf(m->n, m->g) <= m->abstol) return 1;
+    if (m->abstol>0 && g_norm <= m->abstol) return 1;
 
-    // Factorize J
-    casadi_qr(m->sp_a, m->jac_g_x, m->lin_w,
-              m->sp_v,  m->lin_v, m->sp_r, m->lin_r, m->lin_beta,
-              m->prinv, m->pc);
+    if (casadi_newton_reuse(m)) {
+      // Request J if the residual does not decrease fast enough
+      if (g_norm > m->contraction_tol * m->g_norm) {
+        m->jac_age = -1;
+        return 3;
+      }
+    } else {
+      // Factorize J
+      casadi_qr(m->sp_a, m->jac_g_x, m->lin_w,
+                m->sp_v,  m->lin_v, m->sp_r, m->lin_r, m->lin_beta,
+                m->prinv, m->pc);
+      m->jac_age = 0;
+    }
     // Solve J^(-1) g
     casadi_qr_solve(m->g, 1, 0, m->sp_v, m->lin_v, m->sp_r, m->lin_r, m->lin_beta,
                     m->prinv, m->pc, m->lin_w);
+    m->jac_age++;
+    m->g_norm = g_norm;
 
     // Update Xk+1 = Xk - J^(-1) g
     casadi_axpy(m->n, -1., m->g, m->x);
@@ -40,6 +40,52 @@ T1 casadi_house(T1* v, T1* beta, casadi_int nv) {
   return s;
 }
 
+// SYMBOL "qr_col"
+// Column c of casadi_qr
+// The columns it depends on, its descendants in the column elimination tree,
+// must have been calculated
+// len[x] = nrow, zero on entry and exit
+template<typename T1>
+void casadi_qr_col(const casadi_int* sp_a, const T1* nz_a, T1* x,
+                   const casadi_int* sp_v, T1* nz_v, const casadi_int* sp_r, T1* nz_r, T1* beta,
+                   const casadi_int* prinv, const casadi_int* pc, casadi_int c) {
+   // Local variables
+   casadi_int ncol, r, k, k1;
+   T1 alpha;
+   const casadi_int *a_colind, *a_row, *v_colind, *v_row, *r_colind, *r_row;
+   // Extract sparsities
+   ncol = sp_a[1];
+   a_colind=sp_a+2; a_row=sp_a+2+ncol+1;
+   v_colind=sp_v+2; v_row=sp_v+2+ncol+1;
+   r_colind=sp_r+2; r_row=sp_r+2+ncol+1;
+   // Entries of column c of R
+   nz_r += r_colind[c];
+   // Copy (permuted) column of A to x
+   for (k=a_colind[pc[c]]; k<a_colind[pc[c]+1]; ++k) x[prinv[a_row[k]]] = nz_a[k];
+   // Use the equality R = (I-betan*vn*vn')*...*(I-beta1*v1*v1')*A to get
+   // strictly upper triangular entries of R
+   for (k=r_colind[c]; k<r_colind[c+1] && (r=r_row[k])<c; ++k) {
+     // Calculate scalar factor alpha = beta(r)*dot(v(:,r), x)
+     alpha = 0;
+     for (k1=v_colind[r]; k1<v_colind[r+1]; ++k1) alpha += nz_v[k1]*x[v_row[k1]];
+     alpha *= beta[r];
+     // x -= alpha*v(:,r)
+     for (k1=v_colind[r]; k1<v_colind[r+1]; ++k1) x[v_row[k1]] -= alpha*nz_v[k1];
+     // Get r entry
+     *nz_r++ = x[r];
+     // Strictly upper triangular entries in x no longer needed
+     x[r] = 0;
+   }
+   // Get V column
+   for (k=v_colind[c]; k<v_colind[c+1]; ++k) {
+     nz_v[k] = x[v_row[k]];
+     // Lower triangular entries of x no longer needed
+     x[v_row[k]] = 0;
+   }
+   // Get diagonal entry of R, normalize V column
+   *nz_r = casadi_house(nz_v + v_colind[c], beta + c, v_colind[c+1] - v_colind[c]);
+}
+
 // SYMBOL "qr"
 // Numeric QR factorization
 // Ref: Chapter 5, Direct Methods for Sparse Linear Systems by Tim Davis
@@ -54,44 +100,13 @@ void casadi_qr(const casadi_int* sp_a, const T1* nz_a, T1* x,
                const casadi_int* sp_v, T1* nz_v, const casadi_int* sp_r, T1* nz_r, T1* beta,
                const casadi_int* prinv, const casadi_int* pc) {
    // Local variables
-   casadi_int ncol, nrow, r, c, k, k1;
-   T1 alpha;
-   const casadi_int *a_colind, *a_row, *v_colind, *v_row, *r_colind, *r_row;
-   // Extract sparsities
+   casadi_int ncol, nrow, r, c;
    ncol = sp_a[1];
-   a_colind=sp_a+2; a_row=sp_a+2+ncol+1;
    nrow = sp_v[0];
-   v_colind=sp_v+2; v_row=sp_v+2+ncol+1;
-   r_colind=sp_r+2; r_row=sp_r+2+ncol+1;
    // Clear work vector
    for (r=0; r<nrow; ++r) x[r] = 0;
    // Loop over columns of R, A and V
-   for (c=0; c<ncol; ++c) {
-     // Copy (permuted) column of A to x
-     for (k=a_colind[pc[c]]; k<a_colind[pc[c]+1]; ++k) x[prinv[a_row[k]]] = nz_a[k];
-     // Use the equality R = (I-betan*vn*vn')*...*(I-beta1*v1*v1')*A to get
-     // strictly upper triangular entries of R
-     for (k=r_colind[c]; k<r_colind[c+1] && (r=r_row[k])<c; ++k) {
-       // Calculate scalar factor alpha = beta(r)*dot(v(:,r), x)
-       alpha = 0;
-       for (k1=v_colind[r]; k1<v_colind[r+1]; ++k1) alpha += nz_v[k1]*x[v_row[k1]];
-       alpha *= beta[r];
-       // x -= alpha*v(:,r)
-       for (k1=v_colind[r]; k1<v_colind[r+1]; ++k1) x[v_row[k1]] -= alpha*nz_v[k1];
-       // Get r entry
-       *nz_r++ = x[r];
-       // Strictly upper triangular entries in x no longer needed
-       x[r] = 0;
-     }
-     // Get V column
-     for (k=v_colind[c]; k<v_colind[c+1]; ++k) {
-       nz_v[k] = x[v_row[k]];
-       // Lower triangular entries of x no longer needed
-       x[v_row[k]] = 0;
-     }
-     // Get diagonal entry of R, normalize V column
-     *nz_r++ = casadi_house(nz_v + v_colind[c], beta + c, v_colind[c+1] - v_colind[c]);
-   }
+   for (c=0; c<ncol; ++c) casadi_qr_col(sp_a, nz_a, x, sp_v, nz_v, sp_r, nz_r, beta, prinv, pc, c);
  }
 
 // SYMBOL "qr_mv"
@@ -196,6 +211,178 @@ void casadi_qr_solve(T1* x, casadi_int nrhs, casadi_int tr,
   }
 }
 
+// SYMBOL "qr_mv_blk"
+// Multiply QR Q matrix from the right with nb vectors stored interleaved,
+// x[i*nb+j] being entry i of vector j
+// len[x] >= nb*nrow_ext
+template<typename T1>
+void casadi_qr_mv_blk(const casadi_int* sp_v, const T1* v, const T1* beta, T1* x,
+                      casadi_int nb, casadi_int tr) {
+  // Local variables
+  casadi_int ncol, c, c1, k, j;
+  T1 vk, a0, a1, a2, a3;
+  T1* xr;
+  const casadi_int *colind, *row;
+  // Extract sparsity
+  ncol=sp_v[1];
+  colind=sp_v+2; row=sp_v+2+ncol+1;
+  // Loop over vectors
+  for (c1=0; c1<ncol; ++c1) {
+    // Forward order for transpose, otherwise backwards
+    c = tr ? c1 : ncol-1-c1;
+    // Four right-hand sides at a time
+    for (j=0; j+4<=nb; j+=4) {
+      // Calculate scalar factors alpha = beta(c)*dot(v(:,c), x)
+      a0 = a1 = a2 = a3 = 0;
+      for (k=colind[c]; k<colind[c+1]; ++k) {
+        vk = v[k];
+        xr = x + row[k]*nb + j;
+        a0 += vk*xr[0]; a1 += vk*xr[1]; a2 += vk*xr[2]; a3 += vk*xr[3];
+      }
+      a0 *= beta[c]; a1 *= beta[c]; a2 *= beta[c]; a3 *= beta[c];
+      // x -= alpha*v(:,c)
+      for (k=colind[c]; k<colind[c+1]; ++k) {
+        vk = v[k];
+        xr = x + row[k]*nb + j;
+        xr[0] -= a0*vk; xr[1] -= a1*vk; xr[2] -= a2*vk; xr[3] -= a3*vk;
+      }
+    }
+    // Remainder
+    for (; j<nb; ++j) {
+      a0 = 0;
+      for (k=colind[c]; k<colind[c+1]; ++k) a0 += v[k]*x[row[k]*nb + j];
+      a0 *= beta[c];
+      for (k=colind[c]; k<colind[c+1]; ++k) x[row[k]*nb + j] -= a0*v[k];
+    }
+  }
+}
+
+// SYMBOL "qr_trs_blk"
+// Solve for an (optionally transposed) upper triangular matrix R,
+// nb right-hand sides stored interleaved
+template<typename T1>
+void casadi_qr_trs_blk(const casadi_int* sp_r, const T1* nz_r, T1* x, casadi_int nb,
+                       casadi_int tr) {
+  // Local variables
+  casadi_int ncol, c, k, j;
+  T1 rk, s0, s1, s2, s3;
+  T1 *xc, *xr;
+  const casadi_int *colind, *row;
+  // Extract sparsity
+  ncol=sp_r[1];
+  colind=sp_r+2; row=sp_r+2+ncol+1;
+  if (tr) {
+    // Forward substitution
+    for (c=0; c<ncol; ++c) {
+      xc = x + c*nb;
+      for (j=0; j+4<=nb; j+=4) {
+        s0 = xc[j]; s1 = xc[j+1]; s2 = xc[j+2]; s3 = xc[j+3];
+        for (k=colind[c]; k<colind[c+1]; ++k) {
+          rk = nz_r[k];
+          if (row[k]==c) {
+            s0 /= rk; s1 /= rk; s2 /= rk; s3 /= rk;
+          } else {
+            xr = x + row[k]*nb + j;
+            s0 -= rk*xr[0]; s1 -= rk*xr[1]; s2 -= rk*xr[2]; s3 -= rk*xr[3];
+          }
+        }
+        xc[j] = s0; xc[j+1] = s1; xc[j+2] = s2; xc[j+3] = s3;
+      }
+      for (; j<nb; ++j) {
+        s0 = xc[j];
+        for (k=colind[c]; k<colind[c+1]; ++k) {
+          if (row[k]==c) {
+            s0 /= nz_r[k];
+          } else {
+            s0 -= nz_r[k]*x[row[k]*nb + j];
+          }
+        }
+        xc[j] = s0;
+      }
+    }
+  } else {
+    // Backward substitution
+    for (c=ncol-1; c>=0; --c) {
+      xc = x + c*nb;
+      for (j=0; j+4<=nb; j+=4) {
+        s0 = xc[j]; s1 = xc[j+1]; s2 = xc[j+2]; s3 = xc[j+3];
+        for (k=colind[c+1]-1; k>=colind[c]; --k) {
+          rk = nz_r[k];
+          if (row[k]==c) {
+            s0 /= rk; s1 /= rk; s2 /= rk; s3 /= rk;
+            xc[j] = s0; xc[j+1] = s1; xc[j+2] = s2; xc[j+3] = s3;
+          } else {
+            xr = x + row[k]*nb + j;
+            xr[0] -= rk*s0; xr[1] -= rk*s1; xr[2] -= rk*s2; xr[3] -= rk*s3;
+          }
+        }
+      }
+      for (; j<nb; ++j) {
+        s0 = xc[j];
+        for (k=colind[c+1]-1; k>=colind[c]; --k) {
+          if (row[k]==c) {
+            s0 /= nz_r[k];
+            xc[j] = s0;
+          } else {
+            x[row[k]*nb + j] -= nz_r[k]*s0;
+          }
+        }
+      }
+    }
+  }
+}
+
+// SYMBOL "qr_solve_blk"
+// Solve a factorized linear system, processing up to nb right-hand sides
+// per pass over the factors
+// len[w] >= nb*max(ncol, nrow_ext)
+template<typename T1>
+void casadi_qr_solve_blk(T1* x, casadi_int nrhs, casadi_int tr,
+                         const casadi_int* sp_v, const T1* v, const casadi_int* sp_r, const T1* r,
+                         const T1* beta, const casadi_int* prinv, const casadi_int* pc, T1* w,
+                         casadi_int nb) {
+  casadi_int j, b, c, nrow_ext, ncol;
+  nrow_ext = sp_v[0]; ncol = sp_v[1];
+  while (nrhs>0) {
+    // Size of the panel
+    b = nrhs<nb ? nrhs : nb;
+    if (tr) {
+      // (PR' Q R PC)' x = PC' R' Q' PR x = b <-> x = PR' Q R' \ PC b
+      // Multiply by PC
+      for (j=0; j<b; ++j) {
+        for (c=0; c<ncol; ++c) w[c*b+j] = x[j*ncol+pc[c]];
+      }
+      for (c=ncol*b; c<nrow_ext*b; ++c) w[c] = 0;
+      //  Solve for R'
+      casadi_qr_trs_blk(sp_r, r, w, b, 1);
+      // Multiply by Q
+      casadi_qr_mv_blk(sp_v, v, beta, w, b, 0);
+      // Multiply by PR'
+      for (j=0; j<b; ++j) {
+        for (c=0; c<ncol; ++c) x[j*ncol+c] = w[prinv[c]*b+j];
+      }
+    } else {
+      //PR' Q R PC x = b <-> x = PC' R \ Q' PR b
+      // Multiply with PR
+      for (c=0; c<nrow_ext*b; ++c) w[c] = 0;
+      for (j=0; j<b; ++j) {
+        for (c=0; c<ncol; ++c) w[prinv[c]*b+j] = x[j*ncol+c];
+      }
+      // Multiply with Q'
+      casadi_qr_mv_blk(sp_v, v, beta, w, b, 1);
+      //  Solve for R
+      casadi_qr_trs_blk(sp_r, r, w, b, 0);
+      // Multiply with PC'
+      for (j=0; j<b; ++j) {
+        for (c=0; c<ncol; ++c) x[j*ncol+pc[c]] = w[c*b+j];
+      }
+    }
+    // Next panel
+    x += b*ncol;
+    nrhs -= b;
+  }
+}
+
 // SYMBOL "qr_singular"
 // Check if QR factorization corresponds to a singular matrix
 template<typename T1>
@@ -45,6 +45,8 @@ struct casadi_qrqp_prob {
   casadi_int max_iter;
   // Primal and dual error tolerance
   T1 constr_viol_tol, dual_inf_tol;
+  // Maximum number of low-rank updates before refactorizing the KKT system
+  casadi_int max_updates;
 };
 // C-REPLACE "casadi_qrqp_prob<T1>" "struct casadi_qrqp_prob"
 
@@ -57,6 +59,7 @@ void casadi_qrqp_setup(casadi_qrqp_prob<T1>* p) {
   p->max_iter = 1000;
   p->constr_viol_tol = 1e-8;
   p->dual_inf_tol = 1e-8;
+  p->max_updates = 10;
 }
 
 // SYMBOL "qrqp_flag_t"
@@ -83,6 +86,18 @@ struct casadi_qrqp_data {
   casadi_int *iw, *neverzero, *neverlower, *neverupper, *lincomb;
   // Numeric QR factorization
   T1 *nz_at, *nz_kkt, *beta, *nz_v, *nz_r;
+  // Is the QR factorization nonsingular and usable as a base for low-rank updates?
+  int qr_valid;
+  // Inactive constraints (lam==0) of the QR factorization
+  casadi_int* qr_inactive;
+  // Low-rank updates: number, KKT columns, solutions with the base factorization
+  casadi_int n_up, *up_ind;
+  T1 *up_w, *up_z;
+  // LU factorization of the Schur complement of the updates
+  T1 *up_s, *up_t;
+  casadi_int* up_piv;
+  // Residual and correction for iterative refinement with updates
+  T1 *up_r, *up_dx;
   // Message buffer
   const char *msg;
   // Message index
@@ -143,6 +158,17 @@ void casadi_qrqp_work(const casadi_qrqp_prob<T1>* p, casadi_int* sz_arg, casadi_
   *sz_iw += p->qp->nz; // neverupper
   *sz_iw += p->qp->nz; // neverlower
   *sz_iw += p->qp->nz; // lincomb
+  *sz_iw += p->qp->nz; // qr_inactive
+  *sz_iw += p->max_updates; // up_ind
+  *sz_iw += p->max_updates; // up_piv
+  *sz_w += p->max_updates * p->qp->nz; // up_w
+  *sz_w += p->max_updates * p->qp->nz; // up_z
+  *sz_w += p->max_updates * p->max_updates; // up_s
+  *sz_w += p->max_updates; // up_t
+  if (p->max_updates > 0) {
+    *sz_w += p->qp->nz; // up_r
+    *sz_w += p->qp->nz; // up_dx
+  }
 }
 
 // SYMBOL "qrqp_init"
@@ -173,10 +199,23 @@ void casadi_qrqp_init(casadi_qrqp_data<T1>* d, casadi_int** iw, T1** w) {
   d->neverupper = *iw; *iw += p->qp->nz;
   d->neverlower = *iw; *iw += p->qp->nz;
   d->lincomb = *iw; *iw += p->qp->nz;
+  d->qr_inactive = *iw; *iw += p->qp->nz;
+  d->up_ind = *iw; *iw += p->max_updates;
+  d->up_piv = *iw; *iw += p->max_updates;
+  d->up_w = *w; *w += p->max_updates * p->qp->nz;
+  d->up_z = *w; *w += p->max_updates * p->qp->nz;
+  d->up_s = *w; *w += p->max_updates * p->max_updates;
+  d->up_t = *w; *w += p->max_updates;
+  if (p->max_updates > 0) {
+    d->up_r = *w; *w += p->qp->nz;
+    d->up_dx = *w; *w += p->qp->nz;
+  }
   d->w = *w;
   d->iw = *iw;
 
   d->nz_r = d->nz_v + nnz_v;
+  d->qr_valid = 0;
+  d->n_up = 0;
 }
 
 // SYMBOL "qrqp_reset"
@@ -210,6 +249,9 @@ int casadi_qrqp_reset(casadi_qrqp_data<T1>* d) {
   }
   // Transpose A
   casadi_trans(d->qp->a, p->qp->sp_a, d->nz_at, p->sp_at, d->iw);
+  // No QR factorization
+  d->qr_valid = 0;
+  d->n_up = 0;
   // No pending active-set change
   d->index = -2;
   d->sign = 0;
@@ -467,6 +509,227 @@ void casadi_qrqp_kkt_residual(casadi_qrqp_data<T1>* d, T1* r) {
   }
 }
 
+// SYMBOL "qrqp_kkt_mv"
+template<typename T1>
+void casadi_qrqp_kkt_mv(casadi_qrqp_data<T1>* d, const T1* x, T1* y, casadi_int tr) {
+  // Local variables
+  casadi_int i, k;
+  const casadi_int *h_colind, *h_row, *a_colind, *a_row, *at_colind, *at_row;
+  const casadi_qrqp_prob<T1>* p = d->prob;
+  // Extract sparsities
+  a_row = (a_colind = p->qp->sp_a+2) + p->qp->nx + 1;
+  at_row = (at_colind = p->sp_at+2) + p->qp->na + 1;
+  h_row = (h_colind = p->qp->sp_h+2) + p->qp->nx + 1;
+  // Add the product with the matrix formed by casadi_qrqp_kkt, column by column
+  for (i=0; i<p->qp->nz; ++i) {
+    if (i<p->qp->nx && d->lam[i]==0) {
+      for (k=h_colind[i]; k<h_colind[i+1]; ++k) {
+        if (tr) {
+          y[i] += d->qp->h[k] * x[h_row[k]];
+        } else {
+          y[h_row[k]] += d->qp->h[k] * x[i];
+        }
+      }
+      for (k=a_colind[i]; k<a_colind[i+1]; ++k) {
+        if (tr) {
+          y[i] += d->qp->a[k] * x[p->qp->nx+a_row[k]];
+        } else {
+          y[p->qp->nx+a_row[k]] += d->qp->a[k] * x[i];
+        }
+      }
+    } else if (i<p->qp->nx) {
+      y[i] += x[i];
+    } else if (d->lam[i]==0) {
+      y[i] -= x[i];
+    } else {
+      for (k=at_colind[i-p->qp->nx]; k<at_colind[i-p->qp->nx+1]; ++k) {
+        if (tr) {
+          y[i] += d->nz_at[k] * x[at_row[k]];
+        } else {
+          y[at_row[k]] += d->nz_at[k] * x[i];
+        }
+      }
+    }
+  }
+}
+
+// SYMBOL "qrqp_lu"
+template<typename T1>
+T1 casadi_qrqp_lu(T1* a, casadi_int n, casadi_int* piv) {
+  // Dense LU factorization with partial pivoting, returns the smallest pivot
+  casadi_int i, j, k, r;
+  T1 t, amin;
+  amin = std::numeric_limits<T1>::infinity();
+  for (k = 0; k < n; ++k) {
+    // Find pivot
+    r = k;
+    for (i = k + 1; i < n; ++i) if (fabs(a[i + k*n]) > fabs(a[r + k*n])) r = i;
+    piv[k] = r;
+    // Swap rows
+    if (r != k) {
+      for (j = 0; j < n; ++j) {
+        t = a[k + j*n];
+        a[k + j*n] = a[r + j*n];
+        a[r + j*n] = t;
+      }
+    }
+    amin = fmin(amin, fabs(a[k + k*n]));
+    if (a[k + k*n] == 0.) return 0.;
+    // Eliminate
+    for (i = k + 1; i < n; ++i) a[i + k*n] /= a[k + k*n];
+    for (j = k + 1; j < n; ++j) {
+      for (i = k + 1; i < n; ++i) a[i + j*n] -= a[i + k*n] * a[k + j*n];
+    }
+  }
+  return amin;
+}
+
+// SYMBOL "qrqp_lu_solve"
+template<typename T1>
+void casadi_qrqp_lu_solve(const T1* a, casadi_int n, const casadi_int* piv, T1* x,
+    casadi_int tr) {
+  // Local variables
+  casadi_int i, j;
+  T1 t;
+  if (tr) {
+    // Solve with U'
+    for (j = 0; j < n; ++j) {
+      for (i = 0; i < j; ++i) x[j] -= a[i + j*n] * x[i];
+      x[j] /= a[j + j*n];
+    }
+    // Solve with L'
+    for (j = n - 1; j >= 0; --j) {
+      for (i = j + 1; i < n; ++i) x[j] -= a[i + j*n] * x[i];
+    }
+    // Undo row interchanges
+    for (j = n - 1; j >= 0; --j) {
+      t = x[j];
+      x[j] = x[piv[j]];
+      x[piv[j]] = t;
+    }
+  } else {
+    // Row interchanges
+    for (j = 0; j < n; ++j) {
+      t = x[j];
+      x[j] = x[piv[j]];
+      x[piv[j]] = t;
+    }
+    // Solve with L
+    for (j = 0; j < n; ++j) {
+      for (i = j + 1; i < n; ++i) x[i] -= a[i + j*n] * x[j];
+    }
+    // Solve with U
+    for (j = n - 1; j >= 0; --j) {
+      x[j] /= a[j + j*n];
+      for (i = 0; i < j; ++i) x[i] -= a[i + j*n] * x[j];
+    }
+  }
+}
+
+// SYMBOL "qrqp_update"
+template<typename T1>
+int casadi_qrqp_update(casadi_qrqp_data<T1>* d) {
+  // Local variables
+  casadi_int i, j, k, n, nz;
+  T1 *w_j, *z_j;
+  const casadi_qrqp_prob<T1>* p = d->prob;
+  nz = p->qp->nz;
+  // Need a nonsingular base factorization
+  if (!d->qr_valid) return 1;
+  // Drop updates of constraints that are back in the base active set
+  for (j = 0; j < d->n_up; ) {
+    i = d->up_ind[j];
+    if ((d->lam[i] == 0.) == d->qr_inactive[i]) {
+      if (j < --d->n_up) {
+        d->up_ind[j] = d->up_ind[d->n_up];
+        casadi_copy(d->up_w + d->n_up*nz, nz, d->up_w + j*nz);
+        casadi_copy(d->up_z + d->n_up*nz, nz, d->up_z + j*nz);
+      }
+    } else {
+      j++;
+    }
+  }
+  // Add updates for constraints that changed since the base factorization
+  for (i = 0; i < nz; ++i) {
+    if ((d->lam[i] == 0.) == d->qr_inactive[i]) continue;
+    for (j = 0; j < d->n_up; ++j) if (d->up_ind[j] == i) break;
+    if (j < d->n_up) continue;
+    // Too many updates, refactorize
+    if (d->n_up == p->max_updates) return 1;
+    j = d->n_up++;
+    d->up_ind[j] = i;
+    // Solve for the change in KKT column i
+    w_j = d->up_w + j*nz;
+    casadi_qrqp_kkt_vector(d, w_j, i);
+    if (d->lam[i] != 0.) casadi_scal(nz, -1., w_j);
+    casadi_qr_solve(w_j, 1, 0, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
+                    p->prinv, p->pc, d->w);
+    // Solve transposed for the unit vector
+    z_j = d->up_z + j*nz;
+    casadi_clear(z_j, nz);
+    z_j[i] = 1.;
+    casadi_qr_solve(z_j, 1, 1, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
+                    p->prinv, p->pc, d->w);
+  }
+  // Schur complement S = I + U' * W
+  n = d->n_up;
+  for (j = 0; j < n; ++j) {
+    for (k = 0; k < n; ++k) d->up_s[k + j*n] = d->up_w[j*nz + d->up_ind[k]];
+    d->up_s[j + j*n] += 1.;
+  }
+  // Refactorize if (nearly) singular
+  if (n > 0 && casadi_qrqp_lu(d->up_s, n, d->up_piv) < 1e-8) return 1;
+  return 0;
+}
+
+// SYMBOL "qrqp_solve_updated"
+template<typename T1>
+void casadi_qrqp_solve_updated(casadi_qrqp_data<T1>* d, T1* x, casadi_int tr) {
+  // Local variables
+  casadi_int j, i, n;
+  const casadi_qrqp_prob<T1>* p = d->prob;
+  // Solve with the base factorization
+  casadi_qr_solve(x, 1, tr, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
+                  p->prinv, p->pc, d->w);
+  // Correct for low-rank updates (Sherman-Morrison-Woodbury)
+  n = d->n_up;
+  if (n == 0) return;
+  if (tr) {
+    for (j = 0; j < n; ++j) {
+      i = d->up_ind[j];
+      d->up_t[j] = casadi_qrqp_kkt_dot(d, x, i);
+      if (d->lam[i] == 0.) d->up_t[j] = -d->up_t[j];
+    }
+    casadi_qrqp_lu_solve(d->up_s, n, d->up_piv, d->up_t, 1);
+    for (j = 0; j < n; ++j) casadi_axpy(p->qp->nz, -d->up_t[j], d->up_z + j*p->qp->nz, x);
+  } else {
+    for (j = 0; j < n; ++j) d->up_t[j] = x[d->up_ind[j]];
+    casadi_qrqp_lu_solve(d->up_s, n, d->up_piv, d->up_t, 0);
+    for (j = 0; j < n; ++j) casadi_axpy(p->qp->nz, -d->up_t[j], d->up_w + j*p->qp->nz, x);
+  }
+}
+
+// SYMBOL "qrqp_solve"
+template<typename T1>
+void casadi_qrqp_solve(casadi_qrqp_data<T1>* d, T1* x, casadi_int tr) {
+  const casadi_qrqp_prob<T1>* p = d->prob;
+  // Without updates, a single solve with the QR factorization
+  if (d->n_up == 0) {
+    casadi_qr_solve(x, 1, tr, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
+                    p->prinv, p->pc, d->w);
+    return;
+  }
+  // Solve with the updated factorization
+  casadi_copy(x, p->qp->nz, d->up_r);
+  casadi_qrqp_solve_updated(d, x, tr);
+  // One step of iterative refinement
+  casadi_scal(p->qp->nz, -1., d->up_r);
+  casadi_qrqp_kkt_mv(d, x, d->up_r, tr);
+  casadi_copy(d->up_r, p->qp->nz, d->up_dx);
+  casadi_qrqp_solve_updated(d, d->up_dx, tr);
+  casadi_axpy(p->qp->nz, -1., d->up_dx, x);
+}
+
 // SYMBOL "qrqp_zero_blocking"
 template<typename T1>
 int casadi_qrqp_zero_blocking(casadi_qrqp_data<T1>* d) {
@@ -678,15 +941,13 @@ int casadi_qrqp_flip_check(casadi_qrqp_data<T1>* d) {
   // Calculate the difference between old and new column index
   if (d->sign == 0) casadi_scal(p->qp->nz, -1., d->dlam);
   // Try to find a linear combination of the new columns
-  casadi_qr_solve(d->dlam, 1, 0, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
-    p->prinv, p->pc, d->w);
+  casadi_qrqp_solve(d, d->dlam, 0);
   // If dlam[index]!=1, new columns must be linearly independent
   if (fabs(d->dlam[d->index]-1.) >= 1e-12) return 0;
   // Next, find a linear combination of the new rows
   casadi_clear(d->dz, p->qp->nz);
   d->dz[d->index] = 1;
-  casadi_qr_solve(d->dz, 1, 1, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
-    p->prinv, p->pc, d->w);
+  casadi_qrqp_solve(d, d->dz, 1);
   // Normalize dlam, dz
   casadi_scal(p->qp->nz, 1./sqrt(casadi_dot(p->qp->nz, d->dlam, d->dlam)), d->dlam);
   casadi_scal(p->qp->nz, 1./sqrt(casadi_dot(p->qp->nz, d->dz, d->dz)), d->dz);
@@ -697,12 +958,19 @@ int casadi_qrqp_flip_check(casadi_qrqp_data<T1>* d) {
 // SYMBOL "qrqp_factorize"
 template<typename T1>
 void casadi_qrqp_factorize(casadi_qrqp_data<T1>* d) {
+  // Local variables
+  casadi_int i;
   const casadi_qrqp_prob<T1>* p = d->prob;
   // Do we already have a search direction due to lost singularity?
   if (d->has_search_dir) {
     d->sing = 1;
     return;
   }
+  // Low-rank update of the previous factorization, if possible
+  if (!casadi_qrqp_update(d)) {
+    d->sing = 0;
+    return;
+  }
   // Construct the KKT matrix
   casadi_qrqp_kkt(d);
   // QR factorization
@@ -710,6 +978,10 @@ void casadi_qrqp_factorize(casadi_qrqp_data<T1>* d) {
             d->nz_r, d->beta, p->prinv, p->pc);
   // Check singularity
   d->sing = casadi_qr_singular(&d->mina, &d->imina, d->nz_r, p->sp_r, p->pc, 1e-12);
+  // New base for low-rank updates
+  d->qr_valid = !d->sing;
+  d->n_up = 0;
+  for (i = 0; i < p->qp->nz; ++i) d->qr_inactive[i] = d->lam[i] == 0.;
 }
 
 // SYMBOL "qrqp_expand_step"
@@ -821,7 +1093,8 @@ int casadi_qrqp_singular_step(casadi_qrqp_data<T1>* d) {
     // One, given search direction
     nk = 1;
   } else {
-    // QR factorization of the transpose
+    // QR factorization of the transpose, replacing the factorization of the KKT
+    d->qr_valid = 0;
     casadi_trans(d->nz_kkt, p->sp_kkt, d->nz_v, p->sp_kkt, d->iw);
     nnz_kkt = p->sp_kkt[2+p->qp->nz]; // kkt_colind[nz]
     casadi_copy(d->nz_v, nnz_kkt, d->nz_kkt);
@@ -934,8 +1207,7 @@ int casadi_qrqp_calc_step(casadi_qrqp_data<T1>* d) {
   // Negative KKT residual
   casadi_qrqp_kkt_residual(d, d->dz);
   // Solve to get step in z[:nx] and lam[nx:]
-  casadi_qr_solve(d->dz, 1, 1, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
-                  p->prinv, p->pc, d->w);
+  casadi_qrqp_solve(d, d->dz, 1);
   // Have step in dz[:nx] and dlam[nx:]. Calculate complete dz and dlam
   casadi_qrqp_expand_step(d);
   // Successful return
@@ -1021,6 +1293,8 @@ void casadi_qrqp_linesearch(casadi_qrqp_data<T1>* d) {
   casadi_qrqp_take_step(d);
   // Handle dual blocking constraints
   if (du_index >= 0) {
+    // Dual error after the step, for comparison in casadi_qrqp_du_check
+    casadi_qrqp_du(d);
     // Sensititivity in decreasing du_index
     casadi_qrqp_calc_sens(d, du_index);
     // Find corresponding index
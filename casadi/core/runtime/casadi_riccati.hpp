@@ -0,0 +1,410 @@
+//
+//    MIT No Attribution
+//
+//    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl, KU Leuven.
+//
+//    Permission is hereby granted, free of charge, to any person obtaining a copy of this
+//    software and associated documentation files (the "Software"), to deal in the Software
+//    without restriction, including without limitation the rights to use, copy, modify,
+//    merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+//    permit persons to whom the Software is furnished to do so.
+//
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// Stage-wise factorization of the scaled KKT systems arising in casadi_ipqp,
+//   [S_x H S_x + D_x, S_x A' S_g; S_g A S_x, -D_g]
+// The variables are partitioned into consecutive stages such that the Hessian and every
+// row of the constraint Jacobian only couple variables of the same or of two neighbouring
+// stages. Each constraint is assigned to the last stage it touches. The stages are then
+// eliminated backwards, each with a dense frontal matrix containing the variables and
+// constraints of the stage and the variables of the previous stage. For optimal control
+// problems, this is the backward Riccati recursion, with cost linear in the horizon length.
+// Pivots are chosen with the Bunch-Kaufman strategy among the rows of the stage. Rows that
+// cannot be eliminated within the stage, e.g. dynamics of fixed states, are delayed to the
+// previous stage.
+
+// SYMBOL "riccati_prob"
+template<typename T1>
+struct casadi_riccati_prob {
+  // Sparsity patterns of the Hessian and the constraint Jacobian
+  const casadi_int *sp_h, *sp_a;
+  // Dimensions
+  casadi_int nx, na, nz;
+  // Number of stages
+  casadi_int N;
+  // First variable of each stage, length N+1
+  const casadi_int* x_off;
+  // Constraints assigned to each stage, in compressed row format
+  const casadi_int *a_off, *a_row;
+  // Maximum number of rows delayed to the previous stage
+  casadi_int nd_max;
+  // Pivot tolerance
+  T1 tol;
+  // Size of the frontal matrices, largest frontal matrix
+  casadi_int sz_f, sz_idx, m_max;
+};
+// C-REPLACE "casadi_riccati_prob<T1>" "struct casadi_riccati_prob"
+
+// SYMBOL "riccati_max_front"
+template<typename T1>
+casadi_int casadi_riccati_max_front(const casadi_riccati_prob<T1>* p, casadi_int k) {
+  // Variables and constraints of stage k, delayed rows, variables of stage k-1
+  return p->x_off[k+1] - p->x_off[k] + p->a_off[k+1] - p->a_off[k] + p->nd_max
+    + (k > 0 ? p->x_off[k] - p->x_off[k-1] : 0);
+}
+
+// SYMBOL "riccati_setup"
+template<typename T1>
+void casadi_riccati_setup(casadi_riccati_prob<T1>* p) {
+  casadi_int k, m;
+  p->nx = p->sp_a[1];
+  p->na = p->sp_a[0];
+  p->nz = p->nx + p->na;
+  p->tol = 1e-12;
+  p->sz_f = p->sz_idx = p->m_max = 0;
+  for (k = 0; k < p->N; ++k) {
+    m = casadi_riccati_max_front(p, k);
+    p->sz_f += m * m;
+    p->sz_idx += m;
+    if (m > p->m_max) p->m_max = m;
+  }
+}
+
+// SYMBOL "riccati_data"
+template<typename T1>
+struct casadi_riccati_data {
+  // Problem structure
+  const casadi_riccati_prob<T1>* prob;
+  // Frontal matrices, overwritten by their factors
+  T1* f;
+  // Work vector for the solve
+  T1* y;
+  // Global index of each row of the frontal matrices
+  casadi_int* idx;
+  // Pivots: 1 for a 1x1 pivot, 2 and 0 for the rows of a 2x2 pivot
+  casadi_int* piv;
+  // Offsets of the frontal matrices and of their rows
+  casadi_int *f_off, *i_off;
+  // Size of each frontal matrix, number of eliminated rows
+  casadi_int *m, *ne;
+  // Position of a global index in the current frontal matrix
+  casadi_int* loc;
+};
+// C-REPLACE "casadi_riccati_data<T1>" "struct casadi_riccati_data"
+
+// SYMBOL "riccati_work"
+template<typename T1>
+void casadi_riccati_work(const casadi_riccati_prob<T1>* p, casadi_int* sz_iw,
+    casadi_int* sz_w) {
+  *sz_iw = 2 * (p->N + 1) + 2 * p->sz_idx + 2 * p->N + p->nz;
+  *sz_w = p->sz_f + p->m_max;
+}
+
+// SYMBOL "riccati_init"
+template<typename T1>
+void casadi_riccati_init(casadi_riccati_data<T1>* d, casadi_int** iw, T1** w) {
+  casadi_int k, m;
+  const casadi_riccati_prob<T1>* p = d->prob;
+  // Assign memory
+  d->f = *w; *w += p->sz_f;
+  d->y = *w; *w += p->m_max;
+  d->f_off = *iw; *iw += p->N + 1;
+  d->i_off = *iw; *iw += p->N + 1;
+  d->idx = *iw; *iw += p->sz_idx;
+  d->piv = *iw; *iw += p->sz_idx;
+  d->m = *iw; *iw += p->N;
+  d->ne = *iw; *iw += p->N;
+  d->loc = *iw; *iw += p->nz;
+  // Offsets of the frontal matrices
+  d->f_off[0] = d->i_off[0] = 0;
+  for (k = 0; k < p->N; ++k) {
+    m = casadi_riccati_max_front(p, k);
+    d->f_off[k+1] = d->f_off[k] + m * m;
+    d->i_off[k+1] = d->i_off[k] + m;
+  }
+}
+
+// SYMBOL "riccati_swap"
+// Symmetric permutation of rows and columns i and j of a dense m-by-m matrix
+template<typename T1>
+void casadi_riccati_swap(T1* f, casadi_int m, casadi_int* idx, casadi_int i, casadi_int j) {
+  casadi_int k, t;
+  T1 v;
+  if (i == j) return;
+  for (k = 0; k < m; ++k) {
+    v = f[i*m + k]; f[i*m + k] = f[j*m + k]; f[j*m + k] = v;
+  }
+  for (k = 0; k < m; ++k) {
+    v = f[k*m + i]; f[k*m + i] = f[k*m + j]; f[k*m + j] = v;
+  }
+  t = idx[i]; idx[i] = idx[j]; idx[j] = t;
+}
+
+// SYMBOL "riccati_pivot"
+// Eliminate row p (n=1) or rows p, p+1 (n=2) of a dense symmetric matrix,
+// storing the columns of L in place
+template<typename T1>
+void casadi_riccati_pivot(T1* f, casadi_int m, casadi_int p, casadi_int n) {
+  casadi_int i, j;
+  T1 a, b, c, det, l0, l1;
+  if (n == 1) {
+    a = f[p*m + p];
+    for (i = p + 1; i < m; ++i) {
+      l0 = f[i*m + p] / a;
+      if (l0 == 0) continue;
+      for (j = p + 1; j < m; ++j) f[i*m + j] -= l0 * f[p*m + j];
+    }
+    for (i = p + 1; i < m; ++i) f[i*m + p] /= a;
+  } else {
+    a = f[p*m + p];
+    b = f[(p+1)*m + p];
+    c = f[(p+1)*m + p + 1];
+    det = a * c - b * b;
+    for (i = p + 2; i < m; ++i) {
+      l0 = (c * f[i*m + p] - b * f[i*m + p + 1]) / det;
+      l1 = (a * f[i*m + p + 1] - b * f[i*m + p]) / det;
+      if (l0 == 0 && l1 == 0) continue;
+      for (j = p + 2; j < m; ++j) {
+        f[i*m + j] -= l0 * f[p*m + j] + l1 * f[(p+1)*m + j];
+      }
+    }
+    for (i = p + 2; i < m; ++i) {
+      l0 = (c * f[i*m + p] - b * f[i*m + p + 1]) / det;
+      l1 = (a * f[i*m + p + 1] - b * f[i*m + p]) / det;
+      f[i*m + p] = l0;
+      f[i*m + p + 1] = l1;
+    }
+  }
+}
+
+// SYMBOL "riccati_partial"
+// Partial symmetric indefinite factorization, eliminating among the first nc rows.
+// Rows that cannot be eliminated are moved after the eliminated ones.
+// Returns the number of eliminated rows.
+template<typename T1>
+casadi_int casadi_riccati_partial(T1* f, casadi_int m, casadi_int nc, casadi_int* idx,
+    casadi_int* piv, T1 tol) {
+  casadi_int p, e, r, j;
+  T1 a, g, ge, s, alpha;
+  // Bunch-Kaufman parameter
+  alpha = 0.6403882032022076;
+  p = 0;
+  e = nc;
+  while (p < e) {
+    // Largest off-diagonal entry among the candidates, and overall
+    a = fabs(f[p*m + p]);
+    r = -1;
+    ge = 0;
+    for (j = p + 1; j < e; ++j) {
+      if (fabs(f[j*m + p]) > ge) {
+        ge = fabs(f[j*m + p]);
+        r = j;
+      }
+    }
+    g = ge;
+    for (j = e; j < m; ++j) if (fabs(f[j*m + p]) > g) g = fabs(f[j*m + p]);
+    if (a > tol && a >= alpha * g) {
+      // 1x1 pivot
+      piv[p] = 1;
+      casadi_riccati_pivot(f, m, p, 1);
+      p++;
+      continue;
+    }
+    // Delay if there is no stable pivot among the rows of the stage
+    if (ge <= tol || ge < alpha * g) {
+      e--;
+      casadi_riccati_swap(f, m, idx, p, e);
+      continue;
+    }
+    // Largest off-diagonal entry in column r
+    s = 0;
+    for (j = p; j < m; ++j) {
+      if (j != r && fabs(f[j*m + r]) > s) s = fabs(f[j*m + r]);
+    }
+    if (a * s >= alpha * g * g) {
+      // 1x1 pivot
+      piv[p] = 1;
+      casadi_riccati_pivot(f, m, p, 1);
+      p++;
+    } else if (fabs(f[r*m + r]) >= alpha * s) {
+      // 1x1 pivot on row r
+      casadi_riccati_swap(f, m, idx, p, r);
+      piv[p] = 1;
+      casadi_riccati_pivot(f, m, p, 1);
+      p++;
+    } else {
+      // 2x2 pivot with row r
+      casadi_riccati_swap(f, m, idx, p + 1, r);
+      piv[p] = 2;
+      piv[p + 1] = 0;
+      casadi_riccati_pivot(f, m, p, 2);
+      p += 2;
+    }
+  }
+  return p;
+}
+
+// SYMBOL "riccati_factor"
+// Factorize the scaled KKT matrix, returns nonzero if singular
+template<typename T1>
+int casadi_riccati_factor(casadi_riccati_data<T1>* d, const T1* nz_h, const T1* nz_a,
+    const T1* S, const T1* D) {
+  // Local variables
+  casadi_int k, i, j, c, el, r, m, nv, nd, nc, ne, i0, i1, l, li, lj, m1, ne1;
+  const casadi_int *h_colind, *h_row, *a_colind, *a_row, *idx1;
+  casadi_int* idx;
+  T1 *f, *f1;
+  T1 v;
+  const casadi_riccati_prob<T1>* p = d->prob;
+  // Extract sparsities
+  h_row = (h_colind = p->sp_h + 2) + p->nx + 1;
+  a_row = (a_colind = p->sp_a + 2) + p->nx + 1;
+  // Clear position map
+  for (i = 0; i < p->nz; ++i) d->loc[i] = -1;
+  // No rows delayed from the last stage
+  nd = 0;
+  idx1 = 0;
+  f1 = 0;
+  m1 = ne1 = 0;
+  // Backward recursion over the stages
+  for (k = p->N - 1; k >= 0; --k) {
+    f = d->f + d->f_off[k];
+    idx = d->idx + d->i_off[k];
+    // Variables of the previous stage
+    i0 = k > 0 ? p->x_off[k-1] : 0;
+    i1 = p->x_off[k];
+    // Rows: variables, constraints, delayed rows, variables of the previous stage
+    m = 0;
+    for (i = p->x_off[k]; i < p->x_off[k+1]; ++i) idx[m++] = i;
+    nv = m;
+    for (el = p->a_off[k]; el < p->a_off[k+1]; ++el) idx[m++] = p->nx + p->a_row[el];
+    for (i = 0; i < nd; ++i) idx[m++] = idx1[ne1 + i];
+    nc = m;
+    for (i = i0; i < i1; ++i) idx[m++] = i;
+    d->m[k] = m;
+    for (i = 0; i < m; ++i) d->loc[idx[i]] = i;
+    for (i = 0; i < m * m; ++i) f[i] = 0;
+    // Hessian columns of the stage
+    for (c = p->x_off[k]; c < p->x_off[k+1]; ++c) {
+      lj = d->loc[c];
+      if (nz_h) {
+        for (el = h_colind[c]; el < h_colind[c+1]; ++el) {
+          r = h_row[el];
+          if (r < i0 || r >= p->x_off[k+1]) continue;
+          li = d->loc[r];
+          v = nz_h[el] * S[r] * S[c];
+          f[li*m + lj] = v;
+          if (r < i1) f[lj*m + li] = v;
+        }
+      }
+      f[lj*m + lj] += D[c];
+    }
+    // Constraint Jacobian entries of the constraints of the stage
+    if (nz_a) {
+      for (c = i0; c < p->x_off[k+1]; ++c) {
+        lj = d->loc[c];
+        for (el = a_colind[c]; el < a_colind[c+1]; ++el) {
+          r = p->nx + a_row[el];
+          li = d->loc[r];
+          // Skip constraints of other stages, including rows delayed to this one
+          if (li < nv || li >= nv + p->a_off[k+1] - p->a_off[k] || idx[li] != r) continue;
+          v = nz_a[el] * S[r] * S[c];
+          f[li*m + lj] = v;
+          f[lj*m + li] = v;
+        }
+      }
+    }
+    for (el = p->a_off[k]; el < p->a_off[k+1]; ++el) {
+      r = p->nx + p->a_row[el];
+      l = d->loc[r];
+      f[l*m + l] = -D[r];
+    }
+    // Schur complement from the next stage
+    if (f1) {
+      for (i = ne1; i < m1; ++i) {
+        li = d->loc[idx1[i]];
+        for (j = ne1; j < m1; ++j) {
+          f[li*m + d->loc[idx1[j]]] += f1[i*m1 + j];
+        }
+      }
+    }
+    // Eliminate the rows of the stage
+    ne = casadi_riccati_partial(f, m, nc, idx, d->piv + d->i_off[k], p->tol);
+    d->ne[k] = ne;
+    // Rows delayed to the previous stage
+    nd = nc - ne;
+    if (nd > 0 && (k == 0 || nd > p->nd_max)) return 1;
+    // Pass to the previous stage
+    f1 = f;
+    idx1 = idx;
+    m1 = m;
+    ne1 = ne;
+  }
+  return 0;
+}
+
+// SYMBOL "riccati_solve"
+// Solve the factorized KKT system in-place
+template<typename T1>
+void casadi_riccati_solve(casadi_riccati_data<T1>* d, T1* x) {
+  // Local variables
+  casadi_int k, i, p, m, ne;
+  const casadi_int *idx, *piv;
+  const T1* f;
+  T1 a, b, c, det, y0, y1;
+  T1* y;
+  const casadi_riccati_prob<T1>* pr = d->prob;
+  y = d->y;
+  // Forward substitution and division by the block diagonal, in order of elimination
+  for (k = pr->N - 1; k >= 0; --k) {
+    f = d->f + d->f_off[k];
+    idx = d->idx + d->i_off[k];
+    piv = d->piv + d->i_off[k];
+    m = d->m[k];
+    ne = d->ne[k];
+    for (i = 0; i < m; ++i) y[i] = x[idx[i]];
+    for (p = 0; p < ne; ++p) {
+      if (piv[p] == 1) {
+        if (y[p] != 0) {
+          for (i = p + 1; i < m; ++i) y[i] -= f[i*m + p] * y[p];
+        }
+      } else if (piv[p] == 2) {
+        for (i = p + 2; i < m; ++i) y[i] -= f[i*m + p] * y[p] + f[i*m + p + 1] * y[p + 1];
+      }
+    }
+    for (p = 0; p < ne; ++p) {
+      if (piv[p] == 1) {
+        y[p] /= f[p*m + p];
+      } else if (piv[p] == 2) {
+        a = f[p*m + p];
+        b = f[(p+1)*m + p];
+        c = f[(p+1)*m + p + 1];
+        det = a * c - b * b;
+        y0 = y[p];
+        y1 = y[p + 1];
+        y[p] = (c * y0 - b * y1) / det;
+        y[p + 1] = (a * y1 - b * y0) / det;
+      }
+    }
+    for (i = 0; i < m; ++i) x[idx[i]] = y[i];
+  }
+  // Backward substitution, in reverse order
+  for (k = 0; k < pr->N; ++k) {
+    f = d->f + d->f_off[k];
+    idx = d->idx + d->i_off[k];
+    piv = d->piv + d->i_off[k];
+    m = d->m[k];
+    ne = d->ne[k];
+    for (i = 0; i < m; ++i) y[i] = x[idx[i]];
+    for (p = ne - 1; p >= 0; --p) {
+      for (i = piv[p] == 2 ? p + 2 : p + 1; i < m; ++i) y[p] -= f[i*m + p] * y[i];
+    }
+    for (i = 0; i < ne; ++i) x[idx[i]] = y[i];
+  }
+}
@@ -227,7 +227,9 @@ namespace casadi {
 
   // Newton step
   template<typename T1>
-  int casadi_newton(const casadi_newton_mem<T1>* m);
+  int casadi_newton_reuse(const casadi_newton_mem<T1>* m);
+  template<typename T1>
+  int casadi_newton(casadi_newton_mem<T1>* m);
 
   // Dense matrix multiplication
   #define CASADI_GEMM_NT(M, N, K, A, LDA, B, LDB, C, LDC) \
@@ -292,6 +294,7 @@ namespace casadi {
   #include "casadi_qrqp.hpp"
   #include "casadi_kkt.hpp"
   #include "casadi_ipqp.hpp"
+  #include "casadi_riccati.hpp"
   #include "casadi_oracle.hpp"
   #include "casadi_nlp.hpp"
   #include "casadi_sqpmethod.hpp"
@@ -32,8 +32,71 @@
 #include "generic_type.hpp"
 #include <iomanip>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
 namespace casadi {
 
+#ifndef _WIN32
+    /// \cond INTERNAL
+    /** \brief Input stream reading from a read-only memory mapping of a file
+
+        The pages are shared with other processes mapping the same file, and blocks
+        are copied straight from the mapping.
+    */
+    class MappedFileStream : public std::istream {
+    public:
+      explicit MappedFileStream(const std::string& fname) :
+          std::istream(nullptr), data_(nullptr), len_(0) {
+        int fd = open(fname.c_str(), O_RDONLY);
+        if (fd>=0) {
+          struct stat st;
+          if (fstat(fd, &st)==0 && st.st_size>0) {
+            void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (data!=MAP_FAILED) {
+              data_ = static_cast<char*>(data);
+              len_ = st.st_size;
+              madvise(data_, len_, MADV_SEQUENTIAL);
+            }
+          }
+          close(fd);
+        }
+        if (data_) buf_.setg(data_, data_, data_ + len_);
+        rdbuf(&buf_);
+        if (!data_) setstate(std::ios::failbit);
+      }
+
+      ~MappedFileStream() override {
+        if (data_) munmap(data_, len_);
+      }
+
+    private:
+      // Get area over the whole mapping
+      class Buffer : public std::streambuf {
+      public:
+        using std::streambuf::setg;
+      };
+      Buffer buf_;
+      char* data_;
+      size_t len_;
+    };
+    /// \endcond
+#endif // _WIN32
+
+    // Open a file for deserialization, memory mapped when possible
+    static std::istream* open_input_file(const std::string& fname) {
+#ifndef _WIN32
+      MappedFileStream* ret = new MappedFileStream(fname);
+      if (ret->good()) return ret;
+      delete ret;
+#endif // _WIN32
+      return new std::ifstream(fname, std::ios_base::binary | std::ios::in);
+    }
+
     StringSerializer::StringSerializer(const Dict& opts) :
         SerializerBase(std::unique_ptr<std::ostream>(new std::stringstream()), opts) {
     }
@@ -104,8 +167,7 @@ namespace casadi {
     }
 
     FileDeserializer::FileDeserializer(const std::string& fname) :
-        DeserializerBase(std::unique_ptr<std::istream>(
-          new std::ifstream(fname, std::ios_base::binary | std::ios::in))) {
+        DeserializerBase(std::unique_ptr<std::istream>(open_input_file(fname))) {
       if ((dstream_->rdstate() & std::ifstream::failbit) != 0) {
         casadi_error("Could not open file '" + fname + "' for reading.");
       }
@@ -40,10 +40,17 @@
 
 namespace casadi {
 
-    static casadi_int serialization_protocol_version = 3;
+    // Version 4 adds a binary flag to the header. Text streams are still written
+    // in version 3, so that they remain readable by older releases
+    static casadi_int serialization_protocol_version = 4;
+    static casadi_int serialization_protocol_version_text = 3;
     static casadi_int serialization_check = 123456789012345;
 
-    DeserializingStream::DeserializingStream(std::istream& in_s) : in(in_s), debug_(false) {
+    // Alignment of blocks in binary streams
+    static size_t serialization_block_alignment = 8;
+
+    DeserializingStream::DeserializingStream(std::istream& in_s) : in(in_s), debug_(false),
+        binary_(false), pos_(0) {
 
       casadi_assert(in_s.good(), "Invalid input stream. If you specified an input file, "
         "make sure it exists relative to the current directory.");
@@ -58,15 +65,17 @@ namespace casadi {
       // API version check
       casadi_int v;
       unpack(v);
-      casadi_assert(v==serialization_protocol_version,
+      casadi_assert(v==serialization_protocol_version || v==serialization_protocol_version_text,
         "Serialization protocol is not compatible. "
         "Got version " + str(v) + ", while " +
         str(serialization_protocol_version) + " was expected.");
 
       bool debug;
       unpack(debug);
+      bool binary = false;
+      if (v>=4) unpack(binary);
       debug_ = debug;
-
+      binary_ = binary;
     }
 
     SerializingStream::SerializingStream(std::ostream& out_s) :
@@ -74,25 +83,30 @@ namespace casadi {
     }
 
     SerializingStream::SerializingStream(std::ostream& out_s, const Dict& opts) :
-        out(out_s), debug_(false) {
-      // Sanity check
-      pack(serialization_check);
-      // API version check
-      pack(casadi_int(serialization_protocol_version));
-
+        out(out_s), debug_(false), binary_(false), pos_(0) {
       bool debug = false;
+      bool binary = false;
 
       // Read options
       for (auto&& op : opts) {
         if (op.first=="debug") {
           debug = op.second;
+        } else if (op.first=="binary") {
+          binary = op.second;
         } else {
           casadi_error("Unknown option: '" + op.first + "'.");
         }
       }
 
+      // Sanity check
+      pack(serialization_check);
+      // API version check
+      pack(binary ? serialization_protocol_version : serialization_protocol_version_text);
+
       pack(debug);
+      if (binary) pack(binary);
       debug_ = debug;
+      binary_ = binary;
     }
 
     void SerializingStream::decorate(char e) {
@@ -112,7 +126,7 @@ namespace casadi {
       int64_t n;
       char* c = reinterpret_cast<char*>(&n);
 
-      for (int j=0;j<8;++j) unpack(c[j]);
+      read(c, 8);
       e = n;
     }
 
@@ -120,14 +134,14 @@ namespace casadi {
       decorate('J');
       int64_t n = e;
       const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<8;++j) pack(c[j]);
+      write(c, 8);
     }
 
     void SerializingStream::pack(size_t e) {
       decorate('K');
       uint64_t n = e;
       const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<8;++j) pack(c[j]);
+      write(c, 8);
     }
 
     void DeserializingStream::unpack(size_t& e) {
@@ -135,7 +149,7 @@ namespace casadi {
       uint64_t n;
       char* c = reinterpret_cast<char*>(&n);
 
-      for (int j=0;j<8;++j) unpack(c[j]);
+      read(c, 8);
       e = n;
     }
 
@@ -144,7 +158,7 @@ namespace casadi {
       int32_t n;
       char* c = reinterpret_cast<char*>(&n);
 
-      for (int j=0;j<4;++j) unpack(c[j]);
+      read(c, 4);
       e = n;
     }
 
@@ -152,7 +166,7 @@ namespace casadi {
       decorate('i');
       int32_t n = e;
       const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<4;++j) pack(c[j]);
+      write(c, 4);
     }
 
 #if SIZE_MAX != UINT_MAX || defined(__EMSCRIPTEN__)
@@ -161,7 +175,7 @@ namespace casadi {
       uint32_t n;
       char* c = reinterpret_cast<char*>(&n);
 
-      for (int j=0;j<4;++j) unpack(c[j]);
+      read(c, 4);
       e = n;
     }
 
@@ -169,7 +183,7 @@ namespace casadi {
       decorate('u');
       uint32_t n = e;
       const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<4;++j) pack(c[j]);
+      write(c, 4);
     }
 #endif
 
@@ -186,28 +200,79 @@ namespace casadi {
     }
 
     void DeserializingStream::unpack(char& e) {
+      if (binary_) {
+        in.get(e);
+        pos_++;
+        return;
+      }
       unsigned char ref = 'a';
       in.get(e);
       char t;
       in.get(t);
+      pos_ += 2;
       e = (reinterpret_cast<unsigned char&>(e)-ref) +
           ((reinterpret_cast<unsigned char&>(t)-ref) << 4);
     }
 
     void SerializingStream::pack(char e) {
+      if (binary_) {
+        out.put(e);
+        pos_++;
+        return;
+      }
       unsigned char ref = 'a';
       // Note: outputstreams work neatly with std::hex,
       // but inputstreams don't
       out.put(ref + (reinterpret_cast<unsigned char&>(e) % 16));
       out.put(ref + (reinterpret_cast<unsigned char&>(e) >> 4));
+      pos_ += 2;
+    }
+
+    void DeserializingStream::read(char* c, size_t n) {
+      if (binary_) {
+        in.read(c, n);
+        pos_ += n;
+      } else {
+        for (size_t j=0;j<n;++j) unpack(c[j]);
+      }
+    }
+
+    void SerializingStream::write(const char* c, size_t n) {
+      if (binary_) {
+        out.write(c, n);
+        pos_ += n;
+      } else {
+        for (size_t j=0;j<n;++j) pack(c[j]);
+      }
+    }
+
+    void DeserializingStream::unpack_block(char* c, size_t n) {
+      // Skip padding
+      while (pos_ % serialization_block_alignment) {
+        in.get();
+        pos_++;
+      }
+      in.read(c, n);
+      casadi_assert(static_cast<size_t>(in.gcount())==n,
+        "DeserializingStream error: unexpected end of stream.");
+      pos_ += n;
+    }
+
+    void SerializingStream::pack_block(const char* c, size_t n) {
+      // Pad such that the block is aligned relative to the start of the stream
+      while (pos_ % serialization_block_alignment) {
+        out.put(0);
+        pos_++;
+      }
+      out.write(c, n);
+      pos_ += n;
     }
 
     void SerializingStream::pack(const std::string& e) {
       decorate('s');
       int s = static_cast<int>(e.size());
       pack(s);
-      const char* c = e.c_str();
-      for (int j = 0; j < s; ++j) pack(c[j]);
+      write(e.c_str(), s);
     }
 
     void DeserializingStream::unpack(std::string& e) {
@@ -215,19 +280,19 @@ namespace casadi {
       int s;
       unpack(s);
       e.resize(s);
-      for (int j=0;j<s;++j) unpack(e[j]);
+      if (s>0) read(&e[0], s);
     }
 
     void DeserializingStream::unpack(double& e) {
       assert_decoration('d');
       char* c = reinterpret_cast<char*>(&e);
-      for (int j=0;j<8;++j) unpack(c[j]);
+      read(c, 8);
     }
 
     void SerializingStream::pack(double e) {
       decorate('d');
       const char* c = reinterpret_cast<const char*>(&e);
-      for (int j=0;j<8;++j) pack(c[j]);
+      write(c, 8);
     }
 
     void SerializingStream::pack(const Sparsity& e) {
@@ -310,9 +375,7 @@ namespace casadi {
       for (size_t i=0;i<len;++i) {
         s.read(buffer, 1024);
         size_t c = s.gcount();
-        for (size_t j=0;j<c;++j) {
-          pack(buffer[j]);
-        }
+        write(buffer, c);
         if (s.rdstate() & std::ifstream::eofbit) break;
       }
     }
@@ -321,10 +384,12 @@ namespace casadi {
       assert_decoration('B');
       size_t len;
       unpack(len);
-      for (size_t i=0;i<len;++i) {
-        char c;
-        unpack(c);
-        s.put(c);
+      char buffer[1024];
+      while (len>0) {
+        size_t c = std::min(len, sizeof(buffer));
+        read(buffer, c);
+        s.write(buffer, c);
+        len -= c;
       }
     }
 
@@ -31,6 +31,7 @@
 #include <unordered_map>
 #include <cstdint>
 #include <climits>
+#include <type_traits>
 
 namespace casadi {
   class Slice;
@@ -63,6 +64,17 @@ namespace casadi {
   };
   typedef std::map<std::string, GenericType> Dict;
 
+  /// \cond INTERNAL
+  /** \brief Vector elements stored as one contiguous block in binary mode
+
+      The in-memory representation coincides with the serialized one.
+  */
+  template <class T>
+  struct is_bulk_serializable : std::integral_constant<bool,
+    std::is_same<T, double>::value || std::is_same<T, int>::value ||
+    (std::is_same<T, casadi_int>::value && sizeof(casadi_int)==8)> {};
+  /// \endcond
+
   /** \brief Helper class for Serialization
 
       \author Joris Gillis
@@ -114,7 +126,7 @@ namespace casadi {
       casadi_int s;
       unpack(s);
       e.resize(s);
-      for (T& i : e) unpack(i);
+      unpack_elements(e, is_bulk_serializable<T>());
     }
 
     template <class K, class V>
@@ -158,6 +170,27 @@ namespace casadi {
     void reset();
 
   private:
+    /// Unpack vector elements one by one
+    template <class T>
+    void unpack_elements(std::vector<T>& e, std::false_type) {
+      for (T& i : e) unpack(i);
+    }
+
+    /// Unpack vector elements, as a single block in binary mode
+    template <class T>
+    void unpack_elements(std::vector<T>& e, std::true_type) {
+      if (binary_) {
+        if (!e.empty()) unpack_block(reinterpret_cast<char*>(e.data()), e.size()*sizeof(T));
+      } else {
+        for (T& i : e) unpack(i);
+      }
+    }
+
+    /// Read raw bytes
+    void read(char* c, size_t n);
+
+    /// Read an aligned block of raw bytes (binary mode)
+    void unpack_block(char* c, size_t n);
 
     /** \brief Unpacks a shared object
     *
@@ -201,6 +234,10 @@ namespace casadi {
     std::istream& in;
     /// Debug mode?
     bool debug_;
+    /// Raw binary encoding?
+    bool binary_;
+    /// Number of characters consumed
+    size_t pos_;
   };
 
   /** \brief Helper class for Serialization
@@ -249,7 +286,7 @@ namespace casadi {
     void pack(const std::vector<T>& e) {
       decorate('V');
       pack(static_cast<casadi_int>(e.size()));
-      for (auto&& i : e) pack(i);
+      pack_elements(e, is_bulk_serializable<T>());
     }
     template <class K, class V>
     void pack(const std::map<K, V>& e) {
@@ -284,6 +321,28 @@ namespace casadi {
     void reset();
 
   private:
+    /// Pack vector elements one by one
+    template <class T>
+    void pack_elements(const std::vector<T>& e, std::false_type) {
+      for (auto&& i : e) pack(i);
+    }
+
+    /// Pack vector elements, as a single block in binary mode
+    template <class T>
+    void pack_elements(const std::vector<T>& e, std::true_type) {
+      if (binary_) {
+        if (!e.empty()) pack_block(reinterpret_cast<const char*>(e.data()), e.size()*sizeof(T));
+      } else {
+        for (auto&& i : e) pack(i);
+      }
+    }
+
+    /// Write raw bytes
+    void write(const char* c, size_t n);
+
+    /// Write a block of raw bytes, aligned in the stream (binary mode)
+    void pack_block(const char* c, size_t n);
+
     /** \brief Insert information for a primitive typecheck during deserialization
      *
      * No-op unless in debug mode
@@ -319,6 +378,10 @@ namespace casadi {
     std::ostream& out;
     /// Debug mode?
     bool debug_;
+    /// Raw binary encoding?
+    bool binary_;
+    /// Number of characters written
+    size_t pos_;
   };
 
   template <>
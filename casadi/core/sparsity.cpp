@@ -757,6 +757,20 @@ namespace casadi {
     return (*this)->star_coloring(ordering, cutoff);
   }
 
+  Sparsity Sparsity::uni_coloring(const Sparsity& AT, casadi_int cutoff,
+                                  casadi_int ordering, casadi_int num_threads) const {
+    if (AT.is_null()) {
+      return (*this)->uni_coloring(T(), cutoff, ordering, num_threads);
+    } else {
+      return (*this)->uni_coloring(AT, cutoff, ordering, num_threads);
+    }
+  }
+
+  Sparsity Sparsity::star_coloring(casadi_int ordering, casadi_int cutoff,
+                                   casadi_int num_threads) const {
+    return (*this)->star_coloring(ordering, cutoff, num_threads);
+  }
+
   Sparsity Sparsity::star_coloring2(casadi_int ordering, casadi_int cutoff) const {
     return (*this)->star_coloring2(ordering, cutoff);
   }
@@ -1063,6 +1063,29 @@ namespace casadi {
     Sparsity star_coloring2(casadi_int ordering = 1,
                             casadi_int cutoff = std::numeric_limits<casadi_int>::max()) const;
 
+    /** \brief Unidirectional coloring with a vertex ordering, possibly in parallel
+
+        Greedy distance-2 coloring of the columns, visited in the given order.
+        Ordering options: None (0), largest first (1), smallest last (2),
+        incidence degree (3), with the degrees in the column intersection graph.
+
+        With num_threads>1, the columns are colored speculatively in parallel
+        and the conflicts are resolved sequentially afterwards. */
+    Sparsity uni_coloring(const Sparsity& AT, casadi_int cutoff,
+                          casadi_int ordering, casadi_int num_threads=1) const;
+
+    /** \brief Star coloring with a vertex ordering, possibly in parallel
+
+        Algorithm 4.1 in GEBREMEDHIN, MANNE, POTHEN (2006) with the vertices
+        visited in the given order.
+        Ordering options: None (0), largest first (1), smallest last (2),
+        incidence degree (3).
+
+        With num_threads>1, the vertices are colored speculatively in parallel
+        and the conflicts are resolved sequentially afterwards. */
+    Sparsity star_coloring(casadi_int ordering, casadi_int cutoff,
+                           casadi_int num_threads) const;
+
     /** \brief Order the columns by decreasing degree
 
         \identifier{de} */
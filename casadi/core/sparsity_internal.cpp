@@ -27,6 +27,8 @@
 #include "sparsity_internal.hpp"
 #include "casadi_misc.hpp"
 #include "global_options.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
 #include <climits>
 #include <cstdlib>
 #include <cmath>
@@ -3399,6 +3401,379 @@ namespace casadi {
     return Sparsity::triplet(size2(), num_colors, range(color.size()), color);
   }
 
+  /// \cond INTERNAL
+  namespace {
+    // Graph of the columns to be colored: either the adjacency graph of a symmetric
+    // pattern or, if the transpose is given, the column intersection graph,
+    // which is never formed explicitly
+    struct ColoringGraph {
+      casadi_int n;
+      const casadi_int *colind, *row;
+      const casadi_int *AT_colind, *AT_row;
+
+      // Call f for the neighbors of v, possibly repeatedly
+      template<typename F>
+      void for_each_neighbor(casadi_int v, const F& f) const {
+        for (casadi_int el=colind[v]; el<colind[v+1]; ++el) {
+          casadi_int r = row[el];
+          if (AT_colind) {
+            for (casadi_int el2=AT_colind[r]; el2<AT_colind[r+1]; ++el2) {
+              if (AT_row[el2]!=v) f(AT_row[el2]);
+            }
+          } else if (r!=v) {
+            f(r);
+          }
+        }
+      }
+
+      // Call f once for each neighbor of v, marker must not contain v on entry
+      template<typename F>
+      void for_each_distinct_neighbor(casadi_int v, std::vector<casadi_int>& marker,
+          const F& f) const {
+        for_each_neighbor(v, [&](casadi_int j) {
+          if (marker[j]!=v) {
+            marker[j] = v;
+            f(j);
+          }
+        });
+      }
+    };
+
+    // Visiting order for greedy coloring
+    std::vector<casadi_int> coloring_order(const ColoringGraph& g, casadi_int ordering) {
+      std::vector<casadi_int> order(g.n);
+      if (ordering==0) return range(g.n);
+
+      // Degrees
+      std::vector<casadi_int> marker(g.n, -1), deg(g.n, 0);
+      casadi_int max_deg = 0;
+      for (casadi_int v=0; v<g.n; ++v) {
+        g.for_each_distinct_neighbor(v, marker, [&](casadi_int) { deg[v]++;});
+        max_deg = std::max(max_deg, deg[v]);
+      }
+
+      // Largest first: bucket sort by decreasing degree
+      if (ordering==1) {
+        std::vector<casadi_int> count(max_deg+2, 0);
+        for (casadi_int v=0; v<g.n; ++v) count[max_deg-deg[v]+1]++;
+        for (casadi_int d=0; d<=max_deg; ++d) count[d+1] += count[d];
+        for (casadi_int v=0; v<g.n; ++v) order[count[max_deg-deg[v]]++] = v;
+        return order;
+      }
+
+      // Doubly linked lists of vertices with the same key
+      std::vector<casadi_int> head(max_deg+1, -1), next(g.n), prev(g.n);
+      auto insert = [&](casadi_int v, casadi_int k) {
+        prev[v] = -1;
+        next[v] = head[k];
+        if (head[k]>=0) prev[head[k]] = v;
+        head[k] = v;
+      };
+      auto remove = [&](casadi_int v, casadi_int k) {
+        if (prev[v]>=0) {
+          next[prev[v]] = next[v];
+        } else {
+          head[k] = next[v];
+        }
+        if (next[v]>=0) prev[next[v]] = prev[v];
+      };
+      std::fill(marker.begin(), marker.end(), -1);
+      std::vector<bool> done(g.n, false);
+
+      if (ordering==2) {
+        // Smallest last: remove vertices of minimum degree in the remaining graph,
+        // to be colored in reverse order of removal
+        for (casadi_int v=g.n-1; v>=0; --v) insert(v, deg[v]);
+        casadi_int k = 0;
+        for (casadi_int pos=g.n-1; pos>=0; --pos) {
+          while (head[k]<0) k++;
+          casadi_int v = head[k];
+          remove(v, k);
+          done[v] = true;
+          order[pos] = v;
+          g.for_each_distinct_neighbor(v, marker, [&](casadi_int u) {
+            if (!done[u] && deg[u]>0) {
+              remove(u, deg[u]);
+              insert(u, --deg[u]);
+            }
+          });
+          k = std::max(k-1, casadi_int(0));
+        }
+      } else {
+        casadi_assert(ordering==3, "Unknown ordering " + str(ordering));
+        // Incidence degree: pick a vertex with the most neighbors already ordered
+        std::vector<casadi_int>& inc = deg;
+        std::fill(inc.begin(), inc.end(), 0);
+        for (casadi_int v=g.n-1; v>=0; --v) insert(v, 0);
+        casadi_int k = 0;
+        for (casadi_int pos=0; pos<g.n; ++pos) {
+          while (head[k]<0) k--;
+          casadi_int v = head[k];
+          remove(v, k);
+          done[v] = true;
+          order[pos] = v;
+          g.for_each_distinct_neighbor(v, marker, [&](casadi_int u) {
+            if (!done[u] && inc[u]<max_deg) {
+              remove(u, inc[u]);
+              insert(u, ++inc[u]);
+              k = std::max(k, inc[u]);
+            }
+          });
+        }
+      }
+      return order;
+    }
+
+    // Colors forbidden for a vertex, as a bit set cleared in time proportional to its use
+    class ForbiddenColors {
+    public:
+      void forbid(casadi_int c) {
+        size_t w = c/64;
+        if (w>=bits_.size()) bits_.resize(w+1, 0);
+        if (bits_[w]==0) touched_.push_back(w);
+        bits_[w] |= uint64_t(1) << (c%64);
+      }
+      casadi_int first_allowed() const {
+        for (size_t w=0; w<bits_.size(); ++w) {
+          uint64_t free = ~bits_[w];
+          if (free) return 64*w + ctz(free);
+        }
+        return 64*bits_.size();
+      }
+      void clear() {
+        for (size_t w : touched_) bits_[w] = 0;
+        touched_.clear();
+      }
+    private:
+      static casadi_int ctz(uint64_t x) {
+#if defined(__GNUC__)
+        return __builtin_ctzll(x);
+#else
+        casadi_int r = 0;
+        while (!(x & 1)) {
+          x >>= 1;
+          r++;
+        }
+        return r;
+#endif
+      }
+      std::vector<uint64_t> bits_;
+      std::vector<size_t> touched_;
+    };
+
+    // Colors shared between threads, -1 if uncolored
+    typedef std::atomic<casadi_int> AtomicColor;
+
+    // Work vectors of a thread
+    struct ColoringWork {
+      ForbiddenColors forbidden;
+      // Number of neighbors with a given color, valid if stamp equals gen
+      std::vector<casadi_int> stamp, count;
+      casadi_int gen;
+      explicit ColoringWork(casadi_int n) : stamp(n+1, -1), count(n+1, 0), gen(-1) {}
+
+      // Start counting
+      void reset() { gen++;}
+
+      // Count a color, returning the updated count
+      casadi_int add(casadi_int c) {
+        if (stamp[c]!=gen) {
+          stamp[c] = gen;
+          count[c] = 0;
+        }
+        return ++count[c];
+      }
+
+      // Number of times a color has been counted
+      casadi_int get(casadi_int c) const { return stamp[c]==gen ? count[c] : 0;}
+
+      // Count the colors of the neighbors of v
+      void count_colors(const ColoringGraph& g, casadi_int v, const AtomicColor* color) {
+        reset();
+        g.for_each_neighbor(v, [&](casadi_int w) {
+          casadi_int cw = color[w].load(std::memory_order_relaxed);
+          if (cw>=0) add(cw);
+        });
+      }
+    };
+
+    // Color a vertex given the colors of the other vertices
+    casadi_int color_vertex(const ColoringGraph& g, bool star, casadi_int v,
+        AtomicColor* color, ColoringWork& work) {
+      auto get = [&](casadi_int j) { return color[j].load(std::memory_order_relaxed);};
+      ForbiddenColors& fc = work.forbidden;
+      fc.clear();
+      if (!star) {
+        // Distance-2 coloring: colors of all columns sharing a row
+        g.for_each_neighbor(v, [&](casadi_int w) {
+          casadi_int cw = get(w);
+          if (cw>=0) fc.forbid(cw);
+        });
+      } else {
+        // Star coloring (Algorithm 4.1 in A. H. GEBREMEDHIN, F. MANNE, A. POTHEN)
+        bool repeated = false;
+        work.reset();
+        g.for_each_neighbor(v, [&](casadi_int w) {
+          casadi_int cw = get(w);
+          if (cw>=0) {
+            fc.forbid(cw);
+            if (work.add(cw)>=2) repeated = true;
+          }
+          g.for_each_neighbor(w, [&](casadi_int x) {
+            casadi_int cx = get(x);
+            if (x==v || cx<0) return;
+            if (cw<0) {
+              fc.forbid(cx);
+            } else {
+              bool found = false;
+              g.for_each_neighbor(x, [&](casadi_int y) {
+                if (!found && y!=w && get(y)==cw) found = true;
+              });
+              if (found) fc.forbid(cx);
+            }
+          });
+        });
+        // Two neighbors with the same color, only possible when recoloring after
+        // speculative coloring: v is then the middle of a path w-v-w'-x
+        if (repeated) {
+          g.for_each_neighbor(v, [&](casadi_int w) {
+            casadi_int cw = get(w);
+            if (cw<0 || work.get(cw)<2) return;
+            g.for_each_neighbor(w, [&](casadi_int x) {
+              casadi_int cx = get(x);
+              if (x!=v && cx>=0) fc.forbid(cx);
+            });
+          });
+        }
+      }
+      casadi_int c = fc.first_allowed();
+      color[v].store(c, std::memory_order_relaxed);
+      return c;
+    }
+
+    // Greedy coloring of the vertices in a given order
+    Sparsity greedy_coloring(const ColoringGraph& g, bool star, casadi_int ordering,
+        casadi_int cutoff, casadi_int num_threads) {
+      // Visiting order
+      std::vector<casadi_int> order = coloring_order(g, ordering);
+
+      // Colors
+      std::unique_ptr<AtomicColor[]> color(new AtomicColor[g.n]);
+      for (casadi_int v=0; v<g.n; ++v) color[v].store(-1, std::memory_order_relaxed);
+      casadi_int num_colors = 0;
+
+      if (num_threads<=1) {
+        // Sequential
+        ColoringWork work(g.n);
+        for (casadi_int v : order) {
+          num_colors = std::max(num_colors, color_vertex(g, star, v, color.get(), work) + 1);
+          // Cutoff if too many colors
+          if (num_colors>cutoff) return Sparsity();
+        }
+      } else {
+        // Speculative coloring in parallel, chunks of vertices colored concurrently
+        // may be in conflict with each other
+        ThreadPool& pool = ThreadPool::instance();
+        std::vector<ColoringWork> work(num_threads, ColoringWork(g.n));
+        const casadi_int chunk = 256;
+        pool.run(g.n, num_threads, chunk,
+            [&](casadi_int slot, casadi_int begin, casadi_int end) {
+          for (casadi_int k=begin; k<end; ++k) {
+            color_vertex(g, star, order[k], color.get(), work[slot]);
+          }
+        });
+
+        // Detect conflicts, each vertex only marking itself
+        std::vector<char> conflict(g.n, 0);
+        if (!star) {
+          // Columns sharing a row with a column of lower index and the same color
+          pool.run(g.n, num_threads, chunk,
+              [&](casadi_int, casadi_int begin, casadi_int end) {
+            for (casadi_int v=begin; v<end; ++v) {
+              casadi_int cv = color[v].load(std::memory_order_relaxed);
+              g.for_each_neighbor(v, [&](casadi_int w) {
+                if (w<v && color[w].load(std::memory_order_relaxed)==cv) conflict[v] = 1;
+              });
+            }
+          });
+        } else {
+          // Edges (v, w) whose endpoints both have two neighbors with the color of the
+          // other endpoint are the middle of a path with two colors
+          std::vector<char> flag(g.colind[g.n]);
+          pool.run(g.n, num_threads, chunk,
+              [&](casadi_int slot, casadi_int begin, casadi_int end) {
+            ColoringWork& w = work[slot];
+            for (casadi_int v=begin; v<end; ++v) {
+              w.count_colors(g, v, color.get());
+              casadi_int cv = color[v].load(std::memory_order_relaxed);
+              for (casadi_int el=g.colind[v]; el<g.colind[v+1]; ++el) {
+                casadi_int cr = color[g.row[el]].load(std::memory_order_relaxed);
+                flag[el] = g.row[el]!=v && w.get(cr)>=2;
+                // Adjacent vertices with the same color
+                if (cr==cv && g.row[el]<v) conflict[v] = 1;
+              }
+            }
+          });
+          // Nonzero of the transposed entry, the pattern being symmetric
+          std::vector<casadi_int> tmap(g.colind[g.n]);
+          std::vector<casadi_int> pos(g.colind, g.colind+g.n);
+          for (casadi_int v=0; v<g.n; ++v) {
+            for (casadi_int el=g.colind[v]; el<g.colind[v+1]; ++el) {
+              tmap[pos[g.row[el]]++] = el;
+            }
+          }
+          pool.run(g.n, num_threads, chunk,
+              [&](casadi_int, casadi_int begin, casadi_int end) {
+            for (casadi_int v=begin; v<end; ++v) {
+              for (casadi_int el=g.colind[v]; el<g.colind[v+1]; ++el) {
+                if (g.row[el]<v && flag[el] && flag[tmap[el]]) conflict[v] = 1;
+              }
+            }
+          });
+        }
+
+        // Recolor vertices in conflict sequentially
+        for (casadi_int v=0; v<g.n; ++v) {
+          if (conflict[v]) color[v].store(-1, std::memory_order_relaxed);
+        }
+        for (casadi_int v : order) {
+          if (conflict[v]) color_vertex(g, star, v, color.get(), work[0]);
+        }
+        for (casadi_int v=0; v<g.n; ++v) {
+          num_colors = std::max(num_colors, color[v].load(std::memory_order_relaxed) + 1);
+        }
+        // Cutoff if too many colors
+        if (num_colors>cutoff) return Sparsity();
+      }
+
+      // Create return sparsity containing the coloring
+      std::vector<casadi_int> ret_colind(num_colors+1, 0), ret_row(g.n);
+      for (casadi_int v=0; v<g.n; ++v) ret_colind[color[v].load()+1]++;
+      for (casadi_int c=0; c<num_colors; ++c) ret_colind[c+1] += ret_colind[c];
+      std::vector<casadi_int> pos(ret_colind.begin(), ret_colind.end()-1);
+      for (casadi_int v=0; v<g.n; ++v) ret_row[pos[color[v].load()]++] = v;
+      return Sparsity(g.n, num_colors, ret_colind, ret_row);
+    }
+  } // namespace
+  /// \endcond
+
+  Sparsity SparsityInternal::uni_coloring(const Sparsity& AT, casadi_int cutoff,
+      casadi_int ordering, casadi_int num_threads) const {
+    ColoringGraph g = {size2(), colind(), row(), AT.colind(), AT.row()};
+    return greedy_coloring(g, false, ordering, cutoff, num_threads);
+  }
+
+  Sparsity SparsityInternal::star_coloring(casadi_int ordering, casadi_int cutoff,
+      casadi_int num_threads) const {
+    if (!is_square()) {
+      casadi_message("StarColoring requires a square matrix, got " + dim() + ".");
+    }
+    // Conflict detection relies on a symmetric pattern
+    if (num_threads>1 && !is_symmetric()) num_threads = 1;
+    ColoringGraph g = {size2(), colind(), row(), nullptr, nullptr};
+    return greedy_coloring(g, true, ordering, cutoff, num_threads);
+  }
+
   std::vector<casadi_int> SparsityInternal::largest_first() const {
     std::vector<casadi_int> degree = get_colind();
     casadi_int max_degree = 0;
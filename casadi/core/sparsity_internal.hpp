@@ -720,6 +720,18 @@ namespace casadi {
         \identifier{fp} */
     Sparsity star_coloring2(casadi_int ordering, casadi_int cutoff) const;
 
+    /** \brief Unidirectional coloring with a vertex ordering, possibly in parallel
+
+     * See description in public class. */
+    Sparsity uni_coloring(const Sparsity& AT, casadi_int cutoff,
+                          casadi_int ordering, casadi_int num_threads) const;
+
+    /** \brief Star coloring with a vertex ordering, possibly in parallel
+
+     * See description in public class. */
+    Sparsity star_coloring(casadi_int ordering, casadi_int cutoff,
+                           casadi_int num_threads) const;
+
     /// Order the columns by decreasing degree
     std::vector<casadi_int> largest_first() const;
 
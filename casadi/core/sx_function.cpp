@@ -34,6 +34,7 @@
 #include "sparsity_internal.hpp"
 #include "casadi_interrupt.hpp"
 #include "serializing_stream.hpp"
+#include "native_code.hpp"
 
 namespace casadi {
 
@@ -47,10 +48,15 @@ namespace casadi {
     // Default (persistent) options
     just_in_time_opencl_ = false;
     just_in_time_sparsity_ = false;
+    fuse_instructions_ = true;
+    n_fused_ = 0;
+    just_in_time_native_ = false;
+    native_ = nullptr;
   }
 
   SXFunction::~SXFunction() {
     clear_mem();
+    delete native_;
   }
 
   int SXFunction::eval(const double** arg, double** res,
@@ -69,6 +75,83 @@ namespace casadi {
     // class structure can cause large performance losses. For this reason,
     // the preprocessor macros are used below
 
+    // Evaluate the machine code translation, if any
+    if (native_) return (*native_)(arg, res, w);
+
+    // Evaluate the fused program, if any
+    if (!program_.empty()) {
+      const FusedAtomic* e = program_.data();
+
+      // Instruction bodies, shared between the switch and computed goto dispatch
+#define CASADI_SX_INPUT(I, NZ) (arg[I]==nullptr ? 0 : arg[I][NZ])
+#define CASADI_SX_EXEC(CASE, NEXT) \
+      CASE(EXEC_GENERIC) casadi_math<double>::fun(e->op, w[e->i1], w[e->i2], w[e->i0]); NEXT; \
+      CASE(EXEC_CONST) w[e->i0] = e->d; NEXT; \
+      CASE(EXEC_INPUT) w[e->i0] = CASADI_SX_INPUT(e->i1, e->i2); NEXT; \
+      CASE(EXEC_OUTPUT) if (res[e->i0]!=nullptr) res[e->i0][e->i2] = w[e->i1]; NEXT; \
+      CASE(EXEC_ADD) w[e->i0] = w[e->i1] + w[e->i2]; NEXT; \
+      CASE(EXEC_SUB) w[e->i0] = w[e->i1] - w[e->i2]; NEXT; \
+      CASE(EXEC_MUL) w[e->i0] = w[e->i1] * w[e->i2]; NEXT; \
+      CASE(EXEC_DIV) w[e->i0] = w[e->i1] / w[e->i2]; NEXT; \
+      CASE(EXEC_NEG) w[e->i0] = -w[e->i1]; NEXT; \
+      CASE(EXEC_SQ) w[e->i0] = w[e->i1] * w[e->i1]; NEXT; \
+      CASE(EXEC_FMA) w[e->i0] = w[e->i1] * w[e->i2] + w[e->i3]; NEXT; \
+      CASE(EXEC_FMS) w[e->i0] = w[e->i1] * w[e->i2] - w[e->i3]; NEXT; \
+      CASE(EXEC_ADD_C) w[e->i0] = w[e->i1] + e->d; NEXT; \
+      CASE(EXEC_SUB_C) w[e->i0] = w[e->i1] - e->d; NEXT; \
+      CASE(EXEC_MUL_C) w[e->i0] = w[e->i1] * e->d; NEXT; \
+      CASE(EXEC_DIV_C) w[e->i0] = w[e->i1] / e->d; NEXT; \
+      CASE(EXEC_RSUB_C) w[e->i0] = e->d - w[e->i1]; NEXT; \
+      CASE(EXEC_RDIV_C) w[e->i0] = e->d / w[e->i1]; NEXT; \
+      CASE(EXEC_INPUT_ADD) w[e->i0] = CASADI_SX_INPUT(e->i1, e->i2) + w[e->i3]; NEXT; \
+      CASE(EXEC_INPUT_SUB) w[e->i0] = CASADI_SX_INPUT(e->i1, e->i2) - w[e->i3]; NEXT; \
+      CASE(EXEC_INPUT_MUL) w[e->i0] = CASADI_SX_INPUT(e->i1, e->i2) * w[e->i3]; NEXT; \
+      CASE(EXEC_INPUT_DIV) w[e->i0] = CASADI_SX_INPUT(e->i1, e->i2) / w[e->i3]; NEXT; \
+      CASE(EXEC_INPUT_RSUB) w[e->i0] = w[e->i3] - CASADI_SX_INPUT(e->i1, e->i2); NEXT; \
+      CASE(EXEC_INPUT_RDIV) w[e->i0] = w[e->i3] / CASADI_SX_INPUT(e->i1, e->i2); NEXT; \
+      CASE(EXEC_ADD_OUTPUT) if (res[e->i0]!=nullptr) res[e->i0][e->i3] = w[e->i1] + w[e->i2]; NEXT; \
+      CASE(EXEC_SUB_OUTPUT) if (res[e->i0]!=nullptr) res[e->i0][e->i3] = w[e->i1] - w[e->i2]; NEXT; \
+      CASE(EXEC_MUL_OUTPUT) if (res[e->i0]!=nullptr) res[e->i0][e->i3] = w[e->i1] * w[e->i2]; NEXT; \
+      CASE(EXEC_DIV_OUTPUT) if (res[e->i0]!=nullptr) res[e->i0][e->i3] = w[e->i1] / w[e->i2]; NEXT;
+
+#if defined(CASADI_WITH_COMPUTED_GOTO) && defined(__GNUC__)
+      // Direct threading: jump straight to the next instruction body
+      static const void* const dispatch[] = {
+        &&exec_EXEC_END, &&exec_EXEC_GENERIC, &&exec_EXEC_CONST, &&exec_EXEC_INPUT,
+        &&exec_EXEC_OUTPUT, &&exec_EXEC_ADD, &&exec_EXEC_SUB, &&exec_EXEC_MUL,
+        &&exec_EXEC_DIV, &&exec_EXEC_NEG, &&exec_EXEC_SQ, &&exec_EXEC_FMA, &&exec_EXEC_FMS,
+        &&exec_EXEC_ADD_C, &&exec_EXEC_SUB_C, &&exec_EXEC_MUL_C, &&exec_EXEC_DIV_C,
+        &&exec_EXEC_RSUB_C, &&exec_EXEC_RDIV_C,
+        &&exec_EXEC_INPUT_ADD, &&exec_EXEC_INPUT_SUB, &&exec_EXEC_INPUT_MUL,
+        &&exec_EXEC_INPUT_DIV, &&exec_EXEC_INPUT_RSUB, &&exec_EXEC_INPUT_RDIV,
+        &&exec_EXEC_ADD_OUTPUT, &&exec_EXEC_SUB_OUTPUT, &&exec_EXEC_MUL_OUTPUT,
+        &&exec_EXEC_DIV_OUTPUT};
+      static_assert(sizeof(dispatch)/sizeof(*dispatch)==EXEC_NUM, "Dispatch table mismatch");
+#define CASADI_SX_LABEL(C) exec_##C:
+#define CASADI_SX_NEXT ++e; goto *dispatch[e->code]
+      goto *dispatch[e->code];
+      CASADI_SX_EXEC(CASADI_SX_LABEL, CASADI_SX_NEXT)
+      exec_EXEC_END:
+      return 0;
+#undef CASADI_SX_LABEL
+#undef CASADI_SX_NEXT
+#else // CASADI_WITH_COMPUTED_GOTO
+#define CASADI_SX_CASE(C) case C:
+      for (;; ++e) {
+        switch (e->code) {
+          CASADI_SX_EXEC(CASADI_SX_CASE, break)
+        case EXEC_END:
+          return 0;
+        default:
+          casadi_error("Unknown operation" + str(e->op));
+        }
+      }
+#undef CASADI_SX_CASE
+#endif // CASADI_WITH_COMPUTED_GOTO
+#undef CASADI_SX_EXEC
+#undef CASADI_SX_INPUT
+    }
+
     // Evaluate the algorithm
     for (auto&& e : algorithm_) {
       switch (e.op) {
@@ -84,6 +167,179 @@ namespace casadi {
     return 0;
   }
 
+  int SXFunction::eval_batch(const double** arg, double** res, double* w,
+      casadi_int n, casadi_int batch) const {
+    // Make sure no free parameters
+    casadi_assert(free_vars_.empty(),
+      "Cannot evaluate \"" + name_ + "\" since variables " + str(free_vars_) + " are free.");
+
+    // Evaluate the algorithm, one instruction at a time for the whole batch
+    for (auto&& e : algorithm_) {
+      double* f = w + e.i0*batch;
+      switch (e.op) {
+        CASADI_MATH_FUN_BUILTIN_GEN(BinaryOperationVV, w + e.i1*batch, w + e.i2*batch, f, batch)
+
+      case OP_CONST:
+        std::fill_n(f, batch, e.d);
+        break;
+      case OP_INPUT:
+        {
+          const double* a = arg[e.i1];
+          casadi_int nz = nnz_in(e.i1);
+          for (casadi_int k=0; k<batch; ++k) f[k] = a && k<n ? a[k*nz + e.i2] : 0;
+        }
+        break;
+      case OP_OUTPUT:
+        {
+          double* r = res[e.i0];
+          const double* a = w + e.i1*batch;
+          casadi_int nz = nnz_out(e.i0);
+          if (r) for (casadi_int k=0; k<n; ++k) r[k*nz + e.i2] = a[k];
+        }
+        break;
+      default:
+        casadi_error("Unknown operation" + str(e.op));
+      }
+    }
+    return 0;
+  }
+
+  void SXFunction::init_program() {
+    program_.clear();
+    n_fused_ = 0;
+    if (!fuse_instructions_ || !free_vars_.empty()) return;
+
+    // Number of reads of the value defined by each instruction
+    std::vector<casadi_int> n_use(algorithm_.size(), 0);
+    // Instruction that last wrote to each work vector element
+    std::vector<casadi_int> last_def(worksize_, -1);
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      const AlgEl& a = algorithm_[k];
+      casadi_int ndeps = casadi_math<double>::ndeps(a.op);
+      if (ndeps>=1) n_use.at(last_def.at(a.i1))++;
+      if (ndeps==2) n_use.at(last_def.at(a.i2))++;
+      if (a.op!=OP_OUTPUT) last_def.at(a.i0) = k;
+    }
+
+    // Dispatch code for an unfused instruction
+    auto single = [](const AlgEl& a) {
+      FusedAtomic f;
+      f.op = a.op;
+      f.i0 = a.i0;
+      f.i1 = a.i1;
+      f.i2 = a.i2;
+      f.i3 = 0;
+      f.d = 0;
+      switch (a.op) {
+        case OP_CONST: f.code = EXEC_CONST; f.d = a.d; break;
+        case OP_INPUT: f.code = EXEC_INPUT; break;
+        case OP_OUTPUT: f.code = EXEC_OUTPUT; break;
+        case OP_ADD: f.code = EXEC_ADD; break;
+        case OP_SUB: f.code = EXEC_SUB; break;
+        case OP_MUL: f.code = EXEC_MUL; break;
+        case OP_DIV: f.code = EXEC_DIV; break;
+        case OP_NEG: f.code = EXEC_NEG; break;
+        case OP_SQ: f.code = EXEC_SQ; break;
+        default: f.code = EXEC_GENERIC;
+      }
+      return f;
+    };
+
+    // Is op one of the arithmetic operations that can be fused
+    auto arith = [](casadi_int op) {
+      return op==OP_ADD || op==OP_SUB || op==OP_MUL || op==OP_DIV;
+    };
+
+    // Fuse pairs of consecutive instructions, where the second one is the only user of the first
+    program_.reserve(algorithm_.size() + 1);
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      const AlgEl& a = algorithm_[k];
+      FusedAtomic f = single(a);
+      if (k+1<algorithm_.size() && a.op!=OP_OUTPUT && n_use[k]==1) {
+        const AlgEl& b = algorithm_[k+1];
+        // Does b read the result of a as first or second argument
+        bool first = b.i1==a.i0, second = casadi_math<double>::ndeps(b.op)==2 && b.i2==a.i0;
+        if (a.op==OP_MUL && b.op==OP_ADD && first!=second) {
+          // Multiply-add
+          f.code = EXEC_FMA;
+          f.op = b.op;
+          f.i0 = b.i0;
+          f.i3 = first ? b.i2 : b.i1;
+        } else if (a.op==OP_MUL && b.op==OP_SUB && first && !second) {
+          // Multiply-subtract
+          f.code = EXEC_FMS;
+          f.op = b.op;
+          f.i0 = b.i0;
+          f.i3 = b.i2;
+        } else if (a.op==OP_CONST && arith(b.op) && first!=second) {
+          // Operation with a constant operand
+          f.op = b.op;
+          f.i0 = b.i0;
+          f.i1 = first ? b.i2 : b.i1;
+          f.d = a.d;
+          switch (b.op) {
+            case OP_ADD: f.code = EXEC_ADD_C; break;
+            case OP_MUL: f.code = EXEC_MUL_C; break;
+            case OP_SUB: f.code = first ? EXEC_RSUB_C : EXEC_SUB_C; break;
+            case OP_DIV: f.code = first ? EXEC_RDIV_C : EXEC_DIV_C; break;
+          }
+        } else if (a.op==OP_INPUT && arith(b.op) && first!=second) {
+          // Operation on an input nonzero
+          f.op = b.op;
+          f.i0 = b.i0;
+          f.i3 = first ? b.i2 : b.i1;
+          switch (b.op) {
+            case OP_ADD: f.code = EXEC_INPUT_ADD; break;
+            case OP_MUL: f.code = EXEC_INPUT_MUL; break;
+            case OP_SUB: f.code = first ? EXEC_INPUT_SUB : EXEC_INPUT_RSUB; break;
+            case OP_DIV: f.code = first ? EXEC_INPUT_DIV : EXEC_INPUT_RDIV; break;
+          }
+        } else if (arith(a.op) && b.op==OP_OUTPUT && first) {
+          // Operation writing directly to an output
+          f.i0 = b.i0;
+          f.i3 = b.i2;
+          switch (a.op) {
+            case OP_ADD: f.code = EXEC_ADD_OUTPUT; break;
+            case OP_SUB: f.code = EXEC_SUB_OUTPUT; break;
+            case OP_MUL: f.code = EXEC_MUL_OUTPUT; break;
+            case OP_DIV: f.code = EXEC_DIV_OUTPUT; break;
+          }
+        }
+        if (f.code>=EXEC_FMA) {
+          // Skip the instruction that was fused
+          n_fused_++;
+          k++;
+        }
+      }
+      program_.push_back(f);
+    }
+
+    // Terminate
+    FusedAtomic f;
+    f.code = EXEC_END;
+    f.op = OP_OUTPUT;
+    f.i0 = f.i1 = f.i2 = f.i3 = 0;
+    f.d = 0;
+    program_.push_back(f);
+  }
+
+  void SXFunction::init_native() {
+    delete native_;
+    native_ = nullptr;
+    if (!just_in_time_native_) return;
+    if (!NativeCode::is_supported()) {
+      casadi_warning(name_ + ": Native code generation is not supported on this platform, "
+        "falling back to interpretation.");
+      return;
+    }
+    if (!free_vars_.empty()) return;
+    native_ = new NativeCode(algorithm_, worksize_);
+    if (verbose_) {
+      casadi_message(str(native_->size()) + " bytes of machine code, "
+        + str(native_->n_generic()) + " instructions evaluated by call");
+    }
+  }
+
   bool SXFunction::is_smooth() const {
     // Go through all nodes and check if any node is non-smooth
     for (auto&& a : algorithm_) {
@@ -133,6 +389,16 @@ namespace casadi {
       }
       stream << ";";
     }
+    stream << std::endl << "Work vector of " << worksize_ << " elements, "
+      << "estimated cache footprint " << w_footprint() << " bytes";
+    if (n_fused_>0) {
+      stream << std::endl << "Evaluated as " << (program_.size()-1) << " instructions, "
+        << n_fused_ << " of which superinstructions";
+    }
+    if (native_) {
+      stream << std::endl << "Translated to " << native_->size() << " bytes of machine code, "
+        << native_->n_generic() << " instructions evaluated by call";
+    }
   }
 
   void SXFunction::codegen_declarations(CodeGenerator& g) const {
@@ -172,6 +438,38 @@ namespace casadi {
     }
   }
 
+  void SXFunction::codegen_batch(CodeGenerator& g, casadi_int batch) const {
+    // Work vector element for lane k
+    auto lane = [batch](casadi_int i) { return "w[" + str(i*batch) + "+k]"; };
+    // Loop over all lanes
+    std::string all = "for (k=0; k<" + str(batch) + "; ++k) ";
+
+    // Run the algorithm
+    for (auto&& a : algorithm_) {
+      if (a.op==OP_OUTPUT) {
+        g << "if (res1[" << a.i0 << "]) for (k=0; k<nb; ++k) res1[" << a.i0 << "][k*"
+          << nnz_out(a.i0) << "+" << a.i2 << "]=" << lane(a.i1);
+      } else {
+        // Where to store the result
+        g << all << lane(a.i0) << "=";
+
+        // What to store
+        if (a.op==OP_CONST) {
+          g << g.constant(a.d);
+        } else if (a.op==OP_INPUT) {
+          g << "arg1[" << a.i1 << "] && k<nb ? arg1[" << a.i1 << "][k*"
+            << nnz_in(a.i1) << "+" << a.i2 << "] : 0";
+        } else {
+          casadi_int ndep = casadi_math<double>::ndeps(a.op);
+          casadi_assert_dev(ndep>0);
+          if (ndep==1) g << g.print_op(a.op, lane(a.i1));
+          if (ndep==2) g << g.print_op(a.op, lane(a.i1), lane(a.i2));
+        }
+      }
+      g  << ";\n";
+    }
+  }
+
   const Options SXFunction::options_
   = {{&FunctionInternal::options_},
      {{"default_in",
@@ -187,6 +485,20 @@ namespace casadi {
       {"live_variables",
        {OT_BOOL,
         "Reuse variables in the work vector"}},
+      {"instruction_order",
+       {OT_STRING,
+        "Ordering of the algorithm: 'depth_first' (default) follows the traversal "
+        "of the expression graph, 'working_set' evaluates the operand needing most "
+        "work vector entries first, reducing the size and cache footprint of the "
+        "work vector"}},
+      {"fuse_instructions",
+       {OT_BOOL,
+        "Fuse common instruction patterns into superinstructions "
+        "for numerical evaluation (default: true)"}},
+      {"just_in_time_native",
+       {OT_BOOL,
+        "Translate the algorithm to machine code in-process for numerical evaluation, "
+        "without an external compiler (experimental, x86-64 only)"}},
       {"cse",
        {OT_BOOL,
         "Perform common subexpression elimination (complexity is N*log(N) in graph size)"}},
@@ -203,6 +515,9 @@ namespace casadi {
     Dict opts = FunctionInternal::generate_options(target);
     //opts["default_in"] = default_in_;
     opts["live_variables"] = live_variables_;
+    opts["instruction_order"] = instruction_order_;
+    opts["fuse_instructions"] = fuse_instructions_;
+    opts["just_in_time_native"] = just_in_time_native_;
     opts["just_in_time_sparsity"] = just_in_time_sparsity_;
     opts["just_in_time_opencl"] = just_in_time_opencl_;
     return opts;
@@ -215,6 +530,7 @@ namespace casadi {
 
     // Default (temporary) options
     live_variables_ = true;
+    instruction_order_ = "depth_first";
 
     bool cse_opt = false;
     bool allow_free = false;
@@ -225,6 +541,12 @@ namespace casadi {
         default_in_ = op.second;
       } else if (op.first=="live_variables") {
         live_variables_ = op.second;
+      } else if (op.first=="instruction_order") {
+        instruction_order_ = op.second.to_string();
+      } else if (op.first=="fuse_instructions") {
+        fuse_instructions_ = op.second;
+      } else if (op.first=="just_in_time_native") {
+        just_in_time_native_ = op.second;
       } else if (op.first=="just_in_time_opencl") {
         just_in_time_opencl_ = op.second;
       } else if (op.first=="just_in_time_sparsity") {
@@ -266,6 +588,15 @@ namespace casadi {
       }
     }
 
+    // Reorder for locality
+    if (instruction_order_=="working_set") {
+      sort_working_set(nodes);
+    } else {
+      casadi_assert(instruction_order_=="depth_first",
+        "Unknown instruction order '" + instruction_order_ + "'. "
+        "Possible values are 'depth_first' and 'working_set'");
+    }
+
     casadi_assert(nodes.size() <= std::numeric_limits<int>::max(), "Integer overflow");
     // Set the temporary variables to be the corresponding place in the sorted graph
     for (casadi_int i=0; i<nodes.size(); ++i) {
@@ -422,6 +753,8 @@ namespace casadi {
       } else {
         casadi_message("Live variables disabled.");
       }
+      casadi_message("Estimated cache footprint of the work array: "
+        + str(w_footprint()) + " bytes");
     }
 
     // Allocate work vectors (symbolic/numeric)
@@ -489,8 +822,113 @@ namespace casadi {
       casadi_error("OpenCL is not supported in this version of CasADi");
     }
 
+    // Program for numerical evaluation
+    init_program();
+    init_native();
+
     // Print
     if (verbose_) casadi_message(str(algorithm_.size()) + " elementary operations");
+    if (verbose_ && n_fused_>0) {
+      casadi_message(str(n_fused_) + " pairs fused into superinstructions");
+    }
+  }
+
+  void SXFunction::sort_working_set(std::vector<SXNode*>& nodes) const {
+    // Index of each node in the depth-first order
+    for (casadi_int i=0; i<nodes.size(); ++i) {
+      if (nodes[i]) nodes[i]->temp = static_cast<int>(i);
+    }
+
+    // Work vector entries needed, dependencies come first
+    std::vector<casadi_int> need(nodes.size(), 0);
+    for (casadi_int i=0; i<nodes.size(); ++i) {
+      SXNode* n = nodes[i];
+      if (!n) continue;
+      if (n->n_dep()==0) {
+        need[i] = 1;
+      } else if (n->n_dep()==1) {
+        need[i] = need[n->dep(0)->temp];
+      } else {
+        casadi_int a = need[n->dep(0)->temp], b = need[n->dep(1)->temp];
+        need[i] = a==b ? a+1 : std::max(a, b);
+      }
+    }
+
+    // Traverse again, visiting the most demanding operand first
+    std::vector<SXNode*> ret;
+    ret.reserve(nodes.size());
+    std::vector<bool> added(nodes.size(), false);
+    std::stack<std::pair<SXNode*, casadi_int> > s;
+    for (auto&& e : out_) {
+      for (auto&& c : e.nonzeros()) {
+        s.push(std::make_pair(c.get(), 0));
+        while (!s.empty()) {
+          SXNode* t = s.top().first;
+          casadi_int& next_dep = s.top().second;
+          if (added[t->temp]) {
+            s.pop();
+          } else if (next_dep < t->n_dep()) {
+            // Operand order, the second one first if it needs more entries
+            casadi_int k = next_dep++;
+            if (t->n_dep()==2 && need[t->dep(1)->temp] > need[t->dep(0)->temp]) k = 1-k;
+            s.push(std::make_pair(t->dep(k).get(), 0));
+          } else {
+            ret.push_back(t);
+            added[t->temp] = true;
+            s.pop();
+          }
+        }
+        // Output instruction
+        ret.push_back(nullptr);
+      }
+    }
+    casadi_assert_dev(ret.size()==nodes.size());
+    nodes = ret;
+  }
+
+  casadi_int SXFunction::w_footprint() const {
+    // Cache lines of the work vector accessed by the algorithm
+    const casadi_int line = 64/sizeof(double);
+    std::vector<casadi_int> trace;
+    trace.reserve(3*algorithm_.size());
+    for (auto&& a : algorithm_) {
+      casadi_int ndeps = casadi_math<double>::ndeps(a.op);
+      if (a.op==OP_OUTPUT) {
+        trace.push_back(a.i1/line);
+        continue;
+      }
+      if (ndeps>=1 && a.op!=OP_INPUT) trace.push_back(a.i1/line);
+      if (ndeps==2) trace.push_back(a.i2/line);
+      trace.push_back(a.i0/line);
+    }
+
+    // Reuse distances, counting distinct lines with a Fenwick tree over time
+    std::vector<casadi_int> last(worksize_/line + 1, -1), tree(trace.size() + 1, 0);
+    auto add = [&](casadi_int t, casadi_int v) {
+      for (++t; t<tree.size(); t += t & -t) tree[t] += v;
+    };
+    auto sum = [&](casadi_int t) {
+      casadi_int r = 0;
+      for (++t; t>0; t -= t & -t) r += tree[t];
+      return r;
+    };
+    std::vector<casadi_int> dist;
+    dist.reserve(trace.size());
+    for (casadi_int t=0; t<trace.size(); ++t) {
+      casadi_int& l = last[trace[t]];
+      if (l>=0) {
+        dist.push_back(sum(t-1) - sum(l));
+        add(l, -1);
+      }
+      add(t, 1);
+      l = t;
+    }
+    if (dist.empty()) return 0;
+
+    // 90 percent quantile
+    auto q = dist.begin() + (dist.size()*9)/10;
+    std::nth_element(dist.begin(), q, dist.end());
+    return (*q + 1)*64;
   }
 
   SX SXFunction::instructions_sx() const {
@@ -975,7 +1413,7 @@ namespace casadi {
 
   SXFunction::SXFunction(DeserializingStream& s) :
     XFunction<SXFunction, SX, SXNode>(s) {
-    s.version("SXFunction", 1);
+    int version = s.version("SXFunction", 1, 4);
     size_t n_instructions;
     s.unpack("SXFunction::n_instr", n_instructions);
 
@@ -999,13 +1437,33 @@ namespace casadi {
     just_in_time_sparsity_ = false;
 
     s.unpack("SXFunction::live_variables", live_variables_);
+    if (version >= 2) {
+      s.unpack("SXFunction::fuse_instructions", fuse_instructions_);
+    } else {
+      fuse_instructions_ = true;
+    }
+    if (version >= 3) {
+      s.unpack("SXFunction::just_in_time_native", just_in_time_native_);
+    } else {
+      just_in_time_native_ = false;
+    }
+    if (version >= 4) {
+      s.unpack("SXFunction::instruction_order", instruction_order_);
+    } else {
+      instruction_order_ = "depth_first";
+    }
 
     XFunction<SXFunction, SX, SXNode>::delayed_deserialize_members(s);
+
+    // Program for numerical evaluation
+    init_program();
+    native_ = nullptr;
+    init_native();
   }
 
   void SXFunction::serialize_body(SerializingStream &s) const {
     XFunction<SXFunction, SX, SXNode>::serialize_body(s);
-    s.version("SXFunction", 1);
+    s.version("SXFunction", 4);
     s.pack("SXFunction::n_instr", algorithm_.size());
 
     s.pack("SXFunction::worksize", worksize_);
@@ -1023,6 +1481,9 @@ namespace casadi {
     }
 
     s.pack("SXFunction::live_variables", live_variables_);
+    s.pack("SXFunction::fuse_instructions", fuse_instructions_);
+    s.pack("SXFunction::just_in_time_native", just_in_time_native_);
+    s.pack("SXFunction::instruction_order", instruction_order_);
 
     XFunction<SXFunction, SX, SXNode>::delayed_serialize_members(s);
   }
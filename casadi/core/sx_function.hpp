@@ -43,6 +43,20 @@ namespace casadi {
     };
   };
 
+  // Forward declaration
+  class NativeCode;
+
+  /** \brief  An instruction of the program executed by SXFunction::eval
+
+      Either a single ScalarAtomic or a superinstruction fusing two of them.
+      The dispatch code is one of SXFunction::ExecCode. */
+  struct FusedAtomic {
+    int code;   /// Dispatch code
+    int op;     /// Operator index of the (last) fused operation
+    int i0, i1, i2, i3;
+    double d;
+  };
+
 /** \brief  Internal node class for SXFunction
 
     Do not use any internal class directly - always use the public Function
@@ -72,6 +86,20 @@ class CASADI_EXPORT SXFunction :
       \identifier{ue} */
   int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
 
+  /** \brief  Evaluate n<=batch instances in lockstep
+
+      Instance k reads from arg[i]+k*nnz_in(i) and writes to res[i]+k*nnz_out(i).
+      The work vector, of length sz_w()*batch, is stored structure-of-arrays
+      such that each instruction is dispatched once for the whole batch. */
+  int eval_batch(const double** arg, double** res, double* w,
+                 casadi_int n, casadi_int batch) const;
+
+  /** \brief Generate code for evaluating instances in lockstep, cf. eval_batch
+
+      The generated code refers to the argument buffers arg1 and res1, the
+      number of active instances nb and the lane counter k. */
+  void codegen_batch(CodeGenerator& g, casadi_int batch) const;
+
   /** \brief  evaluate symbolically while also propagating directional derivatives
 
       \identifier{uf} */
@@ -219,6 +247,50 @@ class CASADI_EXPORT SXFunction :
       \identifier{uz} */
   std::vector<AlgEl> algorithm_;
 
+  /** \brief Dispatch codes of the fused program
+
+      Operands are w[i*] unless stated otherwise,
+      in[i1][i2] denotes an input nonzero, zero if the input is null. */
+  enum ExecCode {
+    EXEC_END,         // End of program
+    EXEC_GENERIC,     // i0 = op(i1, i2)
+    EXEC_CONST,       // i0 = d
+    EXEC_INPUT,       // i0 = in[i1][i2]
+    EXEC_OUTPUT,      // res[i0][i2] = i1
+    EXEC_ADD, EXEC_SUB, EXEC_MUL, EXEC_DIV, EXEC_NEG, EXEC_SQ,  // i0 = op(i1, i2)
+    EXEC_FMA,         // i0 = i1*i2 + i3
+    EXEC_FMS,         // i0 = i1*i2 - i3
+    EXEC_ADD_C, EXEC_SUB_C, EXEC_MUL_C, EXEC_DIV_C,  // i0 = i1 op d
+    EXEC_RSUB_C, EXEC_RDIV_C,                          // i0 = d op i1
+    EXEC_INPUT_ADD, EXEC_INPUT_SUB, EXEC_INPUT_MUL, EXEC_INPUT_DIV,  // i0 = in[i1][i2] op i3
+    EXEC_INPUT_RSUB, EXEC_INPUT_RDIV,                                  // i0 = i3 op in[i1][i2]
+    EXEC_ADD_OUTPUT, EXEC_SUB_OUTPUT, EXEC_MUL_OUTPUT, EXEC_DIV_OUTPUT,  // res[i0][i3] = i1 op i2
+    EXEC_NUM
+  };
+
+  /** \brief Program executed by eval, algorithm_ with superinstructions
+
+      Terminated by EXEC_END, empty if fusion is disabled. */
+  std::vector<FusedAtomic> program_;
+
+  /// Number of superinstructions in program_
+  casadi_int n_fused_;
+
+  /// Fuse common instruction patterns for numerical evaluation
+  bool fuse_instructions_;
+
+  /** \brief Construct program_ from algorithm_ */
+  void init_program();
+
+  /// Translate algorithm_ to machine code for numerical evaluation
+  bool just_in_time_native_;
+
+  /// Machine code translation of algorithm_, if any
+  NativeCode* native_;
+
+  /** \brief Construct native_ from algorithm_ */
+  void init_native();
+
   // Work vector size
   size_t worksize_;
 
@@ -306,6 +378,23 @@ class CASADI_EXPORT SXFunction :
   /// Live variables?
   bool live_variables_;
 
+  /// Ordering of the algorithm
+  std::string instruction_order_;
+
+  /** \brief Reorder sorted nodes to reduce the number of live work vector entries
+
+      Each node is labeled with the number of entries needed to evaluate it
+      (Sethi-Ullman numbering) and the operand with the largest label is
+      evaluated first. Output instructions keep their relative order. */
+  void sort_working_set(std::vector<SXNode*>& nodes) const;
+
+  /** \brief Estimated cache footprint of the work vector in bytes
+
+      Smallest fully associative LRU cache of 64 byte lines for which 90 percent
+      of the non-compulsory accesses to the work vector are hits, obtained from
+      the reuse distances of the algorithm. */
+  casadi_int w_footprint() const;
+
 protected:
   /** \brief Deserializing constructor
 
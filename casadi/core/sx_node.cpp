@@ -29,6 +29,7 @@
 #include "binary_sx.hpp"
 #include "constant_sx.hpp"
 #include "symbolic_sx.hpp"
+#include "node_arena.hpp"
 
 #include <limits>
 #include <stack>
@@ -51,6 +52,14 @@ namespace casadi {
     #endif // WITH_REFCOUNT_WARNINGS
   }
 
+  void* SXNode::operator new(std::size_t sz) {
+    return NodeArena::allocate(sz);
+  }
+
+  void SXNode::operator delete(void* p, std::size_t sz) {
+    NodeArena::deallocate(p, sz);
+  }
+
   double SXNode::to_double() const {
     return std::numeric_limits<double>::quiet_NaN();
   }
@@ -62,6 +62,12 @@ namespace casadi {
         \identifier{9v} */
     virtual ~SXNode();
 
+    ///@{
+    /** \brief Allocation, from the active NodeArena if any */
+    static void* operator new(std::size_t sz);
+    static void operator delete(void* p, std::size_t sz);
+    ///@}
+
     ///@{
     /** \brief  check properties of a node
 
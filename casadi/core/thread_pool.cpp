@@ -0,0 +1,185 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace casadi {
+
+  ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  casadi_int ThreadPool::hardware_concurrency() {
+#ifdef CASADI_WITH_THREAD
+    casadi_int n = std::thread::hardware_concurrency();
+    return std::max(n, casadi_int(1));
+#else // CASADI_WITH_THREAD
+    return 1;
+#endif // CASADI_WITH_THREAD
+  }
+
+#ifndef CASADI_WITH_THREAD
+
+  ThreadPool::ThreadPool() {
+  }
+
+  ThreadPool::~ThreadPool() {
+  }
+
+  casadi_int ThreadPool::size() const {
+    return 0;
+  }
+
+  void ThreadPool::run(casadi_int n, casadi_int n_slots, casadi_int chunk_size,
+      const Task& task) {
+    if (n>0) task(0, 0, n);
+  }
+
+#else // CASADI_WITH_THREAD
+
+  struct ThreadPool::Job {
+    // Work to be carried out
+    Task task;
+    // Number of tasks, slots and chunk size
+    casadi_int n, n_slots, chunk_size;
+    // First task of the next chunk to be claimed
+    std::atomic<casadi_int> next;
+    // Guards the members below
+    std::mutex mtx;
+    // Signals that a participant finished
+    std::condition_variable cv;
+    // Number of slots handed out
+    casadi_int slots_taken;
+    // Number of participants still working
+    casadi_int active;
+    // No more participants are accepted
+    bool closed;
+  };
+
+  ThreadPool::ThreadPool() : stop_(false) {
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto&& th : workers_) th.join();
+  }
+
+  casadi_int ThreadPool::size() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return workers_.size();
+  }
+
+  void ThreadPool::reserve(casadi_int n) {
+    // Called with mtx_ locked
+    while (static_cast<casadi_int>(workers_.size()) < n) {
+      workers_.emplace_back([this]() { worker_loop(); });
+    }
+  }
+
+  void ThreadPool::worker_loop() {
+    for (;;) {
+      std::shared_ptr<Job> job;
+      {
+        std::unique_lock<std::mutex> lock(mtx_);
+        cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+        if (stop_) return;
+        job = queue_.front();
+        queue_.pop_front();
+      }
+      work(*job);
+    }
+  }
+
+  void ThreadPool::work(Job& job) {
+    // Claim a slot, if any left
+    casadi_int slot;
+    {
+      std::lock_guard<std::mutex> lock(job.mtx);
+      if (job.closed || job.slots_taken >= job.n_slots) return;
+      slot = job.slots_taken++;
+      job.active++;
+    }
+    // Process chunks until the range is exhausted
+    for (;;) {
+      casadi_int begin = job.next.fetch_add(job.chunk_size);
+      if (begin >= job.n) break;
+      job.task(slot, begin, std::min(begin + job.chunk_size, job.n));
+    }
+    // Sign off
+    std::lock_guard<std::mutex> lock(job.mtx);
+    if (--job.active == 0) job.cv.notify_all();
+  }
+
+  void ThreadPool::run(casadi_int n, casadi_int n_slots, casadi_int chunk_size,
+      const Task& task) {
+    if (n<=0) return;
+    n_slots = std::max(std::min(n_slots, n), casadi_int(1));
+    // Serial evaluation is cheaper than any synchronization
+    if (n_slots==1) {
+      task(0, 0, n);
+      return;
+    }
+    // Default chunk size: a few chunks per slot for load balancing
+    if (chunk_size<=0) chunk_size = std::max((n + 4*n_slots - 1) / (4*n_slots), casadi_int(1));
+
+    // Shared state of the job
+    auto job = std::make_shared<Job>();
+    job->task = task;
+    job->n = n;
+    job->n_slots = n_slots;
+    job->chunk_size = chunk_size;
+    job->next = 0;
+    job->slots_taken = 0;
+    job->active = 0;
+    job->closed = false;
+
+    // Ask for help from the workers
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      reserve(n_slots - 1);
+      for (casadi_int i=1; i<n_slots; ++i) queue_.push_back(job);
+    }
+    cv_.notify_all();
+
+    // Participate
+    work(*job);
+
+    // Refuse late participants and wait for the others to finish
+    std::unique_lock<std::mutex> lock(job->mtx);
+    job->closed = true;
+    job->cv.wait(lock, [&job]() { return job->active == 0; });
+  }
+
+#endif // CASADI_WITH_THREAD
+
+} // namespace casadi
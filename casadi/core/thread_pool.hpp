@@ -0,0 +1,128 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_THREAD_POOL_HPP
+#define CASADI_THREAD_POOL_HPP
+
+#include "casadi_common.hpp"
+
+#include <functional>
+#include <memory>
+#include <deque>
+
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.thread.h>
+#include <mingw.mutex.h>
+#include <mingw.condition_variable.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Process-wide pool of persistent worker threads
+
+      Work is submitted as a range of tasks [0, n) that is cut into chunks.
+      Each participating thread claims a slot in [0, n_slots) that stays fixed
+      for the duration of the call, allowing the caller to associate work vectors
+      and memory objects with a slot rather than with a task.
+      The calling thread always participates itself, which guarantees progress
+      also when the pool is saturated, e.g. for nested parallel maps.
+
+      Without CASADI_WITH_THREAD, all tasks are executed by the caller in slot 0.
+  */
+  class CASADI_EXPORT ThreadPool {
+  public:
+    /// Signature of a chunk of work: slot, first task, one past last task
+    typedef std::function<void(casadi_int, casadi_int, casadi_int)> Task;
+
+    /// Access the global instance
+    static ThreadPool& instance();
+
+    /// Destructor, joins all workers
+    ~ThreadPool();
+
+    /** \brief Execute n tasks using at most n_slots threads, including the caller
+
+        The call blocks until all tasks have been completed.
+        A nonpositive chunk_size selects a chunk size automatically.
+        The task is not allowed to throw.
+    */
+    void run(casadi_int n, casadi_int n_slots, casadi_int chunk_size, const Task& task);
+
+    /// Number of worker threads currently alive (the caller not included)
+    casadi_int size() const;
+
+    /// Number of threads supported by the hardware, at least one
+    static casadi_int hardware_concurrency();
+
+  private:
+    /// Constructor, workers are only started on demand
+    ThreadPool();
+
+    // Not copyable
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+#ifdef CASADI_WITH_THREAD
+    // Shared state of a single call to run
+    struct Job;
+
+    /// Participate in a job
+    static void work(Job& job);
+
+    /// Main loop of a worker
+    void worker_loop();
+
+    /// Make sure that at least n workers are alive
+    void reserve(casadi_int n);
+
+    /// Worker threads
+    std::vector<std::thread> workers_;
+
+    /// Pending participation requests
+    std::deque<std::shared_ptr<Job> > queue_;
+
+    /// Guards queue_, workers_ and stop_
+    mutable std::mutex mtx_;
+
+    /// Signals new entries in the queue
+    std::condition_variable cv_;
+
+    /// Shutdown requested
+    bool stop_;
+#endif // CASADI_WITH_THREAD
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_THREAD_POOL_HPP
@@ -482,6 +482,12 @@ namespace casadi {
       casadi_int max_nfdir = max_num_dir_;
       casadi_int max_nadir = max_num_dir_;
 
+      // All directions in one sweep, batched by the called functions
+      if (ad_num_threads_>1) {
+        max_nfdir = std::max(max_nfdir, nfdir);
+        max_nadir = std::max(max_nadir, nadir);
+      }
+
       // Current forward and adjoint direction
       casadi_int offset_nfdir = 0, offset_nadir = 0;
 
@@ -67,6 +67,7 @@ namespace casadi {
 
   ClangCompiler::~ClangCompiler() {
     if (act_) delete act_; // NOLINT(readability-delete-null-pointer)
+    for (auto* a : act_extra_) delete a;
     if (myerr_) delete myerr_; // NOLINT(readability-delete-null-pointer)
     if (executionEngine_) delete executionEngine_; // NOLINT(readability-delete-null-pointer)
     if (context_) delete context_; // NOLINT(readability-delete-null-pointer)
@@ -80,7 +81,11 @@ namespace casadi {
         "The include directory shipped with CasADi will be automatically appended."}},
       {"flags",
        {OT_STRINGVECTOR,
-        "Compile flags for the JIT compiler. Default: None"}}
+        "Compile flags for the JIT compiler. Default: None"}},
+      {"sources",
+       {OT_STRINGVECTOR,
+        "Additional source files, compiled to separate modules and "
+        "loaded into the same execution engine. Default: None"}}
      }
   };
 
@@ -94,11 +99,26 @@ namespace casadi {
         include_path_ = op.second.to_string();
       } else if (op.first=="flags") {
         flags_ = op.second;
+      } else if (op.first=="sources") {
+        sources_ = op.second;
       }
     }
 
+    // Create an LLVM context (NOTE: should use a static context instead?)
+    context_ = new llvm::LLVMContext();
+
+    // Compile the main file first, then any additional sources
+    std::vector<std::string> all_sources(1, name_);
+    all_sources.insert(all_sources.end(), sources_.begin(), sources_.end());
+    for (casadi_int k=0; k<all_sources.size(); ++k) {
+      modules_.push_back(compile(all_sources[k], k==0));
+    }
+    module_ = modules_.front();
+  }
+
+  llvm::Module* ClangCompiler::compile(const std::string& source, bool create_engine) {
     // Arguments to pass to the clang frontend
-    std::vector<const char *> args(1, name_.c_str());
+    std::vector<const char *> args(1, source.c_str());
     for (auto&& f : flags_) {
       args.push_back(f.c_str());
     }
@@ -143,7 +163,7 @@ namespace casadi {
 
     // The compiler invocation needs a DiagnosticsEngine so it can report problems
     clang::DiagnosticOptions* diagOpts = new clang::DiagnosticOptions();
-    myerr_ = new llvm::raw_os_ostream(uerr());
+    if (!myerr_) myerr_ = new llvm::raw_os_ostream(uerr());
     clang::TextDiagnosticPrinter *diagClient = new clang::TextDiagnosticPrinter(*myerr_, diagOpts);
 
     clang::DiagnosticIDs* diagID = new clang::DiagnosticIDs();
@@ -203,23 +223,32 @@ namespace casadi {
       compInst.getHeaderSearchOpts().AddPath(path, clang::frontend::System, false, false);
     }
 
-    // Create an LLVM context (NOTE: should use a static context instead?)
-    context_ = new llvm::LLVMContext();
-
     // Create an action and make the compiler instance carry it out
-    act_ = new clang::EmitLLVMOnlyAction(context_);
-    if (!compInst.ExecuteAction(*act_))
+    clang::EmitLLVMOnlyAction* act = new clang::EmitLLVMOnlyAction(context_);
+    if (create_engine) {
+      act_ = act;
+    } else {
+      act_extra_.push_back(act);
+    }
+    if (!compInst.ExecuteAction(*act))
       casadi_error("Cannot execute action");
 
     // Grab the module built by the EmitLLVMOnlyAction
     #if LLVM_VERSION_MAJOR>=4 || (LLVM_VERSION_MAJOR==3 && LLVM_VERSION_MINOR>=5)
-    std::unique_ptr<llvm::Module> module = act_->takeModule();
-    module_ = module.get();
+    std::unique_ptr<llvm::Module> module = act->takeModule();
+    llvm::Module* ret = module.get();
     #else
-    llvm::Module* module = act_->takeModule();
-    module_ = module;
+    llvm::Module* module = act->takeModule();
+    llvm::Module* ret = module;
     #endif
 
+    // Additional modules are resolved against the ones already loaded
+    if (!create_engine) {
+      executionEngine_->addModule(std::move(module));
+      executionEngine_->finalizeObject();
+      return ret;
+    }
+
     llvm::InitializeNativeTarget();
     llvm::InitializeNativeTargetAsmPrinter();
 
@@ -233,15 +262,17 @@ namespace casadi {
     }
 
     executionEngine_->finalizeObject();
+    return ret;
   }
 
   signal_t ClangCompiler::get_function(const std::string& symname) {
-    llvm::Function* f = module_->getFunction(symname);
-    if (f) {
-      return reinterpret_cast<signal_t>(executionEngine_->getPointerToFunction(f));
-    } else {
-      return nullptr;
+    for (llvm::Module* m : modules_) {
+      llvm::Function* f = m->getFunction(symname);
+      if (f && !f->isDeclaration()) {
+        return reinterpret_cast<signal_t>(executionEngine_->getPointerToFunction(f));
+      }
     }
+    return nullptr;
   }
 
   std::vector<std::pair<std::string, bool> > ClangCompiler::
@@ -119,9 +119,13 @@ namespace casadi {
     static std::vector<std::pair<std::string, bool> >
       getIncludes(const std::string& file, const std::string& path);
 
+    // Compile a source file to a module, creating the execution engine if requested
+    llvm::Module* compile(const std::string& source, bool create_engine);
+
     // Options
     std::string include_path_;
     std::vector<std::string> flags_;
+    std::vector<std::string> sources_;
 
   protected:
     clang::EmitLLVMOnlyAction* act_;
@@ -129,6 +133,8 @@ namespace casadi {
     llvm::LLVMContext* context_;
     llvm::raw_ostream* myerr_;
     llvm::Module* module_; // owned by executionEngine_
+    std::vector<llvm::Module*> modules_; // owned by executionEngine_
+    std::vector<clang::EmitLLVMOnlyAction*> act_extra_;
   };
 
 } // namespace casadi
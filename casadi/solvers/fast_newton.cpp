@@ -64,7 +64,21 @@ namespace casadi {
         "Stopping criterion tolerance on step size"}},
       {"max_iter",
        {OT_INT,
-        "Maximum number of Newton iterations to perform before returning."}}
+        "Maximum number of Newton iterations to perform before returning."}},
+      {"max_reuse",
+       {OT_INT,
+        "Maximum number of additional iterations that reuse the Jacobian and its "
+        "factorization (chord or Shamanskii method). The Jacobian is reevaluated earlier "
+        "if the residual does not contract by contraction_tol (default: 0)"}},
+      {"contraction_tol",
+       {OT_DOUBLE,
+        "Reevaluate the Jacobian when the residual of an iteration with a reused "
+        "Jacobian exceeds this fraction of the previous residual (default: 0.5)"}},
+      {"reuse_across_calls",
+       {OT_BOOL,
+        "Start from the Jacobian and factorization of the previous call, "
+        "for inputs that change little between calls. Requires max_reuse>0. "
+        "Not supported in generated code (default: false)"}}
      }
   };
 
@@ -77,6 +91,9 @@ namespace casadi {
     max_iter_ = 1000;
     abstol_ = 1e-12;
     abstolStep_ = 1e-12;
+    max_reuse_ = 0;
+    contraction_tol_ = 0.5;
+    reuse_across_calls_ = false;
 
     // Read options
     for (auto&& op : opts) {
@@ -86,9 +103,19 @@ namespace casadi {
         abstol_ = op.second;
       } else if (op.first=="abstolStep") {
         abstolStep_ = op.second;
+      } else if (op.first=="max_reuse") {
+        max_reuse_ = op.second;
+      } else if (op.first=="contraction_tol") {
+        contraction_tol_ = op.second;
+      } else if (op.first=="reuse_across_calls") {
+        reuse_across_calls_ = op.second;
       }
     }
 
+    casadi_assert(max_reuse_>=0, "Option 'max_reuse' must be nonnegative");
+    casadi_assert(!reuse_across_calls_ || max_reuse_>0,
+                  "Option 'reuse_across_calls' requires 'max_reuse' to be positive");
+
     casadi_assert(oracle_.n_in()>0,
                           "Newton: the supplied f must have at least one input.");
     casadi_assert(!linsol_.is_null(),
@@ -120,6 +147,8 @@ namespace casadi {
      M->n = n_;
      M->abstol = abstol_;
      M->abstol_step = abstolStep_;
+     M->max_reuse = max_reuse_;
+     M->contraction_tol = contraction_tol_;
 
      M->x = w; w += n_;
      M->g = w; w += n_;
@@ -136,6 +165,13 @@ namespace casadi {
      M->lin_r = w; w+= sp_r_.nnz();
      M->lin_beta = w; w+= sp_jac_.size2();
 
+     // Work vectors are not kept between calls
+     if (reuse_across_calls_) {
+       M->jac_g_x = get_ptr(m->jac);
+       M->lin_v = get_ptr(m->lin_v);
+       M->lin_r = get_ptr(m->lin_r);
+       M->lin_beta = get_ptr(m->lin_beta);
+     }
   }
 
   int FastNewton::solve(void* mem) const {
@@ -145,6 +181,11 @@ namespace casadi {
     // Get the initial guess
     casadi_copy(m->iarg[iin_], n_, M->x);
 
+    // Factorization from the previous call, if any, can only be used for chord steps
+    if (!reuse_across_calls_) M->jac_age = -1;
+    M->g_norm = std::numeric_limits<double>::infinity();
+
+    m->n_jac = m->n_fact = 0;
     for (m->iter=0; m->iter<max_iter_; ++m->iter) {
        /* (re)calculate f and J */
        // Use x to evaluate J
@@ -153,11 +194,22 @@ namespace casadi {
        for (casadi_int i=0;i<n_out_;++i) m->res[i+1] = m->ires[i];
        m->res[0] = M->jac_g_x;
        m->res[1+iout_] = M->g;
-       jac_f_z_(m->arg, m->res, m->iw, m->w);
-
-       m->return_status = casadi_newton(M);
+       if (casadi_newton_reuse(M)) {
+         // Only f when reusing the factorization
+         oracle_(m->arg, m->res+1, m->iw, m->w);
+         m->return_status = casadi_newton(M);
+       } else {
+         m->return_status = 3;
+       }
+       if (m->return_status==3) {
+         jac_f_z_(m->arg, m->res, m->iw, m->w);
+         m->n_jac++;
+         m->return_status = casadi_newton(M);
+       }
+       if (m->return_status!=1 && M->jac_age==1) m->n_fact++;
        if (m->return_status) break;
     }
+    if (m->return_status==0) M->jac_age = -1;
     // Get the solution
     casadi_copy(M->x, n_, m->ires[iout_]);
 
@@ -175,6 +227,10 @@ namespace casadi {
     g << "m.n = " << n_ << ";\n";
     g << "m.abstol = " << abstol_ << ";\n";
     g << "m.abstol_step = " << abstolStep_ << ";\n";
+    g << "m.max_reuse = " << max_reuse_ << ";\n";
+    g << "m.contraction_tol = " << contraction_tol_ << ";\n";
+    g << "m.jac_age = -1;\n";
+    g << "m.g_norm = casadi_inf;\n";
 
     casadi_int w_offset = 0;
     g << "m.x = w;\n"; w_offset+=n_;
@@ -209,8 +265,26 @@ namespace casadi {
     }
     std::string flag = g(get_function("jac_f_z"),
       "arg+" + str(n_in_), "res+" + str(n_out_), "iw", "w+" + str(w_offset));
-    g << "if (" << flag << ") return 1;\n";
-    g << "if (casadi_newton(&m)) break;\n";
+    if (max_reuse_ > 0) {
+      g.local("flag", "int");
+      g << "if (casadi_newton_reuse(&m)) {\n";
+      g.comment("Only f when reusing the factorization");
+      std::string flag_f = g(oracle_,
+        "arg+" + str(n_in_), "res+" + str(n_out_+1), "iw", "w+" + str(w_offset));
+      g << "if (" << flag_f << ") return 1;\n";
+      g << "flag = casadi_newton(&m);\n";
+      g << "} else {\n";
+      g << "flag = 3;\n";
+      g << "}\n";
+      g << "if (flag==3) {\n";
+      g << "if (" << flag << ") return 1;\n";
+      g << "flag = casadi_newton(&m);\n";
+      g << "}\n";
+      g << "if (flag) break;\n";
+    } else {
+      g << "if (" << flag << ") return 1;\n";
+      g << "if (casadi_newton(&m)) break;\n";
+    }
     g << "}\n";
 
     // Get the solution
@@ -220,6 +294,7 @@ namespace casadi {
 
   void FastNewton::codegen_declarations(CodeGenerator& g) const {
     g.add_dependency(get_function("jac_f_z"));
+    if (max_reuse_ > 0) g.add_dependency(oracle_);
   }
 
   int FastNewton::init_mem(void* mem) const {
@@ -227,6 +302,14 @@ namespace casadi {
     auto m = static_cast<FastNewtonMemory*>(mem);
     m->return_status = 0;
     m->iter = 0;
+    m->n_jac = m->n_fact = 0;
+    m->M.jac_age = -1;
+    if (reuse_across_calls_) {
+      m->jac.resize(sp_jac_.nnz());
+      m->lin_v.resize(sp_v_.nnz());
+      m->lin_r.resize(sp_r_.nnz());
+      m->lin_beta.resize(sp_jac_.size2());
+    }
     return 0;
   }
 
@@ -248,12 +331,14 @@ namespace casadi {
     auto m = static_cast<FastNewtonMemory*>(mem);
     stats["return_status"] = return_code(m->return_status);
     stats["iter_count"] = m->iter;
+    stats["n_jac"] = m->n_jac;
+    stats["n_fact"] = m->n_fact;
     return stats;
   }
 
 
   FastNewton::FastNewton(DeserializingStream& s) : Rootfinder(s) {
-    s.version("Newton", 1);
+    int version = s.version("Newton", 1, 2);
     s.unpack("Newton::max_iter", max_iter_);
     s.unpack("Newton::abstol", abstol_);
     s.unpack("Newton::abstolStep", abstolStep_);
@@ -262,11 +347,20 @@ namespace casadi {
     s.unpack("Newton::sp_r", sp_r_);
     s.unpack("Newton::prinv", prinv_);
     s.unpack("Newton::pc", pc_);
+    if (version >= 2) {
+      s.unpack("Newton::max_reuse", max_reuse_);
+      s.unpack("Newton::contraction_tol", contraction_tol_);
+      s.unpack("Newton::reuse_across_calls", reuse_across_calls_);
+    } else {
+      max_reuse_ = 0;
+      contraction_tol_ = 0.5;
+      reuse_across_calls_ = false;
+    }
   }
 
   void FastNewton::serialize_body(SerializingStream &s) const {
     Rootfinder::serialize_body(s);
-    s.version("Newton", 1);
+    s.version("Newton", 2);
     s.pack("Newton::max_iter", max_iter_);
     s.pack("Newton::abstol", abstol_);
     s.pack("Newton::abstolStep", abstolStep_);
@@ -275,6 +369,9 @@ namespace casadi {
     s.pack("Newton::sp_r", sp_r_);
     s.pack("Newton::prinv", prinv_);
     s.pack("Newton::pc", pc_);
+    s.pack("Newton::max_reuse", max_reuse_);
+    s.pack("Newton::contraction_tol", contraction_tol_);
+    s.pack("Newton::reuse_across_calls", reuse_across_calls_);
   }
 
 } // namespace casadi
@@ -48,8 +48,13 @@ namespace casadi {
     int return_status;
     // Number of iterations
     casadi_int iter;
+    // Number of Jacobian evaluations and factorizations
+    casadi_int n_jac, n_fact;
 
     casadi_newton_mem<double> M;
+
+    // Jacobian and its factorization, kept between calls
+    std::vector<double> jac, lin_v, lin_r, lin_beta;
   };
 
   /** \brief \pluginbrief{Rootfinder,fast_newton}
@@ -135,6 +140,15 @@ namespace casadi {
     /// Absolute tolerance that should be met on step
     double abstolStep_;
 
+    /// Maximum number of additional steps with the same Jacobian and factorization
+    casadi_int max_reuse_;
+
+    /// Reevaluate the Jacobian if the residual decreases by less than this factor
+    double contraction_tol_;
+
+    /// Keep the Jacobian and factorization between calls
+    bool reuse_across_calls_;
+
     /// Reference to jacobian function
     Function jac_f_z_;
 
@@ -51,6 +51,13 @@ namespace casadi {
     uout() << "\n";
   }
 
+  // Copy a vector shifted s entries forward, repeating the last s entries
+  static void shift_copy(const double* v, casadi_int n, casadi_int s, double* r) {
+    s = std::min(s, n);
+    casadi_copy(v + s, n - s, r);
+    casadi_copy(v + n - s, s, r + n - s);
+  }
+
   Ipqp::Ipqp(const std::string& name, const std::map<std::string, Sparsity> &st)
     : Conic(name, st) {
   }
@@ -87,7 +94,16 @@ namespace casadi {
         "Options to be passed to the linear solver"}},
       {"min_lam",
        {OT_DOUBLE,
-        "Smallest multiplier treated as inactive for the initial active set [0]."}}
+        "Smallest multiplier treated as inactive for the initial active set [0]."}},
+      {"warm_start",
+       {OT_BOOL,
+        "Initialize from the primal-dual solution of the previous successful call "
+        "with the same memory instead of x0, lam_x0 and lam_a0. "
+        "Makes the result depend on the call history [false]."}},
+      {"warm_start_shift",
+       {OT_INTVECTOR,
+        "Shift the stored solution by this many variables and constraints before warm "
+        "starting, repeating the last entries, e.g. for receding horizon problems [0, 0]."}}
      }
   };
 
@@ -103,6 +119,8 @@ namespace casadi {
     print_header_ = true;
     print_info_ = true;
     linear_solver_ = "ldl";
+    warm_start_ = false;
+    warm_start_shift_ = {0, 0};
     // Read user options
     for (auto&& op : opts) {
       if (op.first=="max_iter") {
@@ -125,13 +143,20 @@ namespace casadi {
         linear_solver_ = op.second.to_string();
       } else if (op.first=="linear_solver_options") {
         linear_solver_options_ = op.second;
+      } else if (op.first=="warm_start") {
+        warm_start_ = op.second;
+      } else if (op.first=="warm_start_shift") {
+        warm_start_shift_ = op.second;
       }
     }
+    casadi_assert(warm_start_shift_.size()==2 && warm_start_shift_[0]>=0
+      && warm_start_shift_[1]>=0,
+      "Option 'warm_start_shift' must hold two nonnegative entries");
     // Memory for IP solver
     alloc_w(casadi_ipqp_sz_w(&p_), true);
     // Memory for KKT formation
     alloc_w(kkt_.nnz(), true);
-    alloc_iw(A_.size2());
+    alloc_iw(na_);
     alloc_w(nx_ + na_);
     // KKT solver
     linsol_ = Linsol("linsol", linear_solver_, kkt_, linear_solver_options_);
@@ -156,6 +181,9 @@ namespace casadi {
     if (Conic::init_mem(mem)) return 1;
     auto m = static_cast<IpqpMemory*>(mem);
     m->return_status = "";
+    m->iter_count = -1;
+    m->warm_started = false;
+    m->has_warm = false;
     return 0;
   }
 
@@ -175,6 +203,20 @@ namespace casadi {
     casadi_ipqp_bounds(&d, arg[CONIC_G],
       arg[CONIC_LBX], arg[CONIC_UBX], arg[CONIC_LBA], arg[CONIC_UBA]);
     casadi_ipqp_guess(&d, arg[CONIC_X0], arg[CONIC_LAM_X0], arg[CONIC_LAM_A0]);
+    // Overwrite guess with the previous solution
+    m->warm_started = warm_start_ && m->has_warm;
+    if (m->warm_started) {
+      const casadi_int sx = warm_start_shift_[0], sa = warm_start_shift_[1];
+      shift_copy(get_ptr(m->z), nx_, sx, d.z);
+      shift_copy(get_ptr(m->z) + nx_, na_, sa, d.z + nx_);
+      shift_copy(get_ptr(m->lam), nx_, sx, d.lam);
+      shift_copy(get_ptr(m->lam) + nx_, na_, sa, d.lam + nx_);
+      shift_copy(get_ptr(m->lam_lbz), nx_, sx, d.lam_lbz);
+      shift_copy(get_ptr(m->lam_lbz) + nx_, na_, sa, d.lam_lbz + nx_);
+      shift_copy(get_ptr(m->lam_ubz), nx_, sx, d.lam_ubz);
+      shift_copy(get_ptr(m->lam_ubz) + nx_, na_, sa, d.lam_ubz + nx_);
+      d.warm = 1;
+    }
     // Reverse communication loop
     while (casadi_ipqp(&d)) {
       switch (d.task) {
@@ -220,6 +262,15 @@ namespace casadi {
     m->return_status = casadi_ipqp_return_status(d.status);
     if (d.status == IPQP_MAX_ITER)
       m->d_qp.unified_return_status = SOLVER_RET_LIMITED;
+    m->iter_count = d.iter;
+    // Store solution for warm starting
+    if (warm_start_ && d.status == IPQP_SUCCESS) {
+      m->z.assign(d.z, d.z + p_.nz);
+      m->lam.assign(d.lam, d.lam + p_.nz);
+      m->lam_lbz.assign(d.lam_lbz, d.lam_lbz + p_.nz);
+      m->lam_ubz.assign(d.lam_ubz, d.lam_ubz + p_.nz);
+      m->has_warm = true;
+    }
     // Get solution
     casadi_ipqp_solution(&d, res[CONIC_X], res[CONIC_LAM_X], res[CONIC_LAM_A]);
     if (res[CONIC_COST]) {
@@ -236,11 +287,13 @@ namespace casadi {
     Dict stats = Conic::get_stats(mem);
     auto m = static_cast<IpqpMemory*>(mem);
     stats["return_status"] = m->return_status;
+    stats["iter_count"] = m->iter_count;
+    stats["warm_started"] = m->warm_started;
     return stats;
   }
 
   Ipqp::Ipqp(DeserializingStream& s) : Conic(s) {
-    s.version("Ipqp", 1);
+    int version = s.version("Ipqp", 1, 2);
     s.unpack("Ipqp::kkt", kkt_);
     s.unpack("Ipqp::print_iter", print_iter_);
     s.unpack("Ipqp::print_header", print_header_);
@@ -253,12 +306,21 @@ namespace casadi {
     s.unpack("Ipqp::du_tol", p_.du_tol);
     s.unpack("Ipqp::co_tol", p_.co_tol);
     s.unpack("Ipqp::mu_tol", p_.mu_tol);
+    if (version >= 2) {
+      s.unpack("Ipqp::warm_start", warm_start_);
+      s.unpack("Ipqp::warm_start_shift", warm_start_shift_);
+    } else {
+      warm_start_ = false;
+      warm_start_shift_ = {0, 0};
+    }
+    // KKT solver
+    linsol_ = Linsol("linsol", linear_solver_, kkt_, linear_solver_options_);
   }
 
   void Ipqp::serialize_body(SerializingStream &s) const {
     Conic::serialize_body(s);
 
-    s.version("Ipqp", 1);
+    s.version("Ipqp", 2);
     s.pack("Ipqp::kkt", kkt_);
     s.pack("Ipqp::print_iter", print_iter_);
     s.pack("Ipqp::print_header", print_header_);
@@ -270,6 +332,8 @@ namespace casadi {
     s.pack("Ipqp::du_tol", p_.du_tol);
     s.pack("Ipqp::co_tol", p_.co_tol);
     s.pack("Ipqp::mu_tol", p_.mu_tol);
+    s.pack("Ipqp::warm_start", warm_start_);
+    s.pack("Ipqp::warm_start_shift", warm_start_shift_);
   }
 
 } // namespace casadi
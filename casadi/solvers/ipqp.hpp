@@ -43,6 +43,13 @@
 namespace casadi {
   struct CASADI_CONIC_IPQP_EXPORT IpqpMemory : public ConicMemory {
     const char* return_status;
+    // Number of iterations of the last solve
+    casadi_int iter_count;
+    // Was the last solve warm started?
+    bool warm_started;
+    // Primal-dual solution of the last successful solve, for warm starting
+    bool has_warm;
+    std::vector<double> z, lam, lam_lbz, lam_ubz;
   };
 
   /** \brief \pluginbrief{Conic,ipqp}
@@ -112,6 +119,8 @@ namespace casadi {
     bool print_iter_, print_header_, print_info_;
     std::string linear_solver_;
     Dict linear_solver_options_;
+    bool warm_start_;
+    std::vector<casadi_int> warm_start_shift_;
     ///@}
 
     void serialize_body(SerializingStream &s) const override;
@@ -45,6 +45,9 @@ namespace casadi {
     LinsolInternal::registerPlugin(casadi_register_linsol_ldl);
   }
 
+  // Number of right-hand sides processed per pass over the factors in solve
+  static const casadi_int nrhs_block = 4;
+
   LinsolLdl::LinsolLdl(const std::string& name, const Sparsity& sp)
     : LinsolInternal(name, sp) {
   }
@@ -60,7 +63,15 @@ namespace casadi {
        "Incomplete factorization, without any fill-in"}},
       {"preordering",
        {OT_BOOL,
-       "Approximate minimal degree (AMD) preordering"}}
+       "Approximate minimal degree (AMD) preordering"}},
+      {"supernodal",
+       {OT_BOOL,
+       "Factorize supernodes, i.e. groups of columns with the same pattern, "
+       "as dense blocks. Faster when the factor has dense parts [default: false]"}},
+      {"num_threads",
+       {OT_INT,
+       "Factorize independent subtrees of the elimination tree concurrently, "
+       "using up to this many threads. Not used with 'supernodal' [default: 1]"}}
      }
   };
 
@@ -71,6 +82,8 @@ namespace casadi {
     // Default options
     incomplete_ = false;
     amd_ = true;
+    supernodal_ = false;
+    num_threads_ = 1;
 
     // Read user options
     for (auto&& op : opts) {
@@ -78,8 +91,14 @@ namespace casadi {
         incomplete_ = op.second;
       } else if (op.first=="amd") {
         amd_ = op.second;
+      } else if (op.first=="supernodal") {
+        supernodal_ = op.second;
+      } else if (op.first=="num_threads") {
+        num_threads_ = op.second;
       }
     }
+    casadi_assert(num_threads_>=1, "Option 'num_threads' must be positive");
+    if (supernodal_) num_threads_ = 1;
 
     // Symbolic factorization
     if (incomplete_) {
@@ -95,7 +114,89 @@ namespace casadi {
       }
     } else {
       // Regular LDL^T
-      sp_Lt_ = sp_.ldl(p_, amd_);
+      if (amd_ && num_threads_>1) {
+        // Fill-reducing ordering with independent subtrees
+        p_ = EtreeSchedule::nested_dissection(sp_, 2*num_threads_);
+        std::vector<casadi_int> tmp;
+        sp_Lt_ = sp_.sub(p_, p_, tmp).ldl(tmp, false);
+      } else {
+        sp_Lt_ = sp_.ldl(p_, amd_);
+      }
+    }
+
+    // Parallel schedule
+    schedule_.init(sp_Lt_, num_threads_);
+
+    // Supernodes
+    if (supernodal_) {
+      casadi_assert(!incomplete_, "Option 'supernodal' requires a complete factorization");
+      init_supernodes();
+      if (verbose_) {
+        casadi_message(str(n_super()) + " supernodes for " + str(nrow()) + " columns, "
+          + str(nnz_super()) + " entries");
+      }
+    }
+  }
+
+  void LinsolLdl::init_supernodes() {
+    casadi_int n = nrow();
+    // Pattern of L, strictly lower
+    Sparsity sp_L = sp_Lt_.T();
+    const casadi_int *l_colind = sp_L.colind(), *l_row = sp_L.row();
+    // Column c joins the supernode of column c-1 if it is its parent in the
+    // elimination tree and the patterns coincide below the diagonal
+    std::vector<casadi_int> super(1, 0);
+    for (casadi_int c=1; c<n; ++c) {
+      casadi_int nz = l_colind[c]-l_colind[c-1];
+      if (nz==0 || l_row[l_colind[c-1]]!=c || nz!=l_colind[c+1]-l_colind[c]+1) {
+        super.push_back(c);
+      }
+    }
+    if (n>0) super.push_back(n);
+    casadi_int ns = super.size()-1;
+    // Rows of each supernode, diagonal block first
+    std::vector<casadi_int> rowptr(1, 0), lsptr(1, 0), rows, snode(n);
+    for (casadi_int s=0; s<ns; ++s) {
+      casadi_int f = super[s];
+      rows.push_back(f);
+      rows.insert(rows.end(), l_row+l_colind[f], l_row+l_colind[f+1]);
+      rowptr.push_back(rows.size());
+      lsptr.push_back(lsptr.back() + (rowptr[s+1]-rowptr[s])*(super[s+1]-f));
+      for (casadi_int c=f; c<super[s+1]; ++c) snode[c] = s;
+    }
+    // Offset of entry (r, c), r>=c, of L in the supernodes
+    auto offset = [&](casadi_int r, casadi_int c) -> casadi_int {
+      casadi_int s = snode[c];
+      auto first = rows.begin()+rowptr[s], last = rows.begin()+rowptr[s+1];
+      auto it = std::lower_bound(first, last, r);
+      if (it==last || *it!=r) return -1;
+      return lsptr[s] + (it-first) + (c-super[s])*(last-first);
+    };
+    // Upper triangular entries of the permuted A, as read by casadi_ldl
+    std::vector<casadi_int> pinv(n);
+    for (casadi_int i=0; i<n; ++i) pinv[p_[i]] = i;
+    const casadi_int *a_colind = sp_.colind(), *a_row = sp_.row();
+    std::vector<casadi_int> amap(sp_.nnz(), -1);
+    for (casadi_int ca=0; ca<n; ++ca) {
+      casadi_int c = pinv[ca];
+      for (casadi_int k=a_colind[ca]; k<a_colind[ca+1]; ++k) {
+        casadi_int r = pinv[a_row[k]];
+        if (r<=c) amap[k] = offset(c, r);
+      }
+    }
+    // Entries of L^T, in the layout of casadi_ldl
+    const casadi_int *lt_colind = sp_Lt_.colind(), *lt_row = sp_Lt_.row();
+    std::vector<casadi_int> ltmap(sp_Lt_.nnz());
+    for (casadi_int c=0; c<n; ++c) {
+      for (casadi_int k=lt_colind[c]; k<lt_colind[c+1]; ++k) {
+        ltmap[k] = offset(c, lt_row[k]);
+        casadi_assert_dev(ltmap[k]>=0);
+      }
+    }
+    // Assemble
+    sn_ = {n, ns};
+    for (auto v : {&super, &rowptr, &lsptr, &rows, &snode, &amap, &ltmap}) {
+      sn_.insert(sn_.end(), v->begin(), v->end());
     }
   }
 
@@ -107,7 +208,11 @@ namespace casadi {
     casadi_int nrow = this->nrow();
     m->d.resize(nrow);
     m->l.resize(sp_Lt_.nnz());
-    m->w.resize(nrow);
+    m->w.resize(std::max(supernodal_ ? 4 : num_threads_, nrhs_block)*nrow);
+    if (supernodal_) {
+      m->ls.resize(nnz_super());
+      m->iw.resize(nrow + 3*n_super());
+    }
 
     return 0;
   }
@@ -118,7 +223,19 @@ namespace casadi {
 
   int LinsolLdl::nfact(void* mem, const double* A) const {
     auto m = static_cast<LinsolLdlMemory*>(mem);
-    casadi_ldl(sp_, A, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    if (supernodal_) {
+      casadi_ldl_sn(sp_, A, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(sn_),
+        get_ptr(m->ls), get_ptr(m->iw), get_ptr(m->w));
+    } else if (num_threads_>1) {
+      // One work vector per thread
+      casadi_clear(get_ptr(m->w), m->w.size());
+      schedule_.run(num_threads_, [&](casadi_int slot, casadi_int c) {
+        casadi_ldl_col(sp_, A, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), c,
+          get_ptr(m->w) + slot*nrow());
+      });
+    } else {
+      casadi_ldl(sp_, A, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    }
     for (double d : m->d) {
       if (d==0) casadi_warning("LDL factorization has zeros in D");
     }
@@ -127,7 +244,13 @@ namespace casadi {
 
   int LinsolLdl::solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const {
     auto m = static_cast<LinsolLdlMemory*>(mem);
-    casadi_ldl_solve(x, nrhs, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    if (nrhs>1) {
+      // Several right-hand sides per pass over the factor
+      casadi_ldl_solve_blk(x, nrhs, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_),
+        get_ptr(m->w), nrhs_block);
+    } else {
+      casadi_ldl_solve(x, nrhs, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    }
     return 0;
   }
 
@@ -159,31 +282,60 @@ namespace casadi {
     // Place in block to avoid conflicts caused by local variables
     g << "{\n";
     g.comment("FIXME(@jaeandersson): Memory allocation can be avoided");
+    casadi_int sz_w = std::max<casadi_int>(supernodal_ ? 4 : 1, nrhs>1 ? nrhs_block : 1)*nrow();
     g << "casadi_real lt[" << sp_Lt_.nnz() << "], "
          "d[" << nrow() << "], "
-         "w[" << nrow() << "];\n";
+         "w[" << sz_w << "];\n";
 
     // Factorize
-    g << g.ldl(sp, A, sp_Lt, "lt", "d", p, "w") << "\n";
+    if (supernodal_) {
+      g.add_auxiliary(CodeGenerator::AUX_LDL);
+      g << "casadi_real ls[" << nnz_super() << "];\n"
+        << "casadi_int iw[" << nrow() + 3*n_super() << "];\n"
+        << "casadi_ldl_sn(" << sp << ", " << A << ", " << sp_Lt << ", lt, d, "
+        << g.constant(sn_) << ", ls, iw, w);\n";
+    } else {
+      g << g.ldl(sp, A, sp_Lt, "lt", "d", p, "w") << "\n";
+    }
 
     // Solve
-    g << g.ldl_solve(x, nrhs, sp_Lt, "lt", "d", p, "w") << "\n";
+    if (nrhs>1) {
+      g << "casadi_ldl_solve_blk(" << x << ", " << nrhs << ", " << sp_Lt << ", lt, d, "
+        << p << ", w, " << nrhs_block << ");\n";
+    } else {
+      g << g.ldl_solve(x, nrhs, sp_Lt, "lt", "d", p, "w") << "\n";
+    }
 
     // End of block
     g << "}\n";
   }
 
   LinsolLdl::LinsolLdl(DeserializingStream& s) : LinsolInternal(s) {
-    s.version("LinsolLdl", 1);
+    int version = s.version("LinsolLdl", 1, 3);
     s.unpack("LinsolLdl::p", p_);
     s.unpack("LinsolLdl::sp_Lt", sp_Lt_);
+    if (version >= 2) {
+      s.unpack("LinsolLdl::supernodal", supernodal_);
+      s.unpack("LinsolLdl::sn", sn_);
+    } else {
+      supernodal_ = false;
+    }
+    if (version >= 3) {
+      s.unpack("LinsolLdl::num_threads", num_threads_);
+    } else {
+      num_threads_ = 1;
+    }
+    schedule_.init(sp_Lt_, num_threads_);
   }
 
   void LinsolLdl::serialize_body(SerializingStream &s) const {
     LinsolInternal::serialize_body(s);
-    s.version("LinsolLdl", 1);
+    s.version("LinsolLdl", 3);
     s.pack("LinsolLdl::p", p_);
     s.pack("LinsolLdl::sp_Lt", sp_Lt_);
+    s.pack("LinsolLdl::supernodal", supernodal_);
+    s.pack("LinsolLdl::sn", sn_);
+    s.pack("LinsolLdl::num_threads", num_threads_);
   }
 
 } // namespace casadi
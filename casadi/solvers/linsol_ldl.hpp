@@ -42,6 +42,9 @@
 namespace casadi {
   struct CASADI_LINSOL_LDL_EXPORT LinsolLdlMemory : public LinsolMemory {
     std::vector<double> l, d, w;
+    // Supernodal factorization
+    std::vector<double> ls;
+    std::vector<casadi_int> iw;
   };
 
   /** \brief \pluginbrief{LinsolInternal,ldl}
@@ -112,11 +115,27 @@ namespace casadi {
     std::vector<casadi_int> p_;
     Sparsity sp_Lt_;
 
+    // Symbolic supernodal factorization, cf. casadi_ldl_sn
+    std::vector<casadi_int> sn_;
+
+    // Detect supernodes and set up sn_
+    void init_supernodes();
+
+    // Number of supernodes
+    casadi_int n_super() const { return sn_[1];}
+
+    // Total size of the supernodes
+    casadi_int nnz_super() const { return sn_[4+3*n_super()];}
+
     ///@{
     // Options
-    bool incomplete_, amd_;
+    bool incomplete_, amd_, supernodal_;
+    casadi_int num_threads_;
     ///@}
 
+    // Parallel factorization
+    EtreeSchedule schedule_;
+
     /** \brief Serialize an object without type information */
     void serialize_body(SerializingStream &s) const override;
 
@@ -45,6 +45,9 @@ namespace casadi {
     LinsolInternal::registerPlugin(casadi_register_linsol_qr);
   }
 
+  // Number of right-hand sides processed per pass over the factors in solve
+  static const casadi_int nrhs_block = 4;
+
   LinsolQr::LinsolQr(const std::string& name, const Sparsity& sp)
     : LinsolInternal(name, sp) {
   }
@@ -60,7 +63,11 @@ namespace casadi {
         "Minimum R entry before singularity is declared [1e-12]"}},
       {"cache",
        {OT_DOUBLE,
-        "Amount of factorisations to remember (thread-local) [0]"}}
+        "Amount of factorisations to remember (thread-local) [0]"}},
+      {"num_threads",
+       {OT_INT,
+        "Factorize independent subtrees of the column elimination tree "
+        "concurrently, using up to this many threads [1]"}}
      }
   };
 
@@ -71,16 +78,30 @@ namespace casadi {
     // Read options
     eps_ = 1e-12;
     n_cache_ = 0;
+    num_threads_ = 1;
     for (auto&& op : opts) {
       if (op.first=="eps") {
         eps_ = op.second;
       } else if (op.first=="cache") {
         n_cache_ = op.second;
+      } else if (op.first=="num_threads") {
+        num_threads_ = op.second;
       }
     }
+    casadi_assert(num_threads_>=1, "Option 'num_threads' must be positive");
 
     // Symbolic factorization
-    sp_.qr_sparse(sp_v_, sp_r_, prinv_, pc_);
+    if (num_threads_>1) {
+      // Column ordering with independent subtrees
+      std::vector<casadi_int> q = EtreeSchedule::nested_dissection(
+        Sparsity::mtimes(sp_.T(), sp_), 2*num_threads_);
+      std::vector<casadi_int> tmp;
+      sp_.sub(range(nrow()), q, tmp).qr_sparse(sp_v_, sp_r_, prinv_, pc_, false);
+      for (casadi_int& c : pc_) c = q[c];
+    } else {
+      sp_.qr_sparse(sp_v_, sp_r_, prinv_, pc_);
+    }
+    schedule_.init(sp_r_, num_threads_);
   }
 
   void LinsolQr::finalize() {
@@ -96,7 +117,7 @@ namespace casadi {
     m->v.resize(sp_v_.nnz());
     m->r.resize(sp_r_.nnz());
     m->beta.resize(ncol());
-    m->w.resize(nrow() + ncol());
+    m->w.resize(std::max(nrow() + ncol(), std::max(num_threads_, nrhs_block)*sp_v_.size1()));
 
     m->cache.resize(cache_stride_*n_cache_);
     m->cache_loc.resize(n_cache_, -1);
@@ -126,9 +147,19 @@ namespace casadi {
     }
 
     // Cache miss -> compute result
-    casadi_qr(sp_, A, get_ptr(m->w),
-              sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
-              get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_));
+    if (num_threads_>1) {
+      // One work vector per thread
+      casadi_clear(get_ptr(m->w), num_threads_*sp_v_.size1());
+      schedule_.run(num_threads_, [&](casadi_int slot, casadi_int c) {
+        casadi_qr_col(sp_, A, get_ptr(m->w) + slot*sp_v_.size1(),
+                      sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
+                      get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), c);
+      });
+    } else {
+      casadi_qr(sp_, A, get_ptr(m->w),
+                sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
+                get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_));
+    }
     // Check singularity
     double rmin;
     casadi_int irmin, nullity;
@@ -156,9 +187,17 @@ namespace casadi {
 
   int LinsolQr::solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const {
     auto m = static_cast<LinsolQrMemory*>(mem);
-    casadi_qr_solve(x, nrhs, tr,
-                    sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
-                    get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), get_ptr(m->w));
+    if (nrhs>1) {
+      // Several right-hand sides per pass over the factors
+      casadi_qr_solve_blk(x, nrhs, tr,
+                          sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
+                          get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), get_ptr(m->w),
+                          nrhs_block);
+    } else {
+      casadi_qr_solve(x, nrhs, tr,
+                      sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
+                      get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), get_ptr(m->w));
+    }
     return 0;
   }
 
@@ -177,7 +216,7 @@ namespace casadi {
     g << "casadi_real v[" << sp_v_.nnz() << "], "
          "r[" << sp_r_.nnz() << "], "
          "beta[" << ncol() << "], "
-         "w[" << nrow() + ncol() << "];\n";
+         "w[" << std::max(nrow() + ncol(), (nrhs>1 ? nrhs_block : 1)*sp_v_.size1()) << "];\n";
 
     if (n_cache_) {
       g << "casadi_real *c;\n";
@@ -211,14 +250,20 @@ namespace casadi {
     }
 
     // Solve
-    g << g.qr_solve(x, nrhs, tr, sp_v, "v", sp_r, "r", "beta", prinv, pc, "w") << "\n";
+    if (nrhs>1) {
+      g << "casadi_qr_solve_blk(" << x << ", " << nrhs << ", " << (tr ? 1 : 0) << ", "
+        << sp_v << ", v, " << sp_r << ", r, beta, " << prinv << ", " << pc << ", w, "
+        << nrhs_block << ");\n";
+    } else {
+      g << g.qr_solve(x, nrhs, tr, sp_v, "v", sp_r, "r", "beta", prinv, pc, "w") << "\n";
+    }
 
     // End of block
     g << "}\n";
   }
 
   LinsolQr::LinsolQr(DeserializingStream& s) : LinsolInternal(s) {
-    int version = s.version("LinsolQr", 1, 2);
+    int version = s.version("LinsolQr", 1, 3);
     s.unpack("LinsolQr::prinv", prinv_);
     s.unpack("LinsolQr::pc", pc_);
     s.unpack("LinsolQr::sp_v", sp_v_);
@@ -229,17 +274,24 @@ namespace casadi {
     } else {
       n_cache_ = 1;
     }
+    if (version>2) {
+      s.unpack("LinsolQr::num_threads", num_threads_);
+    } else {
+      num_threads_ = 1;
+    }
+    schedule_.init(sp_r_, num_threads_);
   }
 
   void LinsolQr::serialize_body(SerializingStream &s) const {
     LinsolInternal::serialize_body(s);
-    s.version("LinsolQr", 2);
+    s.version("LinsolQr", 3);
     s.pack("LinsolQr::prinv", prinv_);
     s.pack("LinsolQr::pc", pc_);
     s.pack("LinsolQr::sp_v", sp_v_);
     s.pack("LinsolQr::sp_r", sp_r_);
     s.pack("LinsolQr::eps", eps_);
     s.pack("LinsolQr::n_cache", n_cache_);
+    s.pack("LinsolQr::num_threads", num_threads_);
   }
 
 } // namespace casadi
@@ -118,6 +118,10 @@ namespace casadi {
     casadi_int n_cache_;
     casadi_int cache_stride_;
 
+    /// Parallel factorization
+    casadi_int num_threads_;
+    EtreeSchedule schedule_;
+
     /** \brief Serialize an object without type information */
     void serialize_body(SerializingStream &s) const override;
 
@@ -69,7 +69,20 @@ namespace casadi {
         "Print information about each iteration"}},
       {"line_search",
        {OT_BOOL,
-        "Enable line-search (default: true)"}}
+        "Enable line-search (default: true)"}},
+      {"max_reuse",
+       {OT_INT,
+        "Maximum number of additional iterations that reuse the Jacobian and its "
+        "factorization (chord or Shamanskii method). The Jacobian is reevaluated earlier "
+        "if the residual does not contract by contraction_tol (default: 0)"}},
+      {"contraction_tol",
+       {OT_DOUBLE,
+        "Reevaluate the Jacobian when the residual of an iteration with a reused "
+        "Jacobian exceeds this fraction of the previous residual (default: 0.5)"}},
+      {"reuse_across_calls",
+       {OT_BOOL,
+        "Start from the Jacobian and factorization of the previous call, "
+        "for inputs that change little between calls. Requires max_reuse>0 (default: false)"}}
      }
   };
 
@@ -84,6 +97,9 @@ namespace casadi {
     abstolStep_ = 1e-12;
     print_iteration_ = false;
     line_search_ = true;
+    max_reuse_ = 0;
+    contraction_tol_ = 0.5;
+    reuse_across_calls_ = false;
 
     // Read options
     for (auto&& op : opts) {
@@ -97,9 +113,19 @@ namespace casadi {
         print_iteration_ = op.second;
       } else if (op.first=="line_search") {
         line_search_ = op.second;
+      } else if (op.first=="max_reuse") {
+        max_reuse_ = op.second;
+      } else if (op.first=="contraction_tol") {
+        contraction_tol_ = op.second;
+      } else if (op.first=="reuse_across_calls") {
+        reuse_across_calls_ = op.second;
       }
     }
 
+    casadi_assert(max_reuse_>=0, "Option 'max_reuse' must be nonnegative");
+    casadi_assert(!reuse_across_calls_ || max_reuse_>0,
+                  "Option 'reuse_across_calls' requires 'max_reuse' to be positive");
+
     casadi_assert(oracle_.n_in()>0,
                           "Newton: the supplied f must have at least one input.");
     casadi_assert(!linsol_.is_null(),
@@ -113,7 +139,6 @@ namespace casadi {
     alloc_w(n_, true); // F
     alloc_w(n_, true); // dx trial
     alloc_w(n_, true); // F trial
-    alloc_w(sp_jac_.nnz(), true); // J
   }
 
  void Newton::set_work(void* mem, const double**& arg, double**& res,
@@ -124,19 +149,22 @@ namespace casadi {
      m->f = w; w += n_;
      m->x_trial = w; w += n_;
      m->f_trial = w; w += n_;
-     m->jac = w; w += sp_jac_.nnz();
+     m->jac = get_ptr(m->jac_store);
   }
 
   int Newton::solve(void* mem) const {
     auto m = static_cast<NewtonMemory*>(mem);
 
-    scoped_checkout<Linsol> mem_linsol(linsol_);
-
     // Get the initial guess
     casadi_copy(m->iarg[iin_], n_, m->x);
 
+    // Factorization from the previous call, if any, can only be used for chord steps
+    if (!reuse_across_calls_) m->jac_age = -1;
+    double abstol_prev = std::numeric_limits<double>::infinity();
+
     // Perform the Newton iterations
     m->iter=0;
+    m->n_jac = m->n_fact = 0;
     bool success = true;
     while (true) {
       // Break if maximum number of iterations already reached
@@ -151,29 +179,47 @@ namespace casadi {
       // Start a new iteration
       m->iter++;
 
-      // Use x to evaluate g and J
-      std::copy_n(m->iarg, n_in_, m->arg);
-      m->arg[iin_] = m->x;
-      m->res[0] = m->jac;
-      std::copy_n(m->ires, n_out_, m->res+1);
-      m->res[1+iout_] = m->f;
-      calc_function(m, "jac_f_z");
+      // Reuse the Jacobian and factorization of an earlier iteration?
+      bool reuse = m->jac_age > 0 && m->jac_age <= max_reuse_;
+      double abstol;
+      if (reuse) {
+        // Use x to evaluate g
+        std::copy_n(m->iarg, n_in_, m->arg);
+        m->arg[iin_] = m->x;
+        std::copy_n(m->ires, n_out_, m->res);
+        m->res[iout_] = m->f;
+        calc_function(m, "g");
+        abstol = casadi_norm_inf(n_, m->f);
+        // Reevaluate the Jacobian if not converged and not contracting fast enough
+        if (abstol > abstol_ && abstol > contraction_tol_ * abstol_prev) reuse = false;
+      }
+      if (!reuse) {
+        // Use x to evaluate g and J
+        std::copy_n(m->iarg, n_in_, m->arg);
+        m->arg[iin_] = m->x;
+        m->res[0] = m->jac;
+        std::copy_n(m->ires, n_out_, m->res+1);
+        m->res[1+iout_] = m->f;
+        calc_function(m, "jac_f_z");
+        m->n_jac++;
+        abstol = casadi_norm_inf(n_, m->f);
+      }
 
       // Check convergence
-      double abstol = 0;
-      if (abstol_ != std::numeric_limits<double>::infinity()) {
-        for (casadi_int i=0; i<n_; ++i) {
-          abstol = std::max(abstol, fabs(m->f[i]));
-        }
-        if (abstol <= abstol_) {
-          if (verbose_) casadi_message("Converged to acceptable tolerance: " + str(abstol_));
-          break;
-        }
+      if (abstol_ != std::numeric_limits<double>::infinity() && abstol <= abstol_) {
+        if (verbose_) casadi_message("Converged to acceptable tolerance: " + str(abstol_));
+        break;
       }
 
       // Factorize the linear solver with J
-      linsol_.nfact(m->jac, mem_linsol);
-      linsol_.solve(m->jac, m->f, 1, false, mem_linsol);
+      if (!reuse) {
+        linsol_.nfact(m->jac, m->mem_linsol);
+        m->n_fact++;
+        m->jac_age = 0;
+      }
+      linsol_.solve(m->jac, m->f, 1, false, m->mem_linsol);
+      m->jac_age++;
+      abstol_prev = abstol;
 
       // Check convergence again
       double abstolStep=0;
@@ -212,7 +258,13 @@ namespace casadi {
           }
           alpha*= 0.5;
         }
-        if (!success) break;
+        if (!success) {
+          // Not a descent direction with a reused Jacobian, try again with a new one
+          if (!reuse) break;
+          success = true;
+          m->jac_age = -1;
+          continue;
+        }
       } else {
         // X = Xk - J^(-1) F
         casadi_axpy(n_, -alpha, m->f, m->x);
@@ -235,6 +287,7 @@ namespace casadi {
 
     // Store the iteration count
     if (success) m->return_status = "success";
+    if (!success) m->jac_age = -1;
     if (verbose_) casadi_message("Newton algorithm took " + str(m->iter) + " steps");
 
     m->success = success;
@@ -270,35 +323,59 @@ namespace casadi {
     auto m = static_cast<NewtonMemory*>(mem);
     m->return_status = "";
     m->iter = 0;
+    m->n_jac = m->n_fact = 0;
+    m->mem_linsol = linsol_.checkout();
+    m->jac_age = -1;
+    m->jac_store.resize(sp_jac_.nnz());
     return 0;
   }
 
+  void Newton::free_mem(void* mem) const {
+    auto m = static_cast<NewtonMemory*>(mem);
+    if (m->mem_linsol >= 0) linsol_.release(m->mem_linsol);
+    delete m;
+  }
+
   Dict Newton::get_stats(void* mem) const {
     Dict stats = Rootfinder::get_stats(mem);
     auto m = static_cast<NewtonMemory*>(mem);
     stats["return_status"] = m->return_status;
     stats["iter_count"] = m->iter;
+    stats["n_jac"] = m->n_jac;
+    stats["n_fact"] = m->n_fact;
     return stats;
   }
 
 
   Newton::Newton(DeserializingStream& s) : Rootfinder(s) {
-    s.version("Newton", 1);
+    int version = s.version("Newton", 1, 2);
     s.unpack("Newton::max_iter", max_iter_);
     s.unpack("Newton::abstol", abstol_);
     s.unpack("Newton::abstolStep", abstolStep_);
     s.unpack("Newton::print_iteration", print_iteration_);
     s.unpack("Newton::line_search", line_search_);
+    if (version >= 2) {
+      s.unpack("Newton::max_reuse", max_reuse_);
+      s.unpack("Newton::contraction_tol", contraction_tol_);
+      s.unpack("Newton::reuse_across_calls", reuse_across_calls_);
+    } else {
+      max_reuse_ = 0;
+      contraction_tol_ = 0.5;
+      reuse_across_calls_ = false;
+    }
   }
 
   void Newton::serialize_body(SerializingStream &s) const {
     Rootfinder::serialize_body(s);
-    s.version("Newton", 1);
+    s.version("Newton", 2);
     s.pack("Newton::max_iter", max_iter_);
     s.pack("Newton::abstol", abstol_);
     s.pack("Newton::abstolStep", abstolStep_);
     s.pack("Newton::print_iteration", print_iteration_);
     s.pack("Newton::line_search", line_search_);
+    s.pack("Newton::max_reuse", max_reuse_);
+    s.pack("Newton::contraction_tol", contraction_tol_);
+    s.pack("Newton::reuse_across_calls", reuse_across_calls_);
   }
 
 } // namespace casadi
@@ -58,6 +58,14 @@ namespace casadi {
     const char* return_status;
     // Number of iterations
     casadi_int iter;
+    // Number of Jacobian evaluations and factorizations
+    casadi_int n_jac, n_fact;
+    // Linear solver memory, kept between calls
+    int mem_linsol = -1;
+    // Steps taken with the current factorization, -1 if none
+    casadi_int jac_age;
+    // Jacobian of the current factorization, kept between calls
+    std::vector<double> jac_store;
   };
 
   /** \brief \pluginbrief{Rootfinder,newton}
@@ -103,7 +111,7 @@ namespace casadi {
     int init_mem(void* mem) const override;
 
     /** \brief Free memory block */
-    void free_mem(void *mem) const override { delete static_cast<NewtonMemory*>(mem);}
+    void free_mem(void *mem) const override;
 
     /** \brief Set the (persistent) work vectors */
     void set_work(void* mem, const double**& arg, double**& res,
@@ -145,6 +153,15 @@ namespace casadi {
 
     bool line_search_;
 
+    /// Maximum number of additional steps with the same Jacobian and factorization
+    casadi_int max_reuse_;
+
+    /// Reevaluate the Jacobian if the residual decreases by less than this factor
+    double contraction_tol_;
+
+    /// Keep the Jacobian and factorization between calls
+    bool reuse_across_calls_;
+
     /// Print iteration header
     void printIteration(std::ostream &stream) const;
 
@@ -49,6 +49,13 @@ namespace casadi {
     : Conic(name, st) {
   }
 
+  // Copy a vector shifted s entries forward, repeating the last s entries
+  static void shift_copy(const double* v, casadi_int n, casadi_int s, double* r) {
+    s = std::min(s, n);
+    casadi_copy(v + s, n - s, r);
+    casadi_copy(v + n - s, s, r + n - s);
+  }
+
   Qrqp::~Qrqp() {
     clear_mem();
   }
@@ -79,7 +86,22 @@ namespace casadi {
         "Printed numbers are 0-based indices into the vector of [simple bounds;linear bounds]"}},
       {"min_lam",
        {OT_DOUBLE,
-        "Smallest multiplier treated as inactive for the initial active set [0]."}}
+        "Smallest multiplier treated as inactive for the initial active set [0]."}},
+      {"max_updates",
+       {OT_INT,
+        "Maximum number of active set changes handled by low-rank updates of the "
+        "QR factorization before the KKT system is refactorized, 0 to refactorize "
+        "every iteration [10]."}},
+      {"warm_start",
+       {OT_BOOL,
+        "Initialize from the primal-dual solution and active set of the previous "
+        "successful call with the same memory instead of x0, lam_x0 and lam_a0, reusing "
+        "its QR factorization if H and A are unchanged. "
+        "Makes the result depend on the call history [false]."}},
+      {"warm_start_shift",
+       {OT_INTVECTOR,
+        "Shift the stored solution by this many variables and constraints before warm "
+        "starting, repeating the last entries, e.g. for receding horizon problems [0, 0]."}}
      }
   };
 
@@ -104,6 +126,8 @@ namespace casadi {
     print_header_ = true;
     print_info_ = true;
     print_lincomb_ = false;
+    warm_start_ = false;
+    warm_start_shift_ = {0, 0};
 
     // Read user options
     for (auto&& op : opts) {
@@ -115,6 +139,8 @@ namespace casadi {
         p_.dual_inf_tol = op.second;
       } else if (op.first=="min_lam") {
         p_.min_lam = op.second;
+      } else if (op.first=="max_updates") {
+        p_.max_updates = op.second;
       } else if (op.first=="print_iter") {
         print_iter_ = op.second;
       } else if (op.first=="print_header") {
@@ -123,8 +149,16 @@ namespace casadi {
         print_info_ = op.second;
       } else if (op.first=="print_lincomb") {
         print_lincomb_ = op.second;
+      } else if (op.first=="warm_start") {
+        warm_start_ = op.second;
+      } else if (op.first=="warm_start_shift") {
+        warm_start_shift_ = op.second;
       }
     }
+    casadi_assert(warm_start_shift_.size()==2 && warm_start_shift_[0]>=0
+      && warm_start_shift_[1]>=0,
+      "Option 'warm_start_shift' must hold two nonnegative entries");
+    casadi_assert(p_.max_updates>=0, "Option 'max_updates' must be nonnegative");
 
     // Allocate memory
     casadi_int sz_arg, sz_res, sz_w, sz_iw;
@@ -177,6 +211,9 @@ namespace casadi {
     if (Conic::init_mem(mem)) return 1;
     auto m = static_cast<QrqpMemory*>(mem);
     m->return_status = "";
+    m->iter_count = -1;
+    m->warm_started = false;
+    m->has_warm = false;
     return 0;
   }
 
@@ -199,9 +236,26 @@ namespace casadi {
     casadi_fill(d.z+nx_, na_, nan);
     casadi_copy(d_qp.lam_x0, nx_, d.lam);
     casadi_copy(d_qp.lam_a0, na_, d.lam+nx_);
+    // Overwrite guess with the previous solution
+    m->warm_started = warm_start_ && m->has_warm;
+    if (m->warm_started) {
+      const casadi_int sx = warm_start_shift_[0], sa = warm_start_shift_[1];
+      shift_copy(get_ptr(m->z), nx_, sx, d.z);
+      shift_copy(get_ptr(m->lam), nx_, sx, d.lam);
+      shift_copy(get_ptr(m->lam) + nx_, na_, sa, d.lam + nx_);
+    }
 
     // Reset solver
     if (casadi_qrqp_reset(&d)) return 1;
+    // Reuse QR factorization as a base for updates, if formed from the same H and A
+    if (m->warm_started && !m->nz_qr.empty() && d_qp.h && d_qp.a
+        && std::equal(m->h.begin(), m->h.end(), d_qp.h)
+        && std::equal(m->a.begin(), m->a.end(), d_qp.a)) {
+      casadi_copy(get_ptr(m->nz_qr), m->nz_qr.size(), d.nz_v);
+      casadi_copy(get_ptr(m->beta), m->beta.size(), d.beta);
+      std::copy(m->qr_inactive.begin(), m->qr_inactive.end(), d.qr_inactive);
+      d.qr_valid = 1;
+    }
     while (true) {
       // Prepare QP
       int flag = casadi_qrqp_prepare(&d);
@@ -248,6 +302,22 @@ namespace casadi {
         m->return_status = "Printing error";
         break;
     }
+    m->iter_count = d.iter;
+    // Store solution and factorization for warm starting
+    if (warm_start_ && d.status == QP_SUCCESS) {
+      m->z.assign(d.z, d.z + nx_);
+      m->lam.assign(d.lam, d.lam + nx_ + na_);
+      if (d.qr_valid && d_qp.h && d_qp.a) {
+        m->nz_qr.assign(d.nz_v, d.nz_v + sp_v_.nnz() + sp_r_.nnz());
+        m->beta.assign(d.beta, d.beta + nx_ + na_);
+        m->qr_inactive.assign(d.qr_inactive, d.qr_inactive + nx_ + na_);
+        m->h.assign(d_qp.h, d_qp.h + H_.nnz());
+        m->a.assign(d_qp.a, d_qp.a + A_.nnz());
+      } else {
+        m->nz_qr.clear();
+      }
+      m->has_warm = true;
+    }
     // Get solution
     casadi_copy(&d.f, 1, d_qp.f);
     casadi_copy(d.z, nx_, d_qp.x);
@@ -284,6 +354,7 @@ namespace casadi {
     g << "p.min_lam = " << p_.min_lam << ";\n";
     g << "p.constr_viol_tol = " << p_.constr_viol_tol << ";\n";
     g << "p.dual_inf_tol = " << p_.dual_inf_tol << ";\n";
+    g << "p.max_updates = " << p_.max_updates << ";\n";
 
     // Setup data structure
     g << "d.prob = &p;\n";
@@ -348,11 +419,13 @@ namespace casadi {
     Dict stats = Conic::get_stats(mem);
     auto m = static_cast<QrqpMemory*>(mem);
     stats["return_status"] = m->return_status;
+    stats["iter_count"] = m->iter_count;
+    stats["warm_started"] = m->warm_started;
     return stats;
   }
 
   Qrqp::Qrqp(DeserializingStream& s) : Conic(s) {
-    s.version("Qrqp", 1);
+    int version = s.version("Qrqp", 1, 3);
     s.unpack("Qrqp::AT", AT_);
     s.unpack("Qrqp::kkt", kkt_);
     s.unpack("Qrqp::sp_v", sp_v_);
@@ -368,12 +441,24 @@ namespace casadi {
     s.unpack("Qrqp::min_lam", p_.min_lam);
     s.unpack("Qrqp::constr_viol_tol", p_.constr_viol_tol);
     s.unpack("Qrqp::dual_inf_tol", p_.dual_inf_tol);
+    if (version >= 2) {
+      s.unpack("Qrqp::warm_start", warm_start_);
+      s.unpack("Qrqp::warm_start_shift", warm_start_shift_);
+    } else {
+      warm_start_ = false;
+      warm_start_shift_ = {0, 0};
+    }
+    if (version >= 3) {
+      s.unpack("Qrqp::max_updates", p_.max_updates);
+    } else {
+      p_.max_updates = 0;
+    }
   }
 
   void Qrqp::serialize_body(SerializingStream &s) const {
     Conic::serialize_body(s);
 
-    s.version("Qrqp", 1);
+    s.version("Qrqp", 3);
     s.pack("Qrqp::AT", AT_);
     s.pack("Qrqp::kkt", kkt_);
     s.pack("Qrqp::sp_v", sp_v_);
@@ -388,6 +473,9 @@ namespace casadi {
     s.pack("Qrqp::min_lam", p_.min_lam);
     s.pack("Qrqp::constr_viol_tol", p_.constr_viol_tol);
     s.pack("Qrqp::dual_inf_tol", p_.dual_inf_tol);
+    s.pack("Qrqp::warm_start", warm_start_);
+    s.pack("Qrqp::warm_start_shift", warm_start_shift_);
+    s.pack("Qrqp::max_updates", p_.max_updates);
   }
 
 } // namespace casadi
@@ -45,6 +45,16 @@ namespace casadi {
     // Problem data structure
     casadi_qrqp_data<double> d;
     const char* return_status;
+    // Number of iterations of the last solve
+    casadi_int iter_count;
+    // Was the last solve warm started?
+    bool warm_started;
+    // Primal-dual solution of the last successful solve, for warm starting
+    bool has_warm;
+    std::vector<double> z, lam;
+    // Last base QR factorization, the H, A it was formed from and its inactive constraints
+    std::vector<double> nz_qr, beta, h, a;
+    std::vector<casadi_int> qr_inactive;
   };
 
   /** \brief \pluginbrief{Conic,qrqp}
@@ -119,6 +129,8 @@ namespace casadi {
     ///@{
     // Options
     bool print_iter_, print_header_, print_info_, print_lincomb_;
+    bool warm_start_;
+    std::vector<casadi_int> warm_start_shift_;
     ///@}
 
     void serialize_body(SerializingStream &s) const override;
@@ -0,0 +1,522 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "riccati.hpp"
+
+#include <numeric>
+
+namespace casadi {
+
+  extern "C"
+  int CASADI_CONIC_RICCATI_EXPORT
+  casadi_register_conic_riccati(Conic::Plugin* plugin) {
+    plugin->creator = Riccati::creator;
+    plugin->name = "riccati";
+    plugin->doc = Riccati::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &Riccati::options_;
+    plugin->deserialize = &Riccati::deserialize;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_CONIC_RICCATI_EXPORT casadi_load_conic_riccati() {
+    Conic::registerPlugin(casadi_register_conic_riccati);
+  }
+
+  Riccati::Riccati(const std::string& name, const std::map<std::string, Sparsity> &st)
+    : Conic(name, st) {
+  }
+
+  Riccati::~Riccati() {
+    clear_mem();
+  }
+
+  const Options Riccati::options_
+  = {{&Conic::options_},
+     {{"max_iter",
+       {OT_INT,
+        "Maximum number of iterations [100]."}},
+      {"pr_tol",
+       {OT_DOUBLE,
+        "Primal feasibility tolerance [1e-8]."}},
+      {"du_tol",
+       {OT_DOUBLE,
+        "Dual feasibility tolerance [1e-8]."}},
+      {"co_tol",
+       {OT_DOUBLE,
+        "Complementarity tolerance [1e-8]."}},
+      {"mu_tol",
+       {OT_DOUBLE,
+        "Barrier parameter tolerance [1e-8]."}},
+      {"print_header",
+       {OT_BOOL,
+        "Print header [true]."}},
+      {"print_iter",
+       {OT_BOOL,
+        "Print iterations [true]."}},
+      {"print_info",
+       {OT_BOOL,
+        "Print info [true]."}},
+      {"N",
+       {OT_INT,
+        "OCP horizon"}},
+      {"nx",
+       {OT_INTVECTOR,
+        "Number of states, length N+1"}},
+      {"nu",
+       {OT_INTVECTOR,
+        "Number of controls, length N"}},
+      {"ng",
+       {OT_INTVECTOR,
+        "Number of non-dynamic constraints, length N+1"}},
+      {"max_delayed",
+       {OT_INT,
+        "Maximum number of rows of a stage that can be delayed to the previous stage "
+        "when they cannot be pivoted on, e.g. dynamics of fixed states "
+        "[number of rows of the largest stage]."}},
+      {"pivot_tol",
+       {OT_DOUBLE,
+        "Pivots smaller than this are delayed to the previous stage [1e-12]."}}
+     }
+  };
+
+  void Riccati::init(const Dict& opts) {
+    // Initialize the base classes
+    Conic::init(opts);
+    // Setup memory structure
+    casadi_ipqp_setup(&p_, nx_, na_);
+    // Default options
+    print_iter_ = true;
+    print_header_ = true;
+    print_info_ = true;
+    nd_max_ = -1;
+    pivot_tol_ = 1e-12;
+    casadi_int N = 0, struct_cnt = 0;
+    std::vector<casadi_int> nxs, nus, ngs;
+    // Read user options
+    for (auto&& op : opts) {
+      if (op.first=="max_iter") {
+        p_.max_iter = op.second;
+      } else if (op.first=="pr_tol") {
+        p_.pr_tol = op.second;
+      } else if (op.first=="du_tol") {
+        p_.du_tol = op.second;
+      } else if (op.first=="co_tol") {
+        p_.co_tol = op.second;
+      } else if (op.first=="mu_tol") {
+        p_.mu_tol = op.second;
+      } else if (op.first=="print_iter") {
+        print_iter_ = op.second;
+      } else if (op.first=="print_header") {
+        print_header_ = op.second;
+      } else if (op.first=="print_info") {
+        print_info_ = op.second;
+      } else if (op.first=="N") {
+        N = op.second;
+        struct_cnt++;
+      } else if (op.first=="nx") {
+        nxs = op.second;
+        struct_cnt++;
+      } else if (op.first=="nu") {
+        nus = op.second;
+        struct_cnt++;
+      } else if (op.first=="ng") {
+        ngs = op.second;
+        struct_cnt++;
+      } else if (op.first=="max_delayed") {
+        nd_max_ = op.second;
+      } else if (op.first=="pivot_tol") {
+        pivot_tol_ = op.second;
+      }
+    }
+    casadi_assert(struct_cnt==0 || struct_cnt==4,
+      "You must either set all of N, nx, nu, ng; "
+      "or set none at all (automatic detection).");
+
+    if (struct_cnt==0) {
+      detect_stages();
+    } else {
+      // Stage k holds the states and controls of time point k
+      if (nus.size()==N+1) {
+        casadi_assert(nus.back()==0, "No controls allowed at the end of the horizon");
+        nus.pop_back();
+      }
+      casadi_assert(nxs.size()==N+1, "nx must have length N+1");
+      casadi_assert(nus.size()==N, "nu must have length N");
+      casadi_assert(ngs.size()==N+1, "ng must have length N+1");
+      casadi_assert(nx_ == std::accumulate(nxs.begin(), nxs.end(), casadi_int(0)) +
+        std::accumulate(nus.begin(), nus.end(), casadi_int(0)),
+        "sum(nx)+sum(nu) must equal total size of variables (" + str(nx_) + ").");
+      casadi_assert(na_ == std::accumulate(nxs.begin()+1, nxs.end(), casadi_int(0)) +
+        std::accumulate(ngs.begin(), ngs.end(), casadi_int(0)),
+        "sum(nx[1:])+sum(ng) must equal total size of constraints (" + str(na_) + ").");
+      x_off_.resize(N+2);
+      x_off_[0] = 0;
+      for (casadi_int k=0; k<=N; ++k) {
+        x_off_[k+1] = x_off_[k] + nxs[k] + (k<N ? nus[k] : 0);
+      }
+    }
+    assign_constraints();
+
+    // Default bound on the number of delayed rows: all rows of the largest stage
+    if (nd_max_<0) {
+      nd_max_ = 0;
+      for (casadi_int k=0; k+1<x_off_.size(); ++k) {
+        nd_max_ = std::max(nd_max_, x_off_[k+1]-x_off_[k] + a_off_[k+1]-a_off_[k]);
+      }
+    }
+    set_qp_prob();
+
+    // Memory for IP solver
+    alloc_w(casadi_ipqp_sz_w(&p_), true);
+    // Memory for the Riccati recursion
+    casadi_int sz_iw, sz_w;
+    casadi_riccati_work(&r_, &sz_iw, &sz_w);
+    alloc_iw(sz_iw, true);
+    alloc_w(sz_w, true);
+
+    // Print summary
+    if (print_header_) {
+      casadi_int m_max = r_.m_max;
+      print("-------------------------------------------\n");
+      print("This is casadi::Riccati\n");
+      print("Number of variables:             %12d\n", nx_);
+      print("Number of constraints:           %12d\n", na_);
+      print("Number of nonzeros in H:         %12d\n", H_.nnz());
+      print("Number of nonzeros in A:         %12d\n", A_.nnz());
+      print("Number of stages:                %12d\n", r_.N);
+      print("Largest stage:                   %12d\n", m_max);
+    }
+  }
+
+  void Riccati::detect_stages() {
+    // Smallest variable index coupled with each variable
+    std::vector<casadi_int> lo = range(nx_);
+    const casadi_int *h_colind = H_.colind(), *h_row = H_.row();
+    for (casadi_int c=0; c<nx_; ++c) {
+      for (casadi_int k=h_colind[c]; k<h_colind[c+1]; ++k) {
+        lo[c] = std::min(lo[c], h_row[k]);
+      }
+    }
+    Sparsity AT = A_.T();
+    const casadi_int *at_colind = AT.colind(), *at_row = AT.row();
+    for (casadi_int r=0; r<na_; ++r) {
+      if (at_colind[r]==at_colind[r+1]) continue;
+      // Columns are sorted, the first one is the smallest
+      casadi_int first = at_row[at_colind[r]];
+      for (casadi_int k=at_colind[r]; k<at_colind[r+1]; ++k) {
+        lo[at_row[k]] = std::min(lo[at_row[k]], first);
+      }
+    }
+    // last[t]: largest variable coupled with a variable before t
+    std::vector<casadi_int> last(nx_+1, -1);
+    for (casadi_int j=0; j<nx_; ++j) last[lo[j]+1] = std::max(last[lo[j]+1], j);
+    for (casadi_int t=1; t<=nx_; ++t) last[t] = std::max(last[t], last[t-1]);
+    // Smallest stages such that only neighbouring stages are coupled
+    x_off_.clear();
+    x_off_.push_back(0);
+    while (x_off_.back()<nx_) {
+      casadi_int b = x_off_.back();
+      x_off_.push_back(std::max(b+1, last[b]+1));
+    }
+    // At least one stage
+    if (x_off_.size()==1) x_off_.push_back(0);
+  }
+
+  void Riccati::assign_constraints() {
+    casadi_int n_stage = x_off_.size()-1;
+    // Stage of each variable
+    std::vector<casadi_int> stage(nx_);
+    for (casadi_int k=0; k<n_stage; ++k) {
+      for (casadi_int i=x_off_[k]; i<x_off_[k+1]; ++i) stage[i] = k;
+    }
+    // The Hessian may only couple neighbouring stages
+    const casadi_int *h_colind = H_.colind(), *h_row = H_.row();
+    for (casadi_int c=0; c<nx_; ++c) {
+      for (casadi_int k=h_colind[c]; k<h_colind[c+1]; ++k) {
+        casadi_assert(std::abs(stage[c]-stage[h_row[k]])<=1,
+          "Hessian entry (" + str(h_row[k]) + ", " + str(c) + ") couples stages "
+          + str(stage[h_row[k]]) + " and " + str(stage[c]) + ".");
+      }
+    }
+    // Each constraint belongs to the last stage it depends on
+    Sparsity AT = A_.T();
+    const casadi_int *at_colind = AT.colind(), *at_row = AT.row();
+    std::vector<casadi_int> a_stage(na_);
+    for (casadi_int r=0; r<na_; ++r) {
+      if (at_colind[r]==at_colind[r+1]) {
+        // Empty rows are eliminated first
+        a_stage[r] = n_stage-1;
+      } else {
+        casadi_int s0 = stage[at_row[at_colind[r]]];
+        casadi_int s1 = stage[at_row[at_colind[r+1]-1]];
+        casadi_assert(s1-s0<=1, "Constraint " + str(r) + " couples stages "
+          + str(s0) + " and " + str(s1) + ".");
+        a_stage[r] = s1;
+      }
+    }
+    a_off_.assign(n_stage+1, 0);
+    for (casadi_int r=0; r<na_; ++r) a_off_[a_stage[r]+1]++;
+    for (casadi_int k=0; k<n_stage; ++k) a_off_[k+1] += a_off_[k];
+    a_row_.resize(na_);
+    std::vector<casadi_int> pos(a_off_.begin(), a_off_.end()-1);
+    for (casadi_int r=0; r<na_; ++r) a_row_[pos[a_stage[r]]++] = r;
+  }
+
+  void Riccati::set_qp_prob() {
+    r_.sp_h = H_;
+    r_.sp_a = A_;
+    r_.N = x_off_.size()-1;
+    r_.x_off = get_ptr(x_off_);
+    r_.a_off = get_ptr(a_off_);
+    r_.a_row = get_ptr(a_row_);
+    r_.nd_max = nd_max_;
+    casadi_riccati_setup(&r_);
+    r_.tol = pivot_tol_;
+  }
+
+  int Riccati::init_mem(void* mem) const {
+    if (Conic::init_mem(mem)) return 1;
+    auto m = static_cast<RiccatiMemory*>(mem);
+    m->return_status = "";
+    return 0;
+  }
+
+  int Riccati::
+  solve(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
+    auto m = static_cast<RiccatiMemory*>(mem);
+    // Message buffer
+    char buf[121];
+    // Setup IP solver
+    casadi_ipqp_data<double> d;
+    d.prob = &p_;
+    casadi_ipqp_init(&d, &iw, &w);
+    casadi_ipqp_bounds(&d, arg[CONIC_G],
+      arg[CONIC_LBX], arg[CONIC_UBX], arg[CONIC_LBA], arg[CONIC_UBA]);
+    casadi_ipqp_guess(&d, arg[CONIC_X0], arg[CONIC_LAM_X0], arg[CONIC_LAM_A0]);
+    // Setup Riccati recursion
+    casadi_riccati_data<double> r;
+    r.prob = &r_;
+    casadi_riccati_init(&r, &iw, &w);
+    // Reverse communication loop
+    while (casadi_ipqp(&d)) {
+      switch (d.task) {
+      case IPQP_MV:
+        // Matrix-vector multiplication
+        casadi_mv(arg[CONIC_H], H_, d.z, d.rz, 0);
+        casadi_mv(arg[CONIC_A], A_, d.lam + p_.nx, d.rz, 1);
+        casadi_mv(arg[CONIC_A], A_, d.z, d.rz + p_.nx, 0);
+        break;
+      case IPQP_PROGRESS:
+        // Print progress
+        if (print_iter_) {
+          if (d.iter % 10 == 0) {
+            // Print header
+            if (casadi_ipqp_print_header(&d, buf, sizeof(buf))) break;
+            uout() << buf << "\n";
+          }
+          // Print iteration
+          if (casadi_ipqp_print_iteration(&d, buf, sizeof(buf))) break;
+          uout() << buf << "\n";
+          // User interrupt?
+          InterruptHandler::check();
+        }
+        break;
+      case IPQP_FACTOR:
+        // Factorize KKT with a backward recursion over the stages
+        if (casadi_riccati_factor(&r, arg[CONIC_H], arg[CONIC_A], d.S, d.D))
+          d.status = IPQP_FACTOR_ERROR;
+        break;
+      case IPQP_SOLVE:
+        // Solve KKT
+        casadi_riccati_solve(&r, d.linsys);
+        break;
+      }
+    }
+    // Read return status
+    m->return_status = casadi_ipqp_return_status(d.status);
+    if (d.status == IPQP_MAX_ITER)
+      m->d_qp.unified_return_status = SOLVER_RET_LIMITED;
+    // Get solution
+    casadi_ipqp_solution(&d, res[CONIC_X], res[CONIC_LAM_X], res[CONIC_LAM_A]);
+    if (res[CONIC_COST]) {
+      *res[CONIC_COST] = .5 * casadi_bilin(arg[CONIC_H], H_, d.z, d.z)
+        + casadi_dot(p_.nx, d.z, d.g);
+    }
+    // Return
+    if (verbose_) casadi_warning(m->return_status);
+    m->d_qp.success = d.status == IPQP_SUCCESS;
+    return 0;
+  }
+
+  void Riccati::codegen_body(CodeGenerator& g) const {
+    qp_codegen_body(g);
+    g.add_auxiliary(CodeGenerator::AUX_IPQP);
+    g.add_auxiliary(CodeGenerator::AUX_RICCATI);
+    if (print_iter_) g.add_auxiliary(CodeGenerator::AUX_PRINTF);
+    g.local("d", "struct casadi_ipqp_data");
+    g.local("p", "struct casadi_ipqp_prob");
+    g.local("r", "struct casadi_riccati_data");
+    g.local("pr", "struct casadi_riccati_prob");
+    if (print_iter_) g.local("buf[121]", "char");
+
+    // Setup memory structures
+    g << "casadi_ipqp_setup(&p, " << nx_ << ", " << na_ << ");\n";
+    g << "p.max_iter = " << p_.max_iter << ";\n";
+    g << "p.pr_tol = " << p_.pr_tol << ";\n";
+    g << "p.du_tol = " << p_.du_tol << ";\n";
+    g << "p.co_tol = " << p_.co_tol << ";\n";
+    g << "p.mu_tol = " << p_.mu_tol << ";\n";
+    g << "pr.sp_h = " << g.sparsity(H_) << ";\n";
+    g << "pr.sp_a = " << g.sparsity(A_) << ";\n";
+    g << "pr.N = " << r_.N << ";\n";
+    g << "pr.x_off = " << g.constant(x_off_) << ";\n";
+    g << "pr.a_off = " << g.constant(a_off_) << ";\n";
+    g << "pr.a_row = " << g.constant(a_row_) << ";\n";
+    g << "pr.nd_max = " << r_.nd_max << ";\n";
+    g << "casadi_riccati_setup(&pr);\n";
+    g << "pr.tol = " << r_.tol << ";\n";
+
+    // Setup data structures
+    g << "d.prob = &p;\n";
+    g << "casadi_ipqp_init(&d, &iw, &w);\n";
+    g << "r.prob = &pr;\n";
+    g << "casadi_riccati_init(&r, &iw, &w);\n";
+
+    g.comment("Pass bounds on z");
+    g << "d.g = " << g.arg(CONIC_G) << ";\n";
+    g.copy_default(g.arg(CONIC_LBX), nx_, "d.lbz", "-casadi_inf", false);
+    g.copy_default(g.arg(CONIC_LBA), na_, "d.lbz+" + str(nx_), "-casadi_inf", false);
+    g.copy_default(g.arg(CONIC_UBX), nx_, "d.ubz", "casadi_inf", false);
+    g.copy_default(g.arg(CONIC_UBA), na_, "d.ubz+" + str(nx_), "casadi_inf", false);
+
+    g.comment("Pass initial guess");
+    g.copy_default(g.arg(CONIC_X0), nx_, "d.z", "0", false);
+    g << g.clear("d.z+" + str(nx_), na_) << "\n";
+    g.copy_default(g.arg(CONIC_LAM_X0), nx_, "d.lam", "0", false);
+    g.copy_default(g.arg(CONIC_LAM_A0), na_, "d.lam+" + str(nx_), "0", false);
+    g << g.clear("d.lam_lbz", nx_ + na_) << "\n";
+    g << g.clear("d.lam_ubz", nx_ + na_) << "\n";
+
+    g.comment("Solve QP");
+    g << "while (casadi_ipqp(&d)) {\n";
+    g << "switch (d.task) {\n";
+    g << "case IPQP_MV:\n";
+    g << g.mv(g.arg(CONIC_H), H_, "d.z", "d.rz", false) << "\n";
+    g << g.mv(g.arg(CONIC_A), A_, "d.lam+" + str(nx_), "d.rz", true) << "\n";
+    g << g.mv(g.arg(CONIC_A), A_, "d.z", "d.rz+" + str(nx_), false) << "\n";
+    g << "break;\n";
+    g << "case IPQP_PROGRESS:\n";
+    if (print_iter_) {
+      // Print header
+      g << "if (d.iter % 10 == 0) {\n";
+      g << "if (casadi_ipqp_print_header(&d, buf, sizeof(buf))) break;\n";
+      g << g.printf("%s\\n", "buf") << "\n";
+      g << "}\n";
+      // Print iteration
+      g << "if (casadi_ipqp_print_iteration(&d, buf, sizeof(buf))) break;\n";
+      g << g.printf("%s\\n", "buf") << "\n";
+    }
+    g << "break;\n";
+    g << "case IPQP_FACTOR:\n";
+    g << "if (casadi_riccati_factor(&r, " << g.arg(CONIC_H) << ", " << g.arg(CONIC_A)
+      << ", d.S, d.D)) d.status = IPQP_FACTOR_ERROR;\n";
+    g << "break;\n";
+    g << "case IPQP_SOLVE:\n";
+    g << "casadi_riccati_solve(&r, d.linsys);\n";
+    g << "break;\n";
+    g << "}\n";
+    g << "}\n";
+
+    g.comment("Get solution");
+    g << "if (" << g.res(CONIC_COST) << ") {\n";
+    g << g.res(CONIC_COST) << "[0] = 0;\n";
+    g << "if (" << g.arg(CONIC_H) << ") " << g.res(CONIC_COST) << "[0] += 0.5*"
+      << g.bilin(g.arg(CONIC_H), H_, "d.z", "d.z") << ";\n";
+    g << "if (d.g) " << g.res(CONIC_COST) << "[0] += "
+      << g.dot(nx_, "d.z", "d.g") << ";\n";
+    g << "}\n";
+    g.copy_check("d.z", nx_, g.res(CONIC_X), false, true);
+    g.copy_check("d.lam", nx_, g.res(CONIC_LAM_X), false, true);
+    g.copy_check("d.lam+"+str(nx_), na_, g.res(CONIC_LAM_A), false, true);
+
+    g << "if (d.status == IPQP_SUCCESS) {\n";
+    g << "return 0;\n";
+    g << "} else {\n";
+    if (error_on_fail_) {
+      g << "return -1000;\n";
+    } else {
+      g << "return -1;\n";
+    }
+    g << "}\n";
+  }
+
+  Dict Riccati::get_stats(void* mem) const {
+    Dict stats = Conic::get_stats(mem);
+    auto m = static_cast<RiccatiMemory*>(mem);
+    stats["return_status"] = m->return_status;
+    return stats;
+  }
+
+  Riccati::Riccati(DeserializingStream& s) : Conic(s) {
+    s.version("Riccati", 1);
+    s.unpack("Riccati::print_iter", print_iter_);
+    s.unpack("Riccati::print_header", print_header_);
+    s.unpack("Riccati::print_info", print_info_);
+    s.unpack("Riccati::x_off", x_off_);
+    s.unpack("Riccati::a_off", a_off_);
+    s.unpack("Riccati::a_row", a_row_);
+    s.unpack("Riccati::nd_max", nd_max_);
+    s.unpack("Riccati::pivot_tol", pivot_tol_);
+    casadi_ipqp_setup(&p_, nx_, na_);
+    s.unpack("Riccati::max_iter", p_.max_iter);
+    s.unpack("Riccati::pr_tol", p_.pr_tol);
+    s.unpack("Riccati::du_tol", p_.du_tol);
+    s.unpack("Riccati::co_tol", p_.co_tol);
+    s.unpack("Riccati::mu_tol", p_.mu_tol);
+    set_qp_prob();
+  }
+
+  void Riccati::serialize_body(SerializingStream &s) const {
+    Conic::serialize_body(s);
+
+    s.version("Riccati", 1);
+    s.pack("Riccati::print_iter", print_iter_);
+    s.pack("Riccati::print_header", print_header_);
+    s.pack("Riccati::print_info", print_info_);
+    s.pack("Riccati::x_off", x_off_);
+    s.pack("Riccati::a_off", a_off_);
+    s.pack("Riccati::a_row", a_row_);
+    s.pack("Riccati::nd_max", nd_max_);
+    s.pack("Riccati::pivot_tol", pivot_tol_);
+    s.pack("Riccati::max_iter", p_.max_iter);
+    s.pack("Riccati::pr_tol", p_.pr_tol);
+    s.pack("Riccati::du_tol", p_.du_tol);
+    s.pack("Riccati::co_tol", p_.co_tol);
+    s.pack("Riccati::mu_tol", p_.mu_tol);
+  }
+
+} // namespace casadi
@@ -35,6 +35,7 @@
 #endif // OBJECT_FILE_SUFFIX
 
 #include <cstdlib>
+#include "casadi/core/thread_pool.hpp"
 
 namespace casadi {
 
@@ -65,6 +66,9 @@ namespace casadi {
     if (cleanup_) {
       if (remove(bin_name_.c_str())) casadi_warning("Failed to remove " + bin_name_);
       if (remove(obj_name_.c_str())) casadi_warning("Failed to remove " + obj_name_);
+      for (const std::string& s : extra_obj_names_) {
+        if (remove(s.c_str())) casadi_warning("Failed to remove " + s);
+      }
       for (const std::string& s : extra_suffixes_) {
         std::string name = base_name_+s;
         remove(name.c_str());
@@ -119,6 +123,10 @@ namespace casadi {
         "The file name used to write out compiled objects/libraries. "
         "The actual file names used depend on 'temp_suffix' and include extensions. "
         "Default: 'tmp_casadi_compiler_shell'"}},
+      {"sources",
+       {OT_STRINGVECTOR,
+        "Additional source files, compiled concurrently with the main source file "
+        "and linked into the same library. Default: None"}},
       {"temp_suffix",
        {OT_BOOL,
         "Use a temporary (seemingly random) filename suffix for file names. "
@@ -141,6 +149,7 @@ namespace casadi {
 
     std::vector<std::string> compiler_flags;
     std::vector<std::string> linker_flags;
+    std::vector<std::string> sources;
     std::string suffix = OBJECT_FILE_SUFFIX;
 
 #ifdef _WIN32
@@ -188,6 +197,8 @@ namespace casadi {
         bare_name = op.second.to_string();
       } else if (op.first=="temp_suffix") {
         temp_suffix = op.second;
+      } else if (op.first=="sources") {
+        sources = op.second;
       }
     }
 
@@ -211,32 +222,53 @@ namespace casadi {
     }
 #endif // _WIN32
 
-    // Construct the compiler command
-    std::stringstream cccmd;
-    cccmd << compiler;
-    for (auto i=compiler_flags.begin(); i!=compiler_flags.end(); ++i) {
-      cccmd << " " << *i;
+    // Object files for the additional sources
+    std::vector<std::string> src_names = {name_}, obj_names = {obj_name_};
+    std::string obj_base = obj_name_.substr(0, obj_name_.size()-suffix.size());
+    extra_obj_names_.clear();
+    for (casadi_int k=0; k<sources.size(); ++k) {
+      extra_obj_names_.push_back(obj_base + "_" + str(k+1) + suffix);
+      src_names.push_back(sources[k]);
+      obj_names.push_back(extra_obj_names_.back());
     }
-    cccmd << " " << compiler_setup;
 
-    // C/C++ source file
-    cccmd << " " << name_;
+    // Construct the compiler commands
+    std::vector<std::string> cccmd;
+    for (casadi_int k=0; k<src_names.size(); ++k) {
+      std::stringstream ss;
+      ss << compiler;
+      for (auto i=compiler_flags.begin(); i!=compiler_flags.end(); ++i) {
+        ss << " " << *i;
+      }
+      ss << " " << compiler_setup;
 
-    // Temporary object file
-    cccmd << " " + compiler_output_flag << obj_name_;
+      // C/C++ source file
+      ss << " " << src_names[k];
+
+      // Temporary object file
+      ss << " " + compiler_output_flag << obj_names[k];
+      cccmd.push_back(ss.str());
+      if (verbose_) casadi_message("calling \"" + cccmd.back() + "\"");
+    }
 
-    // Compile into an object
-    if (verbose_) casadi_message("calling \"" + cccmd.str() + "\"");
-    if (system(cccmd.str().c_str())) {
-      casadi_error("Compilation failed. Tried \"" + cccmd.str() + "\"");
+    // Compile into objects, concurrently
+    casadi_int n_cc = cccmd.size();
+    std::vector<int> flag(n_cc, 0);
+    ThreadPool::instance().run(n_cc, std::min(n_cc, ThreadPool::hardware_concurrency()), 1,
+      [&](casadi_int slot, casadi_int begin, casadi_int end) {
+        for (casadi_int k=begin; k<end; ++k) flag[k] = system(cccmd[k].c_str());
+      });
+    for (casadi_int k=0; k<n_cc; ++k) {
+      if (flag[k]) casadi_error("Compilation failed. Tried \"" + cccmd[k] + "\"");
     }
 
     // Link step
     std::stringstream ldcmd;
     ldcmd << linker;
 
-    // Temporary file
-    ldcmd << " " << obj_name_ << " " + linker_output_flag + bin_name_;
+    // Temporary files
+    for (auto&& obj : obj_names) ldcmd << " " << obj;
+    ldcmd << " " + linker_output_flag + bin_name_;
 
     // Add flags
     for (auto i=linker_flags.begin(); i!=linker_flags.end(); ++i) {
@@ -100,6 +100,9 @@ namespace casadi {
     /// Extra files
     std::vector<std::string> extra_suffixes_;
 
+    /// Object files of additional sources
+    std::vector<std::string> extra_obj_names_;
+
     /// Cleanup temporary files when unloading
     bool cleanup_;
 
@@ -4434,6 +4434,7 @@ namespace casadi {
 %include <casadi/core/importer.hpp>
 %include <casadi/core/callback.hpp>
 %include <casadi/core/global_options.hpp>
+%include <casadi/core/node_arena.hpp>
 %include <casadi/core/casadi_meta.hpp>
 %include <casadi/core/integration_tools.hpp>
 %include <casadi/core/nlp_tools.hpp>
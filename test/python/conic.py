@@ -1207,7 +1207,161 @@ class ConicTests(casadiTestCase):
     # extralibs=extralibs,extra_options=aux_options["codegen"]   
     print("codegen starts here")   
     self.check_codegen(solver,dict(a=A,h=H,lba=lbg,uba=ubg,g=g,lbx=lbx,ubx=ubx,x0=sol["x"],lam_a0=sol["lam_a"],lam_x0=sol["lam_x"]),std="c99",extralibs=["hpipm","blasfeo"])
-        
+
+  @requires_conic("riccati")
+  @requires_conic("qrqp")
+  def test_riccati(self):
+    N = 15
+    A = DM([[1, 0.1], [0, 1]])
+    B = DM([[0.005], [0.1]])
+
+    for terminal in [False, True]:
+      X = [MX.sym("x%d" % k, 2) for k in range(N+1)]
+      U = [MX.sym("u%d" % k) for k in range(N)]
+      w = []
+      lbw = []
+      ubw = []
+      g = []
+      lbg = []
+      ubg = []
+      J = 0
+      for k in range(N):
+        w += [X[k], U[k]]
+        if k==0:
+          lbw += [1, 0]
+          ubw += [1, 0]
+        else:
+          lbw += [-inf, -2]
+          ubw += [inf, 2]
+        lbw += [-5]
+        ubw += [5]
+        J += sumsqr(X[k]) + 0.1*U[k]**2 + 0.3*X[k][0]*U[k]
+        g += [mtimes(A, X[k]) + mtimes(B, U[k]) - X[k+1]]
+        lbg += [0, 0]
+        ubg += [0, 0]
+        g += [X[k][0]+X[k][1]]
+        lbg += [-inf]
+        ubg += [1.2]
+      w += [X[N]]
+      lbw += [-inf, -inf]
+      ubw += [inf, inf]
+      J += 10*sumsqr(X[N])
+      if terminal:
+        # Terminal state constraint: rows that cannot be pivoted on in the last stage
+        g += [X[N]]
+        lbg += [0, 0]
+        ubg += [0, 0]
+      prob = {'f': J, 'x': vertcat(*w), 'g': vertcat(*g)}
+      args = dict(lbx=vertcat(*lbw), ubx=vertcat(*ubw), lbg=vertcat(*lbg), ubg=vertcat(*ubg))
+
+      solver_ref = qpsol('solver', 'qrqp', prob, {"print_iter":False, "print_header":False})
+      sol_ref = solver_ref(**args)
+
+      ng = [1]*N + [2 if terminal else 0]
+      for opts in [{}, {"N":N, "nx":[2]*(N+1), "nu":[1]*N, "ng":ng}]:
+        opts["print_iter"] = False
+        opts["print_header"] = False
+        solver = qpsol('solver', 'riccati', prob, opts)
+        sol = solver(**args)
+        self.assertTrue(solver.stats()["success"])
+        self.checkarray(sol_ref["x"], sol["x"], digits=6)
+        self.checkarray(sol_ref["lam_g"], sol["lam_g"], digits=6)
+        self.checkarray(sol_ref["lam_x"], sol["lam_x"], digits=6)
+        self.checkarray(sol_ref["f"], sol["f"], digits=6)
+        self.check_serialize(solver, args)
+      self.check_codegen(solver, args, std="c99")
+
+    # Couplings between non-neighbouring stages are rejected
+    ng[-1] += 1
+    with self.assertInException("couples stages"):
+      qpsol('solver', 'riccati', prob, {"N":N, "nx":[3]+[2]*(N-1)+[1], "nu":[1]*N, "ng":ng})
+
+  def test_warm_start(self):
+    # Closed-loop MPC: each QP differs from the previous one in the initial state only
+    N = 30
+    A = DM([[1, 0.1], [0, 1]])
+    B = DM([[0.005], [0.1]])
+    X = [MX.sym("x%d" % k, 2) for k in range(N+1)]
+    U = [MX.sym("u%d" % k) for k in range(N)]
+    w = []
+    lbw = []
+    ubw = []
+    g = []
+    J = 0
+    for k in range(N):
+      w += [X[k], U[k]]
+      lbw += [-inf, -1, -0.5]
+      ubw += [inf, 1, 0.5]
+      J += sumsqr(X[k]) + 0.1*U[k]**2
+      g += [mtimes(A, X[k]) + mtimes(B, U[k]) - X[k+1], X[k][0]+X[k][1]]
+    w += [X[N]]
+    lbw += [-inf, -inf]
+    ubw += [inf, inf]
+    J += 10*sumsqr(X[N])
+    prob = {'f': J, 'x': vertcat(*w), 'g': vertcat(*g)}
+    lbg = [0, 0, -inf]*N
+    ubg = [0, 0, 1.2]*N
+
+    for conic in ["ipqp", "qrqp"]:
+      opts = {"print_iter":False, "print_header":False, "print_info":False}
+      cold = qpsol('cold', conic, prob, opts)
+      opts["warm_start"] = True
+      warm = qpsol('warm', conic, prob, opts)
+      opts["warm_start_shift"] = [3, 3]
+      shift = qpsol('shift', conic, prob, opts)
+      x0 = [-1.5, 0]
+      iter_count = {"cold": 0, "warm": 0, "shift": 0}
+      for step in range(10):
+        args = dict(lbx=vertcat(x0, lbw[2:]), ubx=vertcat(x0, ubw[2:]), lbg=lbg, ubg=ubg)
+        sol_cold = cold(**args)
+        for solver, name in [(cold, "cold"), (warm, "warm"), (shift, "shift")]:
+          sol = solver(**args)
+          stats = solver.stats()
+          self.assertTrue(stats["success"])
+          self.assertEqual(stats["warm_started"], name!="cold" and step>0)
+          iter_count[name] += stats["iter_count"]
+          self.checkarray(sol["x"], sol_cold["x"], digits=5)
+          self.checkarray(sol["lam_g"], sol_cold["lam_g"], digits=4)
+        x0 = sol_cold["x"][3:5]
+      self.assertTrue(iter_count["warm"] < iter_count["cold"])
+      self.assertTrue(iter_count["shift"] < iter_count["cold"])
+      # Serialization and code generation of a solver without call history
+      warm = qpsol('warm', conic, prob, opts)
+      self.check_serialize(warm, args)
+      if conic=="qrqp": self.check_codegen(warm, args, std="c99")
+
+    with self.assertInException("warm_start_shift"):
+      qpsol('solver', 'qrqp', prob, {"warm_start_shift": [3]})
+
+  def test_qrqp_updates(self):
+    # Dense QP with many active set changes
+    n = 40
+    m = 20
+    M = DM([[numpy.sin(i+2*j+1) for j in range(n)] for i in range(n)])
+    H = mtimes(M, M.T)/n + 0.1*DM.eye(n)
+    A = DM([[numpy.cos(3*i+j+0.5) for j in range(n)] for i in range(m)])
+    g = DM([2*numpy.sin(5*j) for j in range(n)])
+    args = dict(h=H, a=A, g=g, lbx=-0.3, ubx=0.2, lba=-1, uba=1)
+    opts = {"print_iter":False, "print_header":False, "print_info":False}
+    solvers = {}
+    for max_updates in [0, 3, 10, 50]:
+      opts["max_updates"] = max_updates
+      solvers[max_updates] = conic('solver', 'qrqp', {'h': H.sparsity(), 'a': A.sparsity()}, opts)
+    sol_ref = solvers[0](**args)
+    self.assertTrue(solvers[0].stats()["success"])
+    for max_updates, solver in solvers.items():
+      sol = solver(**args)
+      self.assertTrue(solver.stats()["success"])
+      self.assertEqual(solver.stats()["iter_count"], solvers[0].stats()["iter_count"])
+      self.checkarray(sol["x"], sol_ref["x"], digits=10)
+      self.checkarray(sol["lam_x"], sol_ref["lam_x"], digits=10)
+      self.checkarray(sol["lam_a"], sol_ref["lam_a"], digits=10)
+    self.check_serialize(solvers[10], args)
+    self.check_codegen(solvers[10], args, std="c99")
+
+    with self.assertInException("max_updates"):
+      conic('solver', 'qrqp', {'h': H.sparsity(), 'a': A.sparsity()}, {"max_updates": -1})
+
   @requires_nlpsol("ipopt")
   def test_SOCP(self):
 
@@ -544,7 +544,7 @@ class Functiontests(casadiTestCase):
     Z = [MX.sym("z",2,2) for i in range(n)]
     V = [MX.sym("z",Sparsity.upper(3)) for i in range(n)]
 
-    for parallelization in ["serial","openmp","unroll","inline","thread"] if args.run_slow else ["serial"]:
+    for parallelization in ["serial","openmp","unroll","inline","thread","simd"] if args.run_slow else ["serial"]:
         print(parallelization)
         res = fun.map(n, parallelization).call([horzcat(*x) for x in [X,Y,Z,V]])
 
@@ -583,7 +583,7 @@ class Functiontests(casadiTestCase):
     Z = [MX.sym("z",2,2) for i in range(n)]
     V = [MX.sym("z",Sparsity.upper(3)) for i in range(n)]
 
-    for parallelization in ["serial","openmp","unroll","inline","thread"]:
+    for parallelization in ["serial","openmp","unroll","inline","thread","simd"]:
         print(parallelization)
         res = fun.map(n, parallelization).call([horzcat(*x) for x in [X,Y,Z,V]])
 
@@ -628,6 +628,11 @@ class Functiontests(casadiTestCase):
     self.checkfunction_light(fun.map(3,"thread",2),fun.map(3),inputs=[hcat(X_[:3]),hcat(Y_[:3]),hcat(Z_[:3]),hcat(V_[:3])])
     self.checkfunction_light(fun.map(4,"thread",2),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
     self.checkfunction_light(fun.map(4,"thread",5),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
+    self.checkfunction_light(fun.map(10,"thread",3),fun.map(10),inputs=[hcat(X_),hcat(Y_),hcat(Z_),hcat(V_)])
+
+    F = fun.map(10,"thread",3)
+    self.assertEqual(F.class_name(),"ThreadMap")
+    self.checkfunction_light(Function.deserialize(F.serialize()),fun.map(10),inputs=[hcat(X_),hcat(Y_),hcat(Z_),hcat(V_)])
 
   @memory_heavy()
   def test_mapsum(self):
@@ -1780,6 +1785,24 @@ class Functiontests(casadiTestCase):
     code= c.dump()
 
     self.assertTrue("ffff_acc4_acc4_acc4" in code)
+
+  def test_ad_num_threads(self):
+    x = SX.sym("x",10)
+    e = sin(mtimes(DM.rand(10,10),x))*x[0]
+    for nt in [1,3]:
+      opts = {"max_num_dir":2,"ad_num_threads":nt,"never_inline":True}
+      f = Function("f",[x],[e],opts)
+      y = MX.sym("y",10)
+      g = Function("g",[y],[f(y)],{"ad_num_threads":nt})
+      J = Function("J",[y],[jacobian(g(y),y)])
+      H = Function("H",[y],[jacobian(dot(y,g(y)),y).T])
+      x0 = DM([0.1*i-0.3 for i in range(10)])
+      if nt==1:
+        J_ref, H_ref = J, H
+      else:
+        self.checkfunction_light(J,J_ref,inputs=[x0])
+        self.checkfunction_light(H,H_ref,inputs=[x0])
+        self.assertTrue(any(fi.name().startswith("threadmap") for fi in J.find_functions()))
     
     
   def test_codegen_with_jac_sparsity(self):
@@ -2779,6 +2802,62 @@ class Functiontests(casadiTestCase):
         g = Function.load('f.casadi')
 
 
+  def test_jit_cache(self):
+    if not args.run_slow: return
+    if sys.platform=="darwin": return
+    import tempfile
+    d = tempfile.mkdtemp()
+    opts = {"jit":True, "compiler": "shell", "jit_cache": d}
+    x = MX.sym("x")
+    f = Function('f',[x],[(x-3)**2],opts)
+    stats = Function.jit_cache_stats(d)
+    self.assertEqual(stats["n_entries"],1)
+    n_miss = stats["n_miss"]
+    n_hit = stats["n_hit"]
+
+    # Identical source: loaded from the cache
+    g = Function('f',[x],[(x-3)**2],opts)
+    self.checkfunction_light(f, g, inputs=[1.5])
+    stats = Function.jit_cache_stats(d)
+    self.assertEqual(stats["n_miss"],n_miss)
+    self.assertEqual(stats["n_hit"],n_hit+1)
+
+    # Different source: compiled
+    h = Function('f',[x],[(x-4)**2],opts)
+    stats = Function.jit_cache_stats(d)
+    self.assertEqual(stats["n_entries"],2)
+    self.assertEqual(stats["n_miss"],n_miss+1)
+
+    # Size bound: least recently used entries are evicted
+    opts["jit_cache_size"] = 1
+    h = Function('f',[x],[(x-5)**2],opts)
+    self.checkarray(h(1),16)
+    stats = Function.jit_cache_stats(d)
+    self.assertEqual(stats["n_entries"],1)
+
+  def test_jit_split(self):
+    if not args.run_slow: return
+    if sys.platform=="darwin": return
+    import tempfile
+    x = MX.sym("x",2)
+    y = SX.sym("y",2)
+    e = x
+    for k in range(4):
+      g = Function('g%d' % k,[y],[sin(y)*(k+1)+y[0]*y[1]])
+      e = g(e)+x
+    f = Function('f',[x],[e,jacobian(e,x)])
+    for split in [2,8]:
+      fj = Function('f',[x],[e,jacobian(e,x)],{"jit":True,"compiler":"shell","jit_split":split})
+      self.checkfunction_light(f, fj, inputs=[vertcat(0.3,0.7)])
+
+    # Split code is generated into several files
+    d = tempfile.mkdtemp() + os.sep
+    cg = CodeGenerator('fsplit',{"split":3})
+    cg.add(f)
+    cg.generate(d)
+    self.assertTrue(os.path.exists(d + "fsplit_1.c"))
+    self.assertTrue(os.path.exists(d + "fsplit_shared.h"))
+
   def test_map_get_function(self):
     x = MX.sym("x")
 
@@ -2852,6 +2931,22 @@ class Functiontests(casadiTestCase):
         self.assertTrue(f1.n_instructions()>3)
         self.assertTrue(f2.n_instructions()<=3)
 
+  def test_fuse_elementwise(self):
+    x = MX.sym("x",5)
+    y = MX.sym("y",5)
+    a = MX.sym("a")
+    b = MX.sym("b")
+    t = exp(a*x+b)
+    out = [t*y+sin(t)-x/(1+y**2), if_else_zero(x>0.5,sqrt(fabs(x)))*b, sin(x), t]
+    f1 = Function('f',[x,y,a,b],out)
+    f2 = Function('f',[x,y,a,b],out,{"fuse_elementwise":True})
+    self.assertTrue(f2.n_instructions()<f1.n_instructions())
+    inputs = [DM.rand(5),DM.rand(5),0.3,0.7]
+    self.checkfunction(f2,f1,inputs=inputs)
+    self.check_codegen(f2,inputs=inputs)
+    self.check_serialize(f2,inputs=inputs)
+    self.checkfunction(f2.expand(),f1,inputs=inputs)
+
   def test_cse_call(self):
     x = MX.sym("x",2)
     f = Function("f",[x],[x**2],["x"],["y"],{"never_inline":True})
@@ -314,6 +314,31 @@ class ImplicitFunctiontests(casadiTestCase):
       res = solver(x0=0)["x"]
       self.checkarray(res,-1.7692923542386)
 
+  def test_jacobian_reuse(self):
+    x = SX.sym("x", 2)
+    a = SX.sym("a", 2)
+    f = Function("f", [x, a], [vertcat(x[0]+0.1*sin(x[1])+0.2*x[0]**2-a[0], x[1]+0.1*x[0]**2-a[1])])
+    for Solver in ["newton", "fast_newton"]:
+      ref = rootfinder("ref", Solver, f)
+      chord = rootfinder("chord", Solver, f, {"max_reuse": 5})
+      warm = rootfinder("warm", Solver, f, {"max_reuse": 5, "reuse_across_calls": True})
+      for k in range(3):
+        inputs = [0, vertcat(1+0.01*k, 0.5)]
+        x_ref = ref(*inputs)
+        n_jac = ref.stats()["n_jac"]
+        self.assertEqual(ref.stats()["n_fact"], ref.stats()["iter_count"] - (Solver=="newton"))
+        for solver in [chord, warm]:
+          self.checkarray(solver(*inputs), x_ref, digits=10)
+          self.assertTrue(solver.stats()["success"])
+          self.assertTrue(solver.stats()["n_jac"] < n_jac)
+          self.assertTrue(solver.stats()["n_fact"] <= solver.stats()["n_jac"])
+        if k>0: self.assertTrue(warm.stats()["n_jac"] < chord.stats()["n_jac"])
+      self.check_serialize(chord, inputs=inputs)
+      if Solver=="fast_newton": self.check_codegen(chord, inputs=inputs)
+
+    with self.assertInException("max_reuse"):
+      rootfinder("solver", "newton", f, {"reuse_across_calls": True})
+
   def test_segfault_codegen(self):
     # Symbols
     x = MX.sym("x")
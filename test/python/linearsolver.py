@@ -84,12 +84,15 @@ except:
 try:
   load_linsol("qr")
   lsolvers.append(("qr",{},set()))
+  lsolvers.append(("qr",{"num_threads":2},set()))
 except:
   pass
 
 try:
   load_linsol("ldl")
   lsolvers.append(("ldl",{},{"posdef","symmetry"}))
+  lsolvers.append(("ldl",{"supernodal":True},{"posdef","symmetry"}))
+  lsolvers.append(("ldl",{"num_threads":2},{"posdef","symmetry"}))
 except:
   pass
 
@@ -639,7 +642,61 @@ class LinearSolverTests(casadiTestCase):
       
         self.assertTrue(S1==S2)
         self.assertTrue(C.is_subset(S1))
-    
+
+  def test_ldl_supernodal(self):
+    np.random.seed(0)
+    # KKT system with a dense Hessian block
+    n = 30
+    m = 12
+    H = DM.rand(n,n)
+    H = mtimes(H,H.T)+n*DM.eye(n)
+    J = self.randDM(m,n,sparsity=0.2)
+    K = blockcat([[H,J.T],[J,-DM.eye(m)]])
+    b = DM.rand(n+m,3)
+    ref = Linsol("ref","ldl",K.sparsity())
+    sol = Linsol("sol","ldl",K.sparsity(),{"supernodal":True})
+    self.checkarray(sol.solve(K,b),ref.solve(K,b),digits=10)
+    self.checkarray(sol.solve(K,b),solve(K,b),digits=10)
+    self.assertEqual(sol.neig(K),m)
+
+  def test_etree_parallel(self):
+    np.random.seed(0)
+    # Sparse KKT system of a discretized chain, large enough to be split
+    N = 40
+    nx = 6
+    Q = DM.rand(nx,nx)
+    Q = mtimes(Q,Q.T)+nx*DM.eye(nx)
+    A = DM.rand(nx,nx)
+    H = diagcat(*[Q]*N)
+    J = DM.eye(nx*N)-vertcat(DM(nx,nx*N),horzcat(diagcat(*[A]*(N-1)),DM(nx*(N-1),nx)))
+    K = blockcat([[H,J.T],[J,DM(nx*N,nx*N)]])
+    b = DM.rand(K.size1(),2)
+    for Solver in ["ldl","qr"]:
+      ref = Linsol("ref",Solver,K.sparsity())
+      for num_threads in [2,4]:
+        sol = Linsol("sol",Solver,K.sparsity(),{"num_threads":num_threads})
+        self.checkarray(sol.solve(K,b),ref.solve(K,b),digits=10)
+        self.checkarray(mtimes(K,sol.solve(K,b)),b,digits=10)
+
+  def test_multiple_rhs(self):
+    np.random.seed(0)
+    A = self.randDM(20,20,sparsity=0.2)+5*DM.eye(20)
+    A = A+A.T
+    for nrhs in [1,2,4,7,9]:
+      B = DM.rand(20,nrhs)
+      for Solver in ["ldl","qr"]:
+        sol = Linsol("sol",Solver,A.sparsity())
+        X = sol.solve(A,B)
+        for i in range(nrhs):
+          self.checkarray(X[:,i],sol.solve(A,B[:,i]),digits=12)
+        self.checkarray(mtimes(A,X),B,digits=10)
+        # Transposed, multiple right-hand sides in one call
+        Am = MX.sym("A",A.sparsity())
+        Bm = MX.sym("B",B.sparsity())
+        f = Function("f",[Am,Bm],[sol.solve(Am,Bm,True)])
+        self.checkarray(mtimes(A.T,f(A,B)),B,digits=10)
+        self.check_codegen(f,inputs=[A,B])
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -99,6 +99,37 @@ class SerializeTests(casadiTestCase):
         
         print(e,r)
         check_equal(e,r)
-      
+
+  def test_binary(self):
+    x = SX.sym("x",3)
+    y = MX.sym("y",2,2)
+    A = DM(Sparsity.lower(3),range(6))
+    f = Function("f",[x],[mtimes(A,sin(x))*x[0]+3.7,x.nz[[2,0]]])
+    g = Function("g",[y],[f(y[:,0]+y[1,1])[0]*2,y.T])
+    for debug in [False,True]:
+      for h in [f,g]:
+        h.save("binary.casadi",{"binary":True,"debug":debug})
+        r = Function.load("binary.casadi")
+        x0 = DM(h.sparsity_in(0),numpy.linspace(1,2,h.nnz_in(0)))
+        for a,b in zip(h.call([x0]),r.call([x0])):
+          self.checkarray(a,b,digits=15)
+        self.assertEqual(r.sparsity_out(0),h.sparsity_out(0))
+
+        # Other objects
+        fs = FileSerializer("binary.casadi",{"binary":True,"debug":debug})
+        fs.pack([A,A])
+        fs.pack("foo")
+        fs = None
+        ds = FileDeserializer("binary.casadi")
+        B = ds.unpack()
+        self.checkarray(B[1],A)
+        self.assertEqual(B[0].sparsity(),A.sparsity())
+        self.assertEqual(ds.unpack(),"foo")
+
+    # Binary files are smaller
+    f.save("text.casadi")
+    f.save("binary.casadi",{"binary":True})
+    self.assertTrue(os.path.getsize("binary.casadi")<os.path.getsize("text.casadi"))
+
 if __name__ == '__main__':
     unittest.main()
@@ -567,6 +567,54 @@ class Sparsitytests(casadiTestCase):
         self.assertTrue(L.is_subset(R))
         self.assertFalse(R.is_subset(L))
 
+  def test_coloring_ordering(self):
+      numpy.random.seed(1)
+      n = 60
+      A = DM(numpy.random.rand(n+5,n)>0.93).sparsity()
+      S = mtimes(DM(A.T(),1),DM(A,1)).sparsity()
+
+      def colors(D):
+        c = [None]*D.size1()
+        for k,j in zip(*D.get_triplet()):
+          c[k] = j
+        self.assertTrue(None not in c)
+        return c
+
+      for ordering in range(4):
+        for num_threads in [1, 2, 4]:
+          # Columns of the same color share no row
+          c = colors(A.uni_coloring(A.T(), n, ordering, num_threads))
+          r, k = A.get_triplet()
+          for i in range(A.size1()):
+            cols = [c[k[e]] for e in range(len(r)) if r[e]==i]
+            self.assertEqual(len(cols), len(set(cols)))
+
+          # Distance-1 coloring without paths on four vertices with two colors
+          c = colors(S.star_coloring(ordering, n, num_threads))
+          nb = [[i for i in S.row(S.colind()[j],S.colind()[j+1]) if i!=j] for j in range(n)]
+          for v in range(n):
+            for w in nb[v]:
+              self.assertNotEqual(c[v], c[w])
+              a = any(c[u]==c[w] for u in nb[v] if u!=w)
+              d = any(c[u]==c[v] for u in nb[w] if u!=v)
+              self.assertFalse(a and d)
+
+      # Natural ordering reproduces the original routines
+      self.assertTrue(S.star_coloring(0, n, 1)==S.star_coloring(0))
+      self.assertTrue(A.uni_coloring(A.T(), n, 0, 1)==A.uni_coloring(A.T()))
+
+      # Same Jacobians with the coloring options
+      x = SX.sym("x",n)
+      y = mtimes(DM(A,1),sin(x))
+      x0 = numpy.random.rand(n)
+      for e in [y, gradient(dot(y,y),x)]:
+        ref = Function("F",[x],[e]).jacobian()(x0, 0)
+        for opts in [{"coloring_ordering": "smallest_last"},
+                     {"coloring_ordering": "incidence_degree", "coloring_num_threads": 2}]:
+          self.checkarray(Function("F",[x],[e],opts).jacobian()(x0, 0), ref)
+      with self.assertInException("Unknown coloring ordering"):
+        Function("F",[x],[y],{"coloring_ordering": "random"})
+
 
 
 if __name__ == '__main__':
@@ -1539,6 +1539,71 @@ class SXtests(casadiTestCase):
 
     self.checkarray(logsumexp(vertcat(100,1000,10000)),f(vertcat(100,1000,10000)))
 
+  def test_fuse_instructions(self):
+    x = SX.sym("x",3)
+    p = SX.sym("p",2)
+    e = x
+    for i in range(3):
+      e = 2-(e*p[0]+x)
+      e = e/3+x*p[1]-e
+    f_ref = Function("f",[x,p],[e,e[0]*e[1],p[0]/x[2]],{"fuse_instructions":False})
+    f = Function("f",[x,p],[e,e[0]*e[1],p[0]/x[2]])
+    self.checkfunction_light(f,f_ref,inputs=[vertcat(1.1,1.3,1.7),vertcat(0.3,0.7)])
+    self.checkfunction_light(f,f_ref,inputs=[vertcat(1.1,1.3,1.7),DM()])
+    self.checkfunction_light(Function.deserialize(f.serialize()),f_ref,inputs=[vertcat(1.1,1.3,1.7),vertcat(0.3,0.7)])
+
+  def test_just_in_time_native(self):
+    x = SX.sym("x",20)
+    p = SX.sym("p",2)
+    e = x
+    for i in range(3):
+      e = 2-(e*p[0]+x)
+      e = e/3+x*p[1]-e
+      e = fabs(e)+sqrt(fabs(x))+(e<x)+(e<=p[0])+(e==x)+(e!=x)+if_else(e<0.5,x,-e)
+      e = sin(e)+1/(1+sq(e))+fmin(e,x)
+      e = e+sum1(e*e[::-1])
+    outputs = [e,e[0]*e[1],p[0]/x[2]]
+    f_ref = Function("f",[x,p],outputs,{"fuse_instructions":False})
+    f = Function("f",[x,p],outputs,{"just_in_time_native":True})
+    x0 = DM([0.1*i-0.7 for i in range(20)])
+    self.checkfunction_light(f,f_ref,inputs=[x0,vertcat(0.3,0.7)])
+    self.checkfunction_light(f,f_ref,inputs=[x0,DM()])
+    self.checkfunction_light(Function.deserialize(f.serialize()),f_ref,inputs=[x0,vertcat(0.3,0.7)])
+
+  def test_instruction_order(self):
+    x = SX.sym("x",20)
+    e = x[0]
+    for k in range(5):
+      t = 0
+      for i in range(20):
+        t = sin(x[i]*(k+1))*cos(x[(i+k)%20])+t
+      e = e*t+x[k]*sin(e)
+    f_ref = Function("f",[x],[e,e*e])
+    f = Function("f",[x],[e,e*e],{"instruction_order":"working_set"})
+    self.assertTrue(f.sz_w()<f_ref.sz_w())
+    x0 = DM([0.1*i-0.7 for i in range(20)])
+    self.checkfunction_light(f,f_ref,inputs=[x0])
+    self.checkfunction_light(Function.deserialize(f.serialize()),f_ref,inputs=[x0])
+    with self.assertInException("Unknown instruction order"):
+      Function("f",[x],[e],{"instruction_order":"foo"})
+
+  def test_node_arena(self):
+    self.assertFalse(NodeArena.is_active())
+    a = NodeArena()
+    self.assertTrue(NodeArena.is_active())
+    x = SX.sym("x",3)
+    y = MX.sym("y",3)
+    f = Function("f",[x],[sin(x)*x[0]])
+    g = Function("g",[y],[2*f(y)+y])
+    stats = a.stats()
+    self.assertTrue(stats["n_node"]>0)
+    self.assertTrue(stats["bytes"]<=stats["bytes_reserved"])
+    # Nodes outlive the scope
+    del a
+    self.assertFalse(NodeArena.is_active())
+    self.checkarray(g(DM([1,2,3])),2*sin(DM([1,2,3]))+DM([1,2,3]))
+    del x, y, f, g
+
 
 if __name__ == '__main__':
     unittest.main()